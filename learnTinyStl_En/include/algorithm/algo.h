@@ -16,6 +16,20 @@
 #include "heap_algo.h"
 #include "functional.h"
 
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// TINYSTL_PREFETCH(addr): ask the cpu to start loading the cache line of addr,
+// it is only a hint, it never faults and does nothing where the compiler has no intrinsic
+#if defined(__GNUC__) || defined(__clang__)
+#define TINYSTL_PREFETCH(addr) __builtin_prefetch(static_cast<const void*>(addr))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define TINYSTL_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#define TINYSTL_PREFETCH(addr) ((void)0)
+#endif
+
 namespace tinystl
 {
 
@@ -108,12 +122,36 @@ namespace tinystl
     // Find the first element equal to value in [first, last), 
     // and return an iterator pointing to the element
     template <class InputIter, class T>
-    InputIter find(InputIter first, InputIter last, const T& value)
+    InputIter find_dispatch(InputIter first, InputIter last, const T& value, m_false_type)
     {
         while (first != last && *first != value)
             ++first;
         return first;
     }
+    // segmented iterator: search each buffer as a pointer range
+    template <class SegIter, class T>
+    SegIter find_dispatch(SegIter first, SegIter last, const T& value, m_true_type)
+    {
+        typedef segmented_iterator_traits<SegIter> traits;
+        auto sfirst = traits::segment(first);
+        const auto slast = traits::segment(last);
+        auto lfirst = traits::local(first);
+        for (; sfirst != slast; ++sfirst, lfirst = traits::begin(sfirst))
+        {
+            const auto lend = traits::end(sfirst);
+            const auto pos = find_dispatch(lfirst, lend, value, m_false_type());
+            if (pos != lend)
+                return traits::compose(sfirst, pos);
+        }
+        const auto pos = find_dispatch(lfirst, traits::local(last), value, m_false_type());
+        return pos == traits::local(last) ? last : traits::compose(slast, pos);
+    }
+
+    template <class InputIter, class T>
+    InputIter find(InputIter first, InputIter last, const T& value)
+    {
+        return find_dispatch(first, last, value, is_segmented_iterator<InputIter>());
+    }
 
     //-------------------------------------------------------------------------------------
     // find_if (unary functor version)
@@ -461,7 +499,7 @@ namespace tinystl
     // on each element in the [first, last) range, 
     // but the element content cannot be changed
     template <class InputIter, class Function>
-    Function for_each(InputIter first, InputIter last, Function f)
+    Function for_each_dispatch(InputIter first, InputIter last, Function f, m_false_type)
     {
         for (; first != last; ++first)
         {
@@ -469,6 +507,30 @@ namespace tinystl
         }
         return f;
     }
+    // segmented iterator: one pointer loop per buffer
+    // (f is used in place, a lambda can not be assigned back)
+    template <class SegIter, class Function>
+    Function for_each_dispatch(SegIter first, SegIter last, Function f, m_true_type)
+    {
+        typedef segmented_iterator_traits<SegIter> traits;
+        auto sfirst = traits::segment(first);
+        const auto slast = traits::segment(last);
+        auto lfirst = traits::local(first);
+        for (; sfirst != slast; ++sfirst, lfirst = traits::begin(sfirst))
+        {
+            for (auto lend = traits::end(sfirst); lfirst != lend; ++lfirst)
+                f(*lfirst);
+        }
+        for (auto lend = traits::local(last); lfirst != lend; ++lfirst)
+            f(*lfirst);
+        return f;
+    }
+
+    template <class InputIter, class Function>
+    Function for_each(InputIter first, InputIter last, Function f)
+    {
+        return for_each_dispatch(first, last, f, is_segmented_iterator<InputIter>());
+    }
 
     //-------------------------------------------------------------------------------------
     // adjacent_find
@@ -547,28 +609,51 @@ namespace tinystl
         return first;
     }
 
+    // lbound_prefetch: prefetch *it, only when it is an object in memory (an lvalue);
+    // an iterator that returns a value or a proxy (dynamic_bitset's bits) is not prefetched
+    template <class RandomIter>
+    void lbound_prefetch(RandomIter it, std::true_type)
+    {
+        TINYSTL_PREFETCH(tinystl::address_of(*it));
+    }
+
+    template <class RandomIter>
+    void lbound_prefetch(RandomIter, std::false_type)
+    {
+    }
+
+    template <class RandomIter>
+    void lbound_prefetch(RandomIter it)
+    {
+        tinystl::lbound_prefetch(it, typename std::is_lvalue_reference<decltype(*it)>::type());
+    }
+
     // lbound_dispatch's random_access_iterator_tag version
     // no need to use advance() function
+    // Branchless: the classic loop above takes a branch on every comparison,
+    // and on random keys the cpu guesses it wrong half of the time.
+    // Here the range [first, first + len) always keeps the answer (or its last element),
+    // each step only decides whether first moves up by half, which compiles to a
+    // conditional move, and the loop always runs log2(len) times.
+    // The two possible middles of the next step are prefetched, so on a large array
+    // the next cache miss overlaps with the current one.
     template <class RandomIter, class T>
     RandomIter lbound_dispatch(RandomIter first, RandomIter last,
         const T& value, random_access_iterator_tag)
     {
         auto len = last - first;
-        auto half = len;
-        RandomIter middle;
-        while (len > 0)
+        if (len == 0)
+            return first;
+        while (len > 1)
         {
-            half = len >> 1;
-            middle = first + half;
-            if (*middle < value)
-            {
-                first = middle + 1;
-                len = len - half - 1;
-            }
-            else
-                len = half;
+            const auto half = len >> 1;
+            const auto next = (len - half) >> 1;
+            tinystl::lbound_prefetch(first + next);
+            tinystl::lbound_prefetch(first + (half + next));
+            first += (first[half] < value) ? half : 0;
+            len -= half;
         }
-        return first;
+        return (*first < value) ? first + 1 : first;
     }
 
     template <class ForwardIter, class T>
@@ -604,26 +689,24 @@ namespace tinystl
     }
 
     // lbound_dispatch's random_access_iterator_tag version
+    // branchless with prefetch, like the version without comp
     template <class RandomIter, class T, class Compared>
     RandomIter lbound_dispatch(RandomIter first, RandomIter last,
         const T& value, random_access_iterator_tag, Compared comp)
     {
         auto len = last - first;
-        auto half = len;
-        RandomIter middle;
-        while (len > 0)
+        if (len == 0)
+            return first;
+        while (len > 1)
         {
-            half = len >> 1;
-            middle = first + half;
-            if (comp(*middle, value))
-            {
-                first = middle + 1;
-                len = len - half - 1;
-            }
-            else
-                len = half;
+            const auto half = len >> 1;
+            const auto next = (len - half) >> 1;
+            tinystl::lbound_prefetch(first + next);
+            tinystl::lbound_prefetch(first + (half + next));
+            first += comp(first[half], value) ? half : 0;
+            len -= half;
         }
-        return first;
+        return comp(*first, value) ? first + 1 : first;
     }
 
     template <class ForwardIter, class T, class Compared>
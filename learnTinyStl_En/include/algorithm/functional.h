@@ -102,7 +102,7 @@ namespace tinystl
     template <class T>
     struct equal_to :public binary_function<T, T, bool>
     {
-        bool operator()(const T& x, const T& y) const 
+        constexpr bool operator()(const T& x, const T& y) const 
         { 
             return x == y; 
         }
@@ -262,11 +262,11 @@ namespace tinystl
     // There are reference macro definitions,
     // The function of the backslash(\) is to tell the compiler 
     // that a line break is required here (it is used more in macro definitions and printf())
-    #define MYSTL_TRIVIAL_HASH_FCN(Type)           \
-    template <> struct hash<Type>                  \
-    {                                              \
-        size_t operator()(Type val) const noexcept \
-        { return static_cast<size_t>(val);}        \
+    #define MYSTL_TRIVIAL_HASH_FCN(Type)                     \
+    template <> struct hash<Type>                            \
+    {                                                        \
+        constexpr size_t operator()(Type val) const noexcept \
+        { return static_cast<size_t>(val);}                  \
     };
 
     MYSTL_TRIVIAL_HASH_FCN(bool)
@@ -15,7 +15,7 @@ namespace tinystl
     //------------------------------------------------------------------------------------------
     // accumulate
     template <class InputIter, class T>
-    T accumulate(InputIter first, InputIter last, T init)
+    T accumulate_dispatch(InputIter first, InputIter last, T init, m_false_type)
     {
         for (; first != last; ++first)
         {
@@ -23,9 +23,31 @@ namespace tinystl
         }
         return init;
     }
+    // segmented iterator: one pointer loop per buffer
+    template <class SegIter, class T>
+    T accumulate_dispatch(SegIter first, SegIter last, T init, m_true_type)
+    {
+        typedef segmented_iterator_traits<SegIter> traits;
+        auto sfirst = traits::segment(first);
+        const auto slast = traits::segment(last);
+        auto lfirst = traits::local(first);
+        for (; sfirst != slast; ++sfirst, lfirst = traits::begin(sfirst))
+        {
+            init = accumulate_dispatch(lfirst, traits::end(sfirst), init, m_false_type());
+        }
+        return accumulate_dispatch(lfirst, traits::local(last), init, m_false_type());
+    }
+
+    template <class InputIter, class T>
+    T accumulate(InputIter first, InputIter last, T init)
+    {
+        return accumulate_dispatch(first, last, init, is_segmented_iterator<InputIter>());
+    }
+
     // overload version
     template <class InputIter, class T, class BinaryOp>
-    T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
+    T accumulate_dispatch(InputIter first, InputIter last, T init, BinaryOp& binary_op,
+        m_false_type)
     {
         for (; first != last; ++first)
         {
@@ -33,6 +55,29 @@ namespace tinystl
         }
         return init;
     }
+    template <class SegIter, class T, class BinaryOp>
+    T accumulate_dispatch(SegIter first, SegIter last, T init, BinaryOp& binary_op,
+        m_true_type)
+    {
+        typedef segmented_iterator_traits<SegIter> traits;
+        auto sfirst = traits::segment(first);
+        const auto slast = traits::segment(last);
+        auto lfirst = traits::local(first);
+        for (; sfirst != slast; ++sfirst, lfirst = traits::begin(sfirst))
+        {
+            init = accumulate_dispatch(lfirst, traits::end(sfirst), init, binary_op,
+                m_false_type());
+        }
+        return accumulate_dispatch(lfirst, traits::local(last), init, binary_op,
+            m_false_type());
+    }
+
+    template <class InputIter, class T, class BinaryOp>
+    T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
+    {
+        return accumulate_dispatch(first, last, init, binary_op,
+            is_segmented_iterator<InputIter>());
+    }
 
     //------------------------------------------------------------------------------------------
     // adjacent_difference
@@ -7,6 +7,8 @@
 // symmetric_difference: (S1-S2)∪(S2-S1)
 
 // All sequences are sorted from smallest to largest
+// For two tinystl::set / tinystl::map, set::union_with / intersect_with / difference_with
+// work on the trees and move the nodes instead of inserting one element at a time.
 
 #include "algobase.h"
 #include "iterator.h"
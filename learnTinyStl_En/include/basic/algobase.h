@@ -113,13 +113,90 @@ namespace tinystl
         return result + n;
     }
 
+    // segmented output (deque): copy one buffer of result at a time
+    // input_iterator_tag: the length is unknown, copy element by element
+    template <class InputIter, class OutputIter>
+    OutputIter copy_to_segments(InputIter first, InputIter last, OutputIter result,
+        tinystl::input_iterator_tag)
+    {
+        return unchecked_copy(first, last, result);
+    }
+    // random_access_iterator_tag
+    template <class RandomIter, class OutputIter>
+    OutputIter copy_to_segments(RandomIter first, RandomIter last, OutputIter result,
+        tinystl::random_access_iterator_tag)
+    {
+        typedef segmented_iterator_traits<OutputIter> traits;
+        if (first == last)
+            return result;
+        auto seg = traits::segment(result);
+        auto out = traits::local(result);
+        while (true)
+        {
+            const auto room = traits::end(seg) - out;
+            if (last - first <= room)
+            {
+                out = unchecked_copy(first, last, out);
+                return traits::compose(seg, out);
+            }
+            unchecked_copy(first, first + room, out);
+            first += room;
+            ++seg;
+            out = traits::begin(seg);
+        }
+    }
+
+    template <class InputIter, class OutputIter>
+    OutputIter copy_out_dispatch(InputIter first, InputIter last, OutputIter result,
+        m_false_type)
+    {
+        return unchecked_copy(first, last, result);
+    }
+    template <class InputIter, class OutputIter>
+    OutputIter copy_out_dispatch(InputIter first, InputIter last, OutputIter result,
+        m_true_type)
+    {
+        return copy_to_segments(first, last, result, iterator_category(first));
+    }
+
+    // segmented input (deque): every buffer is a pointer range,
+    // so the memmove version of unchecked_copy can be used on it
+    template <class InputIter, class OutputIter>
+    OutputIter copy_dispatch(InputIter first, InputIter last, OutputIter result,
+        m_false_type)
+    {
+        return copy_out_dispatch(first, last, result, is_segmented_iterator<OutputIter>());
+    }
+    template <class SegIter, class OutputIter>
+    OutputIter copy_dispatch(SegIter first, SegIter last, OutputIter result,
+        m_true_type)
+    {
+        typedef segmented_iterator_traits<SegIter> traits;
+        typedef is_segmented_iterator<OutputIter>  out_segmented;
+        auto sfirst = traits::segment(first);
+        const auto slast = traits::segment(last);
+        if (sfirst == slast)
+            return copy_out_dispatch(traits::local(first), traits::local(last), result,
+                out_segmented());
+        result = copy_out_dispatch(traits::local(first), traits::end(sfirst), result,
+            out_segmented());
+        for (++sfirst; sfirst != slast; ++sfirst)
+        {
+            result = copy_out_dispatch(traits::begin(sfirst), traits::end(sfirst), result,
+                out_segmented());
+        }
+        return copy_out_dispatch(traits::begin(slast), traits::local(last), result,
+            out_segmented());
+    }
+
     template <class InputIter, class OutputIter>
     OutputIter copy(InputIter first, InputIter last, OutputIter result)
     {
         // copy(): fistly, it will call tricially_copy_assignable version,
         //         determine to use unchecked_copy() or not;
         //         secondly, call unchecked_copy_cat() to extract the type of the iterator;
-        return unchecked_copy(first, last, result);
+        // segmented iterators are split into pointer ranges first
+        return copy_dispatch(first, last, result, is_segmented_iterator<InputIter>());
     }
 
     //-------------------------------------------------------------------------------------
@@ -420,10 +497,35 @@ namespace tinystl
     }
 
     template <class ForwardIter, class T>
-    void fill(ForwardIter first, ForwardIter last, const T& value)
+    void fill_dispatch(ForwardIter first, ForwardIter last, const T& value, m_false_type)
     {
         fill_cat(first, last, value, iterator_category(first));
     }
+    // segmented iterator: fill buffer by buffer, one byte types go to memset
+    template <class SegIter, class T>
+    void fill_dispatch(SegIter first, SegIter last, const T& value, m_true_type)
+    {
+        typedef segmented_iterator_traits<SegIter> traits;
+        auto sfirst = traits::segment(first);
+        const auto slast = traits::segment(last);
+        if (sfirst == slast)
+        {
+            tinystl::fill_n(traits::local(first), traits::local(last) - traits::local(first), value);
+            return;
+        }
+        tinystl::fill_n(traits::local(first), traits::end(sfirst) - traits::local(first), value);
+        for (++sfirst; sfirst != slast; ++sfirst)
+        {
+            tinystl::fill_n(traits::begin(sfirst), traits::end(sfirst) - traits::begin(sfirst), value);
+        }
+        tinystl::fill_n(traits::begin(slast), traits::local(last) - traits::begin(slast), value);
+    }
+
+    template <class ForwardIter, class T>
+    void fill(ForwardIter first, ForwardIter last, const T& value)
+    {
+        fill_dispatch(first, last, value, is_segmented_iterator<ForwardIter>());
+    }
 
     //-------------------------------------------------------------------------------------
     // lexicographical_compare
@@ -251,6 +251,28 @@ namespace tinystl
       advance_dispatch(i, n, iterator_category(i));
     }
 
+    //---------------------------------------------------------------------------------------//
+    // segmented iterator
+    // An iterator that walks a sequence of contiguous buffers (like deque_iterator).
+    // Algorithms split [first, last) by buffer and run the raw pointer version on each one,
+    // so the "end of buffer" check in every ++ goes away.
+    // A container specializes segmented_iterator_traits and provides:
+    //   segment_iterator: walks the buffers
+    //   local_iterator:   a pointer into one buffer
+    //   segment(it) / local(it): split an iterator
+    //   begin(seg) / end(seg):   the range of a buffer
+    //   compose(seg, local):     build the iterator back
+    template <class Iterator>
+    struct segmented_iterator_traits
+    {
+        typedef m_false_type is_segmented_iterator;
+    };
+
+    template <class Iterator>
+    struct is_segmented_iterator
+        : public segmented_iterator_traits<Iterator>::is_segmented_iterator
+    {};
+
     //---------------------------------------------------------------------------------------//
     // reverse_iterator
     // making forward as backward and backward as forward
@@ -3,18 +3,24 @@
 
 // This header file is responsible for more advanced dynamic memory management
 // Contains some basic functions, space configurator, 
-// uninitialized storage space management, and a template class auto_ptr
+// uninitialized storage space management, a template class auto_ptr,
+// and the smart pointers unique_ptr / shared_ptr / weak_ptr / intrusive_ptr
 
 // Including these three files ensures that names declared 
 // with external linkage in the C standard library headers are declared in the std namespace.
 #include <cstddef>
 #include <cstdlib>
 #include <climits>
+// std::atomic: reference count shared by several threads
+#include <atomic>
+// std::allocator_traits: rebind the allocator to the control block of allocate_shared
+#include <memory>
 
 #include "algobase.h"
 #include "allocator.h"
 #include "construct.h"
 #include "uninitialized.h"
+#include "exceptdef.h"
 
 namespace tinystl
 {
@@ -244,6 +250,1160 @@ namespace tinystl
         }
     };
 
+    // --------------------------------------------------------------------------------------
+    // default_delete
+    // The default deleter of unique_ptr / shared_ptr, release the object by delete
+    template <class T>
+    struct default_delete
+    {
+        constexpr default_delete() noexcept = default;
+
+        // default_delete<Derived> can be converted to default_delete<Base>
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        default_delete(const default_delete<U>&) noexcept
+        {}
+
+        void operator()(T* ptr) const
+        {
+            // delete an incomplete type is undefined behavior, stop it at compile time
+            static_assert(sizeof(T) > 0, "can not delete an incomplete type");
+            delete ptr;
+        }
+    };
+
+    // release the array by delete[]
+    template <class T>
+    struct default_delete<T[]>
+    {
+        constexpr default_delete() noexcept = default;
+
+        void operator()(T* ptr) const
+        {
+            static_assert(sizeof(T) > 0, "can not delete an incomplete type");
+            delete[] ptr;
+        }
+    };
+
+    // --------------------------------------------------------------------------------------
+    // ptr_deleter_pair
+    // Store a pointer and its deleter together.
+    // Most deleters (default_delete, stateless lambdas) are empty classes,
+    // an empty member still takes at least one byte (plus padding),
+    // but an empty base class takes nothing (empty base optimization),
+    // so inherit from the deleter when it is empty: sizeof(unique_ptr<T>) == sizeof(T*)
+    template <class P, class D, bool = std::is_empty<D>::value>
+    class ptr_deleter_pair : private D
+    {
+    private:
+        P ptr_;
+
+    public:
+        ptr_deleter_pair() :D(), ptr_()
+        {}
+
+        template <class DD>
+        ptr_deleter_pair(P p, DD&& d) :D(tinystl::forward<DD>(d)), ptr_(p)
+        {}
+
+        P&       ptr()       noexcept { return ptr_; }
+        const P& ptr() const noexcept { return ptr_; }
+
+        D&       deleter()       noexcept { return *this; }
+        const D& deleter() const noexcept { return *this; }
+    };
+
+    // the deleter has state (or is a reference), store it as a member
+    template <class P, class D>
+    class ptr_deleter_pair<P, D, false>
+    {
+    private:
+        P ptr_;
+        D del_;
+
+    public:
+        ptr_deleter_pair() :ptr_(), del_()
+        {}
+
+        template <class DD>
+        ptr_deleter_pair(P p, DD&& d) :ptr_(p), del_(tinystl::forward<DD>(d))
+        {}
+
+        P&       ptr()       noexcept { return ptr_; }
+        const P& ptr() const noexcept { return ptr_; }
+
+        D&       deleter()       noexcept { return del_; }
+        const D& deleter() const noexcept { return del_; }
+    };
+
+    // --------------------------------------------------------------------------------------
+    // unique_ptr
+    // A smart pointer with exclusive object ownership, can only be moved, not copied.
+    // It replaces auto_ptr, whose "copy" silently transfers the ownership
+    template <class T, class D = default_delete<T>>
+    class unique_ptr
+    {
+    public:
+        typedef T   element_type;
+        typedef D   deleter_type;
+        typedef T*  pointer;
+
+    private:
+        ptr_deleter_pair<pointer, deleter_type> pair_;
+
+        template <class U, class E> friend class unique_ptr;
+
+    public:
+        // constructor
+        unique_ptr() noexcept :pair_()
+        {}
+
+        unique_ptr(std::nullptr_t) noexcept :pair_()
+        {}
+
+        explicit unique_ptr(pointer p) noexcept :pair_(p, deleter_type())
+        {}
+
+        template <class DD, typename std::enable_if<
+            std::is_constructible<D, DD&&>::value, int>::type = 0>
+        unique_ptr(pointer p, DD&& d) noexcept :pair_(p, tinystl::forward<DD>(d))
+        {}
+
+        // move constructor
+        unique_ptr(unique_ptr&& rhs) noexcept
+            :pair_(rhs.release(), tinystl::forward<D>(rhs.get_deleter()))
+        {}
+
+        // unique_ptr<Derived> can be moved to unique_ptr<Base>
+        template <class U, class E, typename std::enable_if<
+            std::is_convertible<U*, T*>::value &&
+            !std::is_array<U>::value &&
+            std::is_convertible<E, D>::value, int>::type = 0>
+        unique_ptr(unique_ptr<U, E>&& rhs) noexcept
+            :pair_(rhs.release(), tinystl::forward<E>(rhs.get_deleter()))
+        {}
+
+        unique_ptr(const unique_ptr&) = delete;
+        unique_ptr& operator=(const unique_ptr&) = delete;
+
+        // move assignment operator
+        unique_ptr& operator=(unique_ptr&& rhs) noexcept
+        {
+            reset(rhs.release());
+            pair_.deleter() = tinystl::forward<D>(rhs.get_deleter());
+            return *this;
+        }
+
+        template <class U, class E, typename std::enable_if<
+            std::is_convertible<U*, T*>::value &&
+            !std::is_array<U>::value &&
+            std::is_assignable<D&, E&&>::value, int>::type = 0>
+        unique_ptr& operator=(unique_ptr<U, E>&& rhs) noexcept
+        {
+            reset(rhs.release());
+            pair_.deleter() = tinystl::forward<E>(rhs.get_deleter());
+            return *this;
+        }
+
+        unique_ptr& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        ~unique_ptr()
+        { reset(); }
+
+    public:
+        T& operator*() const
+        { return *pair_.ptr(); }
+
+        pointer operator->() const noexcept
+        { return pair_.ptr(); }
+
+        pointer get() const noexcept
+        { return pair_.ptr(); }
+
+        deleter_type& get_deleter() noexcept
+        { return pair_.deleter(); }
+
+        const deleter_type& get_deleter() const noexcept
+        { return pair_.deleter(); }
+
+        explicit operator bool() const noexcept
+        { return pair_.ptr() != nullptr; }
+
+        // give up the ownership without releasing the object
+        pointer release() noexcept
+        {
+            pointer tmp = pair_.ptr();
+            pair_.ptr() = nullptr;
+            return tmp;
+        }
+
+        // replace the managed object, then release the old one
+        void reset(pointer p = pointer()) noexcept
+        {
+            pointer old = pair_.ptr();
+            pair_.ptr() = p;
+            if (old != nullptr)
+                pair_.deleter()(old);
+        }
+
+        void swap(unique_ptr& rhs) noexcept
+        {
+            tinystl::swap(pair_.ptr(), rhs.pair_.ptr());
+            tinystl::swap(pair_.deleter(), rhs.pair_.deleter());
+        }
+    };
+
+    // unique_ptr for array, use operator[] instead of operator* and operator->
+    template <class T, class D>
+    class unique_ptr<T[], D>
+    {
+    public:
+        typedef T   element_type;
+        typedef D   deleter_type;
+        typedef T*  pointer;
+
+    private:
+        ptr_deleter_pair<pointer, deleter_type> pair_;
+
+    public:
+        unique_ptr() noexcept :pair_()
+        {}
+
+        unique_ptr(std::nullptr_t) noexcept :pair_()
+        {}
+
+        explicit unique_ptr(pointer p) noexcept :pair_(p, deleter_type())
+        {}
+
+        template <class DD, typename std::enable_if<
+            std::is_constructible<D, DD&&>::value, int>::type = 0>
+        unique_ptr(pointer p, DD&& d) noexcept :pair_(p, tinystl::forward<DD>(d))
+        {}
+
+        unique_ptr(unique_ptr&& rhs) noexcept
+            :pair_(rhs.release(), tinystl::forward<D>(rhs.get_deleter()))
+        {}
+
+        unique_ptr(const unique_ptr&) = delete;
+        unique_ptr& operator=(const unique_ptr&) = delete;
+
+        unique_ptr& operator=(unique_ptr&& rhs) noexcept
+        {
+            reset(rhs.release());
+            pair_.deleter() = tinystl::forward<D>(rhs.get_deleter());
+            return *this;
+        }
+
+        unique_ptr& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        ~unique_ptr()
+        { reset(); }
+
+    public:
+        T& operator[](size_t i) const
+        { return pair_.ptr()[i]; }
+
+        pointer get() const noexcept
+        { return pair_.ptr(); }
+
+        deleter_type& get_deleter() noexcept
+        { return pair_.deleter(); }
+
+        const deleter_type& get_deleter() const noexcept
+        { return pair_.deleter(); }
+
+        explicit operator bool() const noexcept
+        { return pair_.ptr() != nullptr; }
+
+        pointer release() noexcept
+        {
+            pointer tmp = pair_.ptr();
+            pair_.ptr() = nullptr;
+            return tmp;
+        }
+
+        void reset(pointer p = pointer()) noexcept
+        {
+            pointer old = pair_.ptr();
+            pair_.ptr() = p;
+            if (old != nullptr)
+                pair_.deleter()(old);
+        }
+
+        void swap(unique_ptr& rhs) noexcept
+        {
+            tinystl::swap(pair_.ptr(), rhs.pair_.ptr());
+            tinystl::swap(pair_.deleter(), rhs.pair_.deleter());
+        }
+    };
+
+    // overload swap
+    template <class T, class D>
+    void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // overload comparison operator
+    template <class T1, class D1, class T2, class D2>
+    bool operator==(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <class T1, class D1, class T2, class D2>
+    bool operator!=(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T1, class D1, class T2, class D2>
+    bool operator<(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    template <class T, class D>
+    bool operator==(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept
+    {
+        return !lhs;
+    }
+
+    template <class T, class D>
+    bool operator!=(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept
+    {
+        return static_cast<bool>(lhs);
+    }
+
+    // make_unique
+    // construct a single object
+    template <class T, class... Args>
+    typename std::enable_if<!std::is_array<T>::value, unique_ptr<T>>::type
+    make_unique(Args&&... args)
+    {
+        return unique_ptr<T>(new T(tinystl::forward<Args>(args)...));
+    }
+
+    // construct an array of n value-initialized elements
+    template <class T>
+    typename std::enable_if<std::is_array<T>::value && std::extent<T>::value == 0,
+        unique_ptr<T>>::type
+    make_unique(size_t n)
+    {
+        typedef typename std::remove_extent<T>::type elem_type;
+        return unique_ptr<T>(new elem_type[n]());
+    }
+
+    // --------------------------------------------------------------------------------------
+    // reference count policies
+    // atomic_count_policy:  the count is a std::atomic, shared_ptr can be copied across threads,
+    //                       every copy / destruction is a locked instruction on the cache line
+    // single_thread_policy: the count is a plain long, for objects that never leave a thread
+    //                       (a shard, an event loop), which is as cheap as ++ / --
+    struct atomic_count_policy
+    {
+        typedef std::atomic<long> count_type;
+
+        // a new reference can only be made from an existing one, no ordering needed
+        static void increment(count_type& count) noexcept
+        { count.fetch_add(1, std::memory_order_relaxed); }
+
+        // the last owner must see all writes of the other owners before destroying the object
+        static long decrement(count_type& count) noexcept
+        { return count.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+        static long load(const count_type& count) noexcept
+        { return count.load(std::memory_order_relaxed); }
+
+        // the caller holds the only reference, so it may modify the object in place
+        // (acquire: the writes of the owners that already released it are visible)
+        static bool unique(const count_type& count) noexcept
+        { return count.load(std::memory_order_acquire) == 1; }
+
+        // used by weak_ptr::lock, never revive an object whose count has reached zero
+        static bool increment_if_nonzero(count_type& count) noexcept
+        {
+            long n = count.load(std::memory_order_relaxed);
+            while (n != 0)
+            {
+                if (count.compare_exchange_weak(n, n + 1,
+                    std::memory_order_acq_rel, std::memory_order_relaxed))
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    struct single_thread_policy
+    {
+        typedef long count_type;
+
+        static void increment(count_type& count) noexcept
+        { ++count; }
+
+        static long decrement(count_type& count) noexcept
+        { return --count; }
+
+        static long load(const count_type& count) noexcept
+        { return count; }
+
+        static bool unique(const count_type& count) noexcept
+        { return count == 1; }
+
+        static bool increment_if_nonzero(count_type& count) noexcept
+        {
+            if (count == 0)
+                return false;
+            ++count;
+            return true;
+        }
+    };
+
+    // --------------------------------------------------------------------------------------
+    // control blocks of shared_ptr
+    // sp_counted_base: the two counts
+    //   use_count_:  the number of shared_ptr, the object is destroyed when it reaches zero
+    //   weak_count_: the number of weak_ptr, plus one while use_count_ != 0,
+    //                the control block is freed when it reaches zero
+    template <class Policy>
+    class sp_counted_base
+    {
+    private:
+        typename Policy::count_type use_count_;
+        typename Policy::count_type weak_count_;
+
+    public:
+        sp_counted_base() noexcept :use_count_(1), weak_count_(1)
+        {}
+
+        virtual ~sp_counted_base()
+        {}
+
+        // destroy the managed object
+        virtual void dispose() noexcept = 0;
+
+        // free the control block itself
+        virtual void destroy() noexcept
+        { delete this; }
+
+        void add_ref() noexcept
+        { Policy::increment(use_count_); }
+
+        bool add_ref_lock() noexcept
+        { return Policy::increment_if_nonzero(use_count_); }
+
+        void release() noexcept
+        {
+            if (Policy::decrement(use_count_) == 0)
+            {
+                dispose();
+                weak_release();
+            }
+        }
+
+        void weak_add_ref() noexcept
+        { Policy::increment(weak_count_); }
+
+        void weak_release() noexcept
+        {
+            if (Policy::decrement(weak_count_) == 0)
+                destroy();
+        }
+
+        long use_count() const noexcept
+        { return Policy::load(use_count_); }
+
+    private:
+        sp_counted_base(const sp_counted_base&);
+        void operator=(const sp_counted_base&);
+    };
+
+    // sp_counted_ptr: the object is allocated by the user, the block keeps the pointer and deleter
+    // two allocations: one for the object, one for the control block
+    template <class P, class D, class Policy>
+    class sp_counted_ptr : public sp_counted_base<Policy>
+    {
+    private:
+        ptr_deleter_pair<P, D> pair_;
+
+    public:
+        sp_counted_ptr(P p, D d) :pair_(p, tinystl::move(d))
+        {}
+
+        void dispose() noexcept override
+        { pair_.deleter()(pair_.ptr()); }
+    };
+
+    // sp_counted_inplace: the object lives inside the control block (make_shared / allocate_shared)
+    // one allocation, and the counts and the object share the same cache lines.
+    // Same as the containers of tinystl, the allocator is treated as stateless
+    template <class T, class Alloc, class Policy>
+    class sp_counted_inplace : public sp_counted_base<Policy>
+    {
+    public:
+        typedef typename std::allocator_traits<Alloc>::template
+            rebind_alloc<sp_counted_inplace>                  block_allocator;
+        typedef std::allocator_traits<block_allocator>       block_traits;
+
+    private:
+        // uninitialized storage, the object is constructed by placement new
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+
+    public:
+        template <class... Args>
+        explicit sp_counted_inplace(Args&&... args)
+        {
+            tinystl::construct(get(), tinystl::forward<Args>(args)...);
+        }
+
+        T* get() noexcept
+        { return reinterpret_cast<T*>(&storage_); }
+
+        void dispose() noexcept override
+        { tinystl::destroy(get()); }
+
+        void destroy() noexcept override
+        {
+            block_allocator alloc;
+            this->~sp_counted_inplace();
+            block_traits::deallocate(alloc, this, 1);
+        }
+    };
+
+    template <class T, class Policy>
+    class shared_ptr;
+
+    template <class T, class Policy>
+    class weak_ptr;
+
+    // --------------------------------------------------------------------------------------
+    // shared_ptr
+    // A smart pointer with shared object ownership,
+    // the object is destroyed when the last shared_ptr owning it is destroyed or reset.
+    // Policy selects the reference count, see atomic_count_policy and single_thread_policy
+    template <class T, class Policy = atomic_count_policy>
+    class shared_ptr
+    {
+    public:
+        typedef T                     element_type;
+        typedef weak_ptr<T, Policy>   weak_type;
+
+    private:
+        typedef sp_counted_base<Policy> counted_base;
+
+        T*            ptr_;  // the pointer returned by get(), may differ from the owned one
+        counted_base* cb_;   // control block
+
+        template <class U, class P> friend class shared_ptr;
+        template <class U, class P> friend class weak_ptr;
+
+        template <class U, class P, class Alloc, class... Args>
+        friend shared_ptr<U, P> allocate_shared_with_policy(const Alloc&, Args&&...);
+
+    public:
+        // constructor
+        shared_ptr() noexcept :ptr_(nullptr), cb_(nullptr)
+        {}
+
+        shared_ptr(std::nullptr_t) noexcept :ptr_(nullptr), cb_(nullptr)
+        {}
+
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        explicit shared_ptr(U* p) :ptr_(p), cb_(nullptr)
+        {
+            try
+            {
+                cb_ = new sp_counted_ptr<U*, default_delete<U>, Policy>(p, default_delete<U>());
+            }
+            catch (...)
+            {
+                delete p;
+                throw;
+            }
+        }
+
+        template <class U, class D, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        shared_ptr(U* p, D d) :ptr_(p), cb_(nullptr)
+        {
+            try
+            {
+                cb_ = new sp_counted_ptr<U*, D, Policy>(p, d);
+            }
+            catch (...)
+            {
+                d(p);
+                throw;
+            }
+        }
+
+        // take the ownership from a unique_ptr
+        template <class U, class D, typename std::enable_if<
+            std::is_convertible<U*, T*>::value && !std::is_array<U>::value, int>::type = 0>
+        shared_ptr(unique_ptr<U, D>&& rhs) :ptr_(rhs.get()), cb_(nullptr)
+        {
+            if (ptr_ != nullptr)
+            {
+                typedef typename std::remove_reference<D>::type deleter_type;
+                cb_ = new sp_counted_ptr<U*, deleter_type, Policy>(rhs.get(), rhs.get_deleter());
+                rhs.release();
+            }
+        }
+
+        // aliasing constructor: share the ownership of rhs, but point to p (e.g. a member of it)
+        template <class U>
+        shared_ptr(const shared_ptr<U, Policy>& rhs, T* p) noexcept :ptr_(p), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->add_ref();
+        }
+
+        // copy constructor
+        shared_ptr(const shared_ptr& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->add_ref();
+        }
+
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        shared_ptr(const shared_ptr<U, Policy>& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->add_ref();
+        }
+
+        // move constructor, no need to touch the reference count
+        shared_ptr(shared_ptr&& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            rhs.ptr_ = nullptr;
+            rhs.cb_ = nullptr;
+        }
+
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        shared_ptr(shared_ptr<U, Policy>&& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            rhs.ptr_ = nullptr;
+            rhs.cb_ = nullptr;
+        }
+
+        // construct from a weak_ptr, throw if the object has been destroyed
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        explicit shared_ptr(const weak_ptr<U, Policy>& rhs) :ptr_(nullptr), cb_(nullptr)
+        {
+            THROW_RUNTIME_ERROR_IF(rhs.cb_ == nullptr || !rhs.cb_->add_ref_lock(),
+                "shared_ptr<T> constructed from an expired weak_ptr");
+            ptr_ = rhs.ptr_;
+            cb_ = rhs.cb_;
+        }
+
+        // assignment operator
+        shared_ptr& operator=(const shared_ptr& rhs) noexcept
+        {
+            shared_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        template <class U>
+        shared_ptr& operator=(const shared_ptr<U, Policy>& rhs) noexcept
+        {
+            shared_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        shared_ptr& operator=(shared_ptr&& rhs) noexcept
+        {
+            shared_ptr(tinystl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        template <class U>
+        shared_ptr& operator=(shared_ptr<U, Policy>&& rhs) noexcept
+        {
+            shared_ptr(tinystl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        template <class U, class D>
+        shared_ptr& operator=(unique_ptr<U, D>&& rhs)
+        {
+            shared_ptr(tinystl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        ~shared_ptr()
+        {
+            if (cb_ != nullptr)
+                cb_->release();
+        }
+
+    public:
+        T& operator*() const noexcept
+        { return *ptr_; }
+
+        T* operator->() const noexcept
+        { return ptr_; }
+
+        T* get() const noexcept
+        { return ptr_; }
+
+        long use_count() const noexcept
+        { return cb_ == nullptr ? 0 : cb_->use_count(); }
+
+        bool unique() const noexcept
+        { return use_count() == 1; }
+
+        explicit operator bool() const noexcept
+        { return ptr_ != nullptr; }
+
+        // order by the control block, so that aliasing pointers of one object are equivalent
+        template <class U>
+        bool owner_before(const shared_ptr<U, Policy>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+
+        template <class U>
+        bool owner_before(const weak_ptr<U, Policy>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+
+        void reset() noexcept
+        { shared_ptr().swap(*this); }
+
+        template <class U>
+        void reset(U* p)
+        { shared_ptr(p).swap(*this); }
+
+        template <class U, class D>
+        void reset(U* p, D d)
+        { shared_ptr(p, d).swap(*this); }
+
+        void swap(shared_ptr& rhs) noexcept
+        {
+            tinystl::swap(ptr_, rhs.ptr_);
+            tinystl::swap(cb_, rhs.cb_);
+        }
+
+    private:
+        // adopt a control block whose use_count_ has already been increased for us
+        struct adopt_tag {};
+
+        shared_ptr(adopt_tag, T* p, counted_base* cb) noexcept :ptr_(p), cb_(cb)
+        {}
+    };
+
+    // local_shared_ptr: non-atomic reference count, can not be shared between threads
+    template <class T>
+    using local_shared_ptr = shared_ptr<T, single_thread_policy>;
+
+    // overload swap
+    template <class T, class Policy>
+    void swap(shared_ptr<T, Policy>& lhs, shared_ptr<T, Policy>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // overload comparison operator
+    template <class T, class U, class Policy>
+    bool operator==(const shared_ptr<T, Policy>& lhs, const shared_ptr<U, Policy>& rhs) noexcept
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <class T, class U, class Policy>
+    bool operator!=(const shared_ptr<T, Policy>& lhs, const shared_ptr<U, Policy>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class U, class Policy>
+    bool operator<(const shared_ptr<T, Policy>& lhs, const shared_ptr<U, Policy>& rhs) noexcept
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    template <class T, class Policy>
+    bool operator==(const shared_ptr<T, Policy>& lhs, std::nullptr_t) noexcept
+    {
+        return !lhs;
+    }
+
+    template <class T, class Policy>
+    bool operator!=(const shared_ptr<T, Policy>& lhs, std::nullptr_t) noexcept
+    {
+        return static_cast<bool>(lhs);
+    }
+
+    // cast between shared_ptr, the result shares the ownership with the argument
+    template <class T, class U, class Policy>
+    shared_ptr<T, Policy> static_pointer_cast(const shared_ptr<U, Policy>& rhs) noexcept
+    {
+        return shared_ptr<T, Policy>(rhs, static_cast<T*>(rhs.get()));
+    }
+
+    template <class T, class U, class Policy>
+    shared_ptr<T, Policy> const_pointer_cast(const shared_ptr<U, Policy>& rhs) noexcept
+    {
+        return shared_ptr<T, Policy>(rhs, const_cast<T*>(rhs.get()));
+    }
+
+    template <class T, class U, class Policy>
+    shared_ptr<T, Policy> dynamic_pointer_cast(const shared_ptr<U, Policy>& rhs) noexcept
+    {
+        T* p = dynamic_cast<T*>(rhs.get());
+        return p != nullptr ? shared_ptr<T, Policy>(rhs, p) : shared_ptr<T, Policy>();
+    }
+
+    // --------------------------------------------------------------------------------------
+    // allocate_shared / make_shared
+    // Allocate the control block and the object in one piece of memory:
+    // one call to the allocator instead of two, and no separate pointer chase to the counts
+    template <class T, class Policy, class Alloc, class... Args>
+    shared_ptr<T, Policy> allocate_shared_with_policy(const Alloc&, Args&&... args)
+    {
+        typedef sp_counted_inplace<T, Alloc, Policy>   block_type;
+        typedef typename block_type::block_allocator  block_allocator;
+        typedef typename block_type::block_traits     block_traits;
+
+        block_allocator alloc;
+        block_type* block = block_traits::allocate(alloc, 1);
+        try
+        {
+            ::new (static_cast<void*>(block)) block_type(tinystl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            block_traits::deallocate(alloc, block, 1);
+            throw;
+        }
+        return shared_ptr<T, Policy>(typename shared_ptr<T, Policy>::adopt_tag(),
+            block->get(), block);
+    }
+
+    template <class T, class Alloc, class... Args>
+    shared_ptr<T> allocate_shared(const Alloc& alloc, Args&&... args)
+    {
+        return allocate_shared_with_policy<T, atomic_count_policy>(alloc,
+            tinystl::forward<Args>(args)...);
+    }
+
+    template <class T, class... Args>
+    shared_ptr<T> make_shared(Args&&... args)
+    {
+        return allocate_shared_with_policy<T, atomic_count_policy>(tinystl::allocator<T>(),
+            tinystl::forward<Args>(args)...);
+    }
+
+    template <class T, class... Args>
+    local_shared_ptr<T> make_local_shared(Args&&... args)
+    {
+        return allocate_shared_with_policy<T, single_thread_policy>(tinystl::allocator<T>(),
+            tinystl::forward<Args>(args)...);
+    }
+
+    // --------------------------------------------------------------------------------------
+    // weak_ptr
+    // Observe an object owned by shared_ptr without owning it,
+    // it keeps the control block alive but not the object, use lock() to get a shared_ptr
+    template <class T, class Policy = atomic_count_policy>
+    class weak_ptr
+    {
+    public:
+        typedef T element_type;
+
+    private:
+        typedef sp_counted_base<Policy> counted_base;
+
+        T*            ptr_;
+        counted_base* cb_;
+
+        template <class U, class P> friend class shared_ptr;
+        template <class U, class P> friend class weak_ptr;
+
+    public:
+        // constructor
+        weak_ptr() noexcept :ptr_(nullptr), cb_(nullptr)
+        {}
+
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        weak_ptr(const shared_ptr<U, Policy>& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->weak_add_ref();
+        }
+
+        weak_ptr(const weak_ptr& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+                cb_->weak_add_ref();
+        }
+
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        weak_ptr(const weak_ptr<U, Policy>& rhs) noexcept :ptr_(nullptr), cb_(rhs.cb_)
+        {
+            if (cb_ != nullptr)
+            {
+                cb_->weak_add_ref();
+                // rhs.ptr_ may be dangling, only convert it while the object is still alive
+                ptr_ = rhs.lock().get();
+            }
+        }
+
+        weak_ptr(weak_ptr&& rhs) noexcept :ptr_(rhs.ptr_), cb_(rhs.cb_)
+        {
+            rhs.ptr_ = nullptr;
+            rhs.cb_ = nullptr;
+        }
+
+        // assignment operator
+        weak_ptr& operator=(const weak_ptr& rhs) noexcept
+        {
+            weak_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        weak_ptr& operator=(weak_ptr&& rhs) noexcept
+        {
+            weak_ptr(tinystl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        template <class U>
+        weak_ptr& operator=(const shared_ptr<U, Policy>& rhs) noexcept
+        {
+            weak_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        ~weak_ptr()
+        {
+            if (cb_ != nullptr)
+                cb_->weak_release();
+        }
+
+    public:
+        long use_count() const noexcept
+        { return cb_ == nullptr ? 0 : cb_->use_count(); }
+
+        bool expired() const noexcept
+        { return use_count() == 0; }
+
+        // get a shared_ptr, empty if the object has been destroyed
+        shared_ptr<T, Policy> lock() const noexcept
+        {
+            if (cb_ != nullptr && cb_->add_ref_lock())
+                return shared_ptr<T, Policy>(typename shared_ptr<T, Policy>::adopt_tag(),
+                    ptr_, cb_);
+            return shared_ptr<T, Policy>();
+        }
+
+        template <class U>
+        bool owner_before(const shared_ptr<U, Policy>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+
+        template <class U>
+        bool owner_before(const weak_ptr<U, Policy>& rhs) const noexcept
+        { return cb_ < rhs.cb_; }
+
+        void reset() noexcept
+        { weak_ptr().swap(*this); }
+
+        void swap(weak_ptr& rhs) noexcept
+        {
+            tinystl::swap(ptr_, rhs.ptr_);
+            tinystl::swap(cb_, rhs.cb_);
+        }
+    };
+
+    template <class T>
+    using local_weak_ptr = weak_ptr<T, single_thread_policy>;
+
+    template <class T, class Policy>
+    void swap(weak_ptr<T, Policy>& lhs, weak_ptr<T, Policy>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // --------------------------------------------------------------------------------------
+    // intrusive_ptr
+    // The reference count lives in the object itself, so there is no control block at all:
+    // sizeof(intrusive_ptr<T>) == sizeof(T*), and a raw pointer can be turned back into an owner.
+    // T must provide (found by argument dependent lookup)
+    //   void intrusive_ptr_add_ref(T* p);
+    //   void intrusive_ptr_release(T* p);
+    // the easiest way is to derive from intrusive_ref_counter
+    template <class T>
+    class intrusive_ptr
+    {
+    public:
+        typedef T element_type;
+
+    private:
+        T* ptr_;
+
+    public:
+        // constructor
+        intrusive_ptr() noexcept :ptr_(nullptr)
+        {}
+
+        // add_ref == false: adopt a reference that has already been counted
+        intrusive_ptr(T* p, bool add_ref = true) :ptr_(p)
+        {
+            if (ptr_ != nullptr && add_ref)
+                intrusive_ptr_add_ref(ptr_);
+        }
+
+        intrusive_ptr(const intrusive_ptr& rhs) :ptr_(rhs.ptr_)
+        {
+            if (ptr_ != nullptr)
+                intrusive_ptr_add_ref(ptr_);
+        }
+
+        template <class U, typename std::enable_if<
+            std::is_convertible<U*, T*>::value, int>::type = 0>
+        intrusive_ptr(const intrusive_ptr<U>& rhs) :ptr_(rhs.get())
+        {
+            if (ptr_ != nullptr)
+                intrusive_ptr_add_ref(ptr_);
+        }
+
+        intrusive_ptr(intrusive_ptr&& rhs) noexcept :ptr_(rhs.ptr_)
+        {
+            rhs.ptr_ = nullptr;
+        }
+
+        // assignment operator
+        intrusive_ptr& operator=(const intrusive_ptr& rhs)
+        {
+            intrusive_ptr(rhs).swap(*this);
+            return *this;
+        }
+
+        intrusive_ptr& operator=(intrusive_ptr&& rhs) noexcept
+        {
+            intrusive_ptr(tinystl::move(rhs)).swap(*this);
+            return *this;
+        }
+
+        intrusive_ptr& operator=(T* p)
+        {
+            intrusive_ptr(p).swap(*this);
+            return *this;
+        }
+
+        ~intrusive_ptr()
+        {
+            if (ptr_ != nullptr)
+                intrusive_ptr_release(ptr_);
+        }
+
+    public:
+        T& operator*() const noexcept
+        { return *ptr_; }
+
+        T* operator->() const noexcept
+        { return ptr_; }
+
+        T* get() const noexcept
+        { return ptr_; }
+
+        explicit operator bool() const noexcept
+        { return ptr_ != nullptr; }
+
+        // give up the ownership without decreasing the reference count
+        T* detach() noexcept
+        {
+            T* tmp = ptr_;
+            ptr_ = nullptr;
+            return tmp;
+        }
+
+        void reset()
+        { intrusive_ptr().swap(*this); }
+
+        void reset(T* p, bool add_ref = true)
+        { intrusive_ptr(p, add_ref).swap(*this); }
+
+        void swap(intrusive_ptr& rhs) noexcept
+        {
+            tinystl::swap(ptr_, rhs.ptr_);
+        }
+    };
+
+    template <class T>
+    void swap(intrusive_ptr<T>& lhs, intrusive_ptr<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    template <class T, class U>
+    bool operator==(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <class T, class U>
+    bool operator!=(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+    {
+        return lhs.get() != rhs.get();
+    }
+
+    template <class T, class U>
+    bool operator<(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    // intrusive_ref_counter
+    // Derive from it (CRTP) to get the reference count and the two functions intrusive_ptr needs
+    // class connection : public tinystl::intrusive_ref_counter<connection> { ... };
+    template <class Derived, class Policy = atomic_count_policy>
+    class intrusive_ref_counter
+    {
+    private:
+        mutable typename Policy::count_type ref_count_;
+
+    protected:
+        intrusive_ref_counter() noexcept :ref_count_(0)
+        {}
+
+        // copying the object does not copy its owners
+        intrusive_ref_counter(const intrusive_ref_counter&) noexcept :ref_count_(0)
+        {}
+
+        intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept
+        { return *this; }
+
+        ~intrusive_ref_counter()
+        {}
+
+    public:
+        long use_count() const noexcept
+        { return Policy::load(ref_count_); }
+
+        friend void intrusive_ptr_add_ref(const intrusive_ref_counter* p) noexcept
+        {
+            Policy::increment(p->ref_count_);
+        }
+
+        friend void intrusive_ptr_release(const intrusive_ref_counter* p) noexcept
+        {
+            if (Policy::decrement(p->ref_count_) == 0)
+                delete static_cast<const Derived*>(p);
+        }
+    };
+
 } // namespace tinystl
 #endif 
 
@@ -249,5 +249,47 @@ namespace tinystl
             typename iterator_traits<InputIter>::value_type>{});
     }
 
+    //---------------------------------------------------------------------------------------
+    // Default-initialize n elements in the space starting from first,
+    // and return the position where the construction ends.
+    // Unlike uninitialized_fill_n(first, n, T()), which value-initializes (zero fills) them,
+    // a trivially default constructible type is left uninitialized: nothing is written
+    template <class ForwardIter, class Size>
+    ForwardIter unchecked_uninit_default_n(ForwardIter first, Size n, std::true_type)
+    {
+        tinystl::advance(first, n);
+        return first;
+    }
+
+    template <class ForwardIter, class Size>
+    ForwardIter unchecked_uninit_default_n(ForwardIter first, Size n, std::false_type)
+    {
+        typedef typename iterator_traits<ForwardIter>::value_type value_type;
+        auto cur = first;
+        try
+        {
+            for (; n > 0; --n, ++cur)
+            {
+                // no parentheses after the type: default-initialization
+                ::new ((void*)&*cur) value_type;
+            }
+        }
+        catch (...)
+        {
+            for (; first != cur; ++first)
+                tinystl::destroy(&*first);
+            throw;
+        }
+        return cur;
+    }
+
+    template <class ForwardIter, class Size>
+    ForwardIter uninitialized_default_construct_n(ForwardIter first, Size n)
+    {
+        return tinystl::unchecked_uninit_default_n(first, n,
+            std::is_trivially_default_constructible<
+            typename iterator_traits<ForwardIter>::value_type>{});
+    }
+
 } // namespace tinystl
 #endif
@@ -10,7 +10,7 @@ namespace tinystl
     // move: return right value
     // change the left value to the right value, and 
     template <class T>
-    typename std::remove_reference<T>::type&& move(T&& arg) noexcept
+    constexpr typename std::remove_reference<T>::type&& move(T&& arg) noexcept
     {
         // std::remove_reference: remove the referenced relationship
         // static_cast <type-id> ( expression ):
@@ -21,13 +21,13 @@ namespace tinystl
 
     // forward: change the lvalue reference to the rvalue reference
     template <class T>
-    T&& forward(typename std::remove_reference<T>::type& arg) noexcept
+    constexpr T&& forward(typename std::remove_reference<T>::type& arg) noexcept
     {
         return static_cast<T&&>(arg);
     }
     
     template <class T>
-    T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
+    constexpr T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
     {
         // static_assert
         // If the specified constant expression is false, 
@@ -287,6 +287,19 @@ namespace tinystl
         return pair<Ty1, Ty2>(tinystl::forward<Ty1>(first), tinystl::forward<Ty2>(second));
     }
 
+    //-------------- for_overwrite ---------------------//
+    // A tag to select the constructors / resize functions which default-initialize
+    // the new elements instead of value-initializing them:
+    // a trivial element (char, int, POD struct) is left uninitialized, no zero filling.
+    // Use it when the elements are overwritten at once, e.g. by a read() from a file or socket
+    //   tinystl::vector<uint8_t> buf(n, tinystl::for_overwrite);
+    struct for_overwrite_t
+    {
+        explicit for_overwrite_t() = default;
+    };
+
+    constexpr for_overwrite_t for_overwrite{};
+
 } // namespace tinystl
 
 #endif 
\ No newline at end of file
@@ -342,6 +342,10 @@ namespace tinystl
         basic_string(size_type n, value_type ch) :buffer_(nullptr), size_(0), cap_(0)
         { fill_init(n, ch); }
 
+        // n characters left uninitialized, to be overwritten by the caller
+        basic_string(size_type n, for_overwrite_t) :buffer_(nullptr), size_(0), cap_(0)
+        { resize_default_init(n); }
+
         basic_string(const basic_string& other, size_type pos)
             :buffer_(nullptr), size_(0), cap_(0)
         {
@@ -566,6 +570,15 @@ namespace tinystl
 
         void resize(size_type count, value_type ch);
 
+        // resize without filling the new characters, only the terminator is written
+        void resize_default_init(size_type count);
+
+        // resize_and_overwrite
+        // op(pointer buf, size_type count) writes into [buf, buf + count) and returns the
+        // length it kept, r <= count, the size becomes r
+        template <class Operation>
+        void resize_and_overwrite(size_type count, Operation op);
+
         void clear() noexcept
         { size_ = 0; }
 
@@ -772,8 +785,82 @@ namespace tinystl
 
         // reallocate
         void reallocate(size_type need);
+        void grow_for_overwrite(size_type n);
         iterator reallocate_and_fill(iterator pos, size_type n, value_type ch);
         iterator reallocate_and_copy(iterator pos, const_iterator first, const_iterator last);
     };
+
+    /*****************************************************************************************/
+
+    // resize_default_init
+    template <class CharType, class CharTraits>
+    void basic_string<CharType, CharTraits>::
+    resize_default_init(size_type count)
+    {
+        grow_for_overwrite(count);
+        size_ = count;
+        buffer_[size_] = value_type();
+    }
+
+    // resize_and_overwrite
+    template <class CharType, class CharTraits>
+    template <class Operation>
+    void basic_string<CharType, CharTraits>::
+    resize_and_overwrite(size_type count, Operation op)
+    {
+        grow_for_overwrite(count);
+        const size_type r = static_cast<size_type>(op(buffer_, count));
+        TINYSTL_DEBUG(r <= count);
+        size_ = r;
+        buffer_[size_] = value_type();
+    }
+
+    // grow_for_overwrite
+    // Make room for n characters plus the terminator, the old contents are kept
+    template <class CharType, class CharTraits>
+    void basic_string<CharType, CharTraits>::
+    grow_for_overwrite(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "basic_string<Char, Traits>'s size too big");
+        if (n < cap_)
+            return;
+        const auto new_cap = tinystl::max(n + 1,
+            tinystl::max(cap_ + (cap_ >> 1), static_cast<size_type>(STRING_INIT_SIZE)));
+        auto new_buffer = data_allocator::allocate(new_cap);
+        if (buffer_ != nullptr)
+        {
+            char_traits::move(new_buffer, buffer_, size_);
+            data_allocator::deallocate(buffer_);
+        }
+        buffer_ = new_buffer;
+        cap_ = new_cap;
+    }
+
+    // comparison
+    template <class CharType, class CharTraits>
+    bool operator==(const basic_string<CharType, CharTraits>& lhs,
+                    const basic_string<CharType, CharTraits>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            CharTraits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+    }
+
+    template <class CharType, class CharTraits>
+    bool operator!=(const basic_string<CharType, CharTraits>& lhs,
+                    const basic_string<CharType, CharTraits>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // hash of a string: the bitwise hash of its characters
+    template <class CharType, class CharTraits>
+    struct hash<basic_string<CharType, CharTraits>>
+    {
+        size_t operator()(const basic_string<CharType, CharTraits>& str) const noexcept
+        {
+            return bitwise_hash(reinterpret_cast<const unsigned char*>(str.data()),
+                                str.size() * sizeof(CharType));
+        }
+    };
 }
 #endif
@@ -0,0 +1,809 @@
+#ifndef _CIRCULAR_BUFFER_H_
+#define _CIRCULAR_BUFFER_H_
+
+// circular_buffer : ring buffer with a power-of-two capacity
+
+// notes:
+// The elements live in one array of capacity() slots and capacity() is always a power of two,
+// so the slot of the i-th element is (head + i) & (capacity() - 1), there is no division.
+// The elements form at most two contiguous pieces:
+//   array_one(): from the oldest element to the end of the array
+//   array_two(): from the start of the array to the newest element (may be empty)
+// linearize() moves them into one piece.
+//
+// Two modes:
+//   * growable (default): a full buffer doubles its capacity, like vector
+//   * fixed: set_capacity(n) fixes the capacity to n rounded up to a power of two,
+//            push_back on a full buffer overwrites the oldest element (front),
+//            push_front on a full buffer overwrites the newest element (back),
+//            so it keeps the last capacity() elements and never allocates again
+//
+// It has front / back / push_back / emplace_back / pop_front / pop_back,
+// so it can be the Container of tinystl::queue and tinystl::stack.
+// There is no insert / erase in the middle.
+//
+// Iterator invalidation:
+//   * a reallocation (growing, reserve, set_capacity, linearize) invalidates all iterators
+//   * otherwise push / pop only invalidate the iterators to the removed or overwritten elements,
+//     and end() after a push_back / pop_back
+//
+// tinystl::circular_buffer<T> Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace_front
+//   * emplace_back
+//   * push_front
+//   * push_back
+// (when the buffer is not full, or is growable)
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+#include "allocator.h"
+
+namespace tinystl
+{
+
+    // the first capacity of a growable circular_buffer
+    #ifndef CIRCULAR_BUFFER_INIT_SIZE
+    #define CIRCULAR_BUFFER_INIT_SIZE 8
+    #endif
+
+    // the smallest power of two which is not less than n
+    inline size_t circular_buffer_ceil_pow2(size_t n) noexcept
+    {
+        size_t cap = 1;
+        while (cap < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    // circular_buffer's iterator
+    // pos is the unwrapped position head + i, the slot is pos & mask,
+    // so the iterators to the kept elements stay valid when the head moves
+    template <class T, class Ref, class Ptr>
+    struct circular_buffer_iterator : public tinystl::iterator<tinystl::random_access_iterator_tag, T>
+    {
+        typedef circular_buffer_iterator<T, T&, T*>              iterator;
+        typedef circular_buffer_iterator<T, const T&, const T*>  const_iterator;
+        typedef circular_buffer_iterator                         self;
+
+        typedef T            value_type;
+        typedef Ptr          pointer;
+        typedef Ref          reference;
+        typedef size_t       size_type;
+        typedef ptrdiff_t    difference_type;
+
+        T*        data;
+        size_type mask;
+        size_type pos;
+
+        circular_buffer_iterator() noexcept :data(nullptr), mask(0), pos(0)
+        {}
+
+        circular_buffer_iterator(T* d, size_type m, size_type p) noexcept
+            :data(d), mask(m), pos(p)
+        {}
+
+        circular_buffer_iterator(const iterator& rhs) noexcept
+            :data(rhs.data), mask(rhs.mask), pos(rhs.pos)
+        {}
+
+        self& operator=(const iterator& rhs) noexcept
+        {
+            data = rhs.data;
+            mask = rhs.mask;
+            pos = rhs.pos;
+            return *this;
+        }
+
+        reference operator*() const
+        { return data[pos & mask]; }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        reference operator[](difference_type n) const
+        { return data[(pos + n) & mask]; }
+
+        self& operator++()
+        {
+            ++pos;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++pos;
+            return tmp;
+        }
+        self& operator--()
+        {
+            --pos;
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --pos;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n)
+        {
+            pos += n;
+            return *this;
+        }
+        self operator+(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self& operator-=(difference_type n)
+        {
+            pos -= n;
+            return *this;
+        }
+        self operator-(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        // pos wraps around like an unsigned number, compare the difference
+        difference_type operator-(const self& rhs) const
+        { return static_cast<difference_type>(pos - rhs.pos); }
+
+        bool operator==(const self& rhs) const
+        { return pos == rhs.pos; }
+        bool operator!=(const self& rhs) const
+        { return !(*this == rhs); }
+        bool operator< (const self& rhs) const
+        { return *this - rhs < 0; }
+        bool operator> (const self& rhs) const
+        { return rhs < *this; }
+        bool operator<=(const self& rhs) const
+        { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const
+        { return !(*this < rhs); }
+    };
+
+    template <class T, class Ref, class Ptr>
+    circular_buffer_iterator<T, Ref, Ptr>
+    operator+(ptrdiff_t n, const circular_buffer_iterator<T, Ref, Ptr>& it)
+    {
+        return it + n;
+    }
+
+    //=================== circular_buffer template ===========================================
+    template <class T>
+    class circular_buffer
+    {
+    public:
+        typedef tinystl::allocator<T>                       allocator_type;
+        typedef tinystl::allocator<T>                       data_allocator;
+
+        typedef typename allocator_type::value_type         value_type;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+        typedef circular_buffer_iterator<T, T&, T*>              iterator;
+        typedef circular_buffer_iterator<T, const T&, const T*>  const_iterator;
+        typedef tinystl::reverse_iterator<iterator>              reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+        // a contiguous piece of the elements: (first element, number of elements)
+        typedef tinystl::pair<pointer, size_type>           array_range;
+        typedef tinystl::pair<const_pointer, size_type>     const_array_range;
+
+        allocator_type get_allocator()
+        { return allocator_type(); }
+
+    private:
+        pointer   data_;   // the array, nullptr when the capacity is 0
+        size_type cap_;    // 0 or a power of two
+        size_type head_;   // unwrapped position of the front, the slot is head_ & mask()
+        size_type size_;   // number of elements
+        bool      fixed_;  // true: overwrite when full, false: grow when full
+
+    public:
+        //---------------------------------------------------------------------------------
+        // constructor
+        circular_buffer() noexcept
+            :data_(nullptr), cap_(0), head_(0), size_(0), fixed_(false)
+        {}
+
+        explicit circular_buffer(size_type n)
+            :data_(nullptr), cap_(0), head_(0), size_(0), fixed_(false)
+        { fill_init(n, value_type()); }
+
+        circular_buffer(size_type n, const value_type& value)
+            :data_(nullptr), cap_(0), head_(0), size_(0), fixed_(false)
+        { fill_init(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        circular_buffer(Iter first, Iter last)
+            :data_(nullptr), cap_(0), head_(0), size_(0), fixed_(false)
+        { copy_init(first, last, iterator_category(first)); }
+
+        circular_buffer(std::initializer_list<value_type> ilist)
+            :data_(nullptr), cap_(0), head_(0), size_(0), fixed_(false)
+        { copy_init(ilist.begin(), ilist.end(), tinystl::forward_iterator_tag()); }
+
+        // keeps the capacity and the mode of rhs
+        circular_buffer(const circular_buffer& rhs)
+            :data_(nullptr), cap_(0), head_(0), size_(0), fixed_(rhs.fixed_)
+        {
+            if (rhs.cap_ != 0)
+            {
+                data_ = data_allocator::allocate(rhs.cap_);
+                cap_ = rhs.cap_;
+                try
+                {
+                    for (; size_ < rhs.size_; ++size_)
+                        data_allocator::construct(data_ + size_, rhs[size_]);
+                }
+                catch (...)
+                {
+                    clear();
+                    release();
+                    throw;
+                }
+            }
+        }
+
+        circular_buffer(circular_buffer&& rhs) noexcept
+            :data_(rhs.data_), cap_(rhs.cap_), head_(rhs.head_), size_(rhs.size_), fixed_(rhs.fixed_)
+        {
+            rhs.data_ = nullptr;
+            rhs.cap_ = 0;
+            rhs.head_ = 0;
+            rhs.size_ = 0;
+            rhs.fixed_ = false;  // no storage left to overwrite, a push grows it again
+        }
+
+        circular_buffer& operator=(const circular_buffer& rhs)
+        {
+            if (this != &rhs)
+            {
+                circular_buffer tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        circular_buffer& operator=(circular_buffer&& rhs) noexcept
+        {
+            circular_buffer tmp(tinystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        circular_buffer& operator=(std::initializer_list<value_type> ilist)
+        {
+            circular_buffer tmp(ilist);
+            swap(tmp);
+            return *this;
+        }
+
+        ~circular_buffer()
+        {
+            clear();
+            release();
+        }
+
+    public:
+        // iterator operation----------------------------------------------------------------
+        iterator begin() noexcept
+        { return iterator(data_, mask(), head_); }
+
+        const_iterator begin() const noexcept
+        { return const_iterator(data_, mask(), head_); }
+
+        iterator end() noexcept
+        { return iterator(data_, mask(), head_ + size_); }
+
+        const_iterator end() const noexcept
+        { return const_iterator(data_, mask(), head_ + size_); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // container operation---------------------------------------------------------------
+        bool empty() const noexcept
+        { return size_ == 0; }
+
+        bool full() const noexcept
+        { return size_ == cap_; }
+
+        size_type size() const noexcept
+        { return size_; }
+
+        size_type capacity() const noexcept
+        { return cap_; }
+
+        size_type max_size() const noexcept
+        { return (static_cast<size_type>(-1) / 2 + 1) / sizeof(T); }
+
+        // true when the capacity is fixed and a full buffer overwrites
+        bool is_fixed() const noexcept
+        { return fixed_; }
+
+        // growable mode: make room for at least n elements
+        void reserve(size_type n);
+
+        // fixed mode: capacity becomes n rounded up to a power of two (at least 1),
+        // the oldest elements are dropped when they do not fit
+        void set_capacity(size_type n);
+
+        // back to growable mode, the capacity is kept
+        void set_growable() noexcept
+        { fixed_ = false; }
+
+        // visit element---------------------------------------------------------------------
+        reference operator[](size_type n)
+        {
+            TINYSTL_DEBUG(n < size_);
+            return data_[(head_ + n) & mask()];
+        }
+
+        const_reference operator[](size_type n) const
+        {
+            TINYSTL_DEBUG(n < size_);
+            return data_[(head_ + n) & mask()];
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "circular_buffer<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "circular_buffer<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        {
+            TINYSTL_DEBUG(!empty());
+            return data_[head_ & mask()];
+        }
+
+        const_reference front() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return data_[head_ & mask()];
+        }
+
+        reference back()
+        {
+            TINYSTL_DEBUG(!empty());
+            return data_[(head_ + size_ - 1) & mask()];
+        }
+
+        const_reference back() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return data_[(head_ + size_ - 1) & mask()];
+        }
+
+        // the two contiguous pieces, front to back
+        array_range array_one() noexcept
+        {
+            const size_type first = head_ & mask();
+            return array_range(data_ + first, size_ < cap_ - first ? size_ : cap_ - first);
+        }
+
+        const_array_range array_one() const noexcept
+        {
+            const size_type first = head_ & mask();
+            return const_array_range(data_ + first, size_ < cap_ - first ? size_ : cap_ - first);
+        }
+
+        array_range array_two() noexcept
+        { return array_range(data_, size_ - array_one().second); }
+
+        const_array_range array_two() const noexcept
+        { return const_array_range(data_, size_ - array_one().second); }
+
+        // move the elements into one piece and return it (may reallocate)
+        pointer linearize();
+
+        // adjust container operation--------------------------------------------------------
+        // emplace_front / emplace_back
+        template <class ...Args>
+        void emplace_front(Args&& ...args);
+
+        template <class ...Args>
+        void emplace_back(Args&& ...args);
+
+        // push_front / push_back
+        void push_front(const value_type& value)
+        { emplace_front(value); }
+
+        void push_front(value_type&& value)
+        { emplace_front(tinystl::move(value)); }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+
+        void push_back(value_type&& value)
+        { emplace_back(tinystl::move(value)); }
+
+        // pop_front / pop_back
+        void pop_front()
+        {
+            TINYSTL_DEBUG(!empty());
+            data_allocator::destroy(data_ + (head_ & mask()));
+            ++head_;
+            --size_;
+        }
+
+        void pop_back()
+        {
+            TINYSTL_DEBUG(!empty());
+            data_allocator::destroy(data_ + ((head_ + size_ - 1) & mask()));
+            --size_;
+        }
+
+        // resize
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+        void resize(size_type new_size, const value_type& value);
+
+        void clear() noexcept;
+
+        void swap(circular_buffer& rhs) noexcept
+        {
+            tinystl::swap(data_, rhs.data_);
+            tinystl::swap(cap_, rhs.cap_);
+            tinystl::swap(head_, rhs.head_);
+            tinystl::swap(size_, rhs.size_);
+            tinystl::swap(fixed_, rhs.fixed_);
+        }
+
+    private:
+        // helper functions
+        size_type mask() const noexcept
+        { return cap_ - 1; }
+
+        void release() noexcept
+        {
+            if (data_ != nullptr)
+                data_allocator::deallocate(data_, cap_);
+            data_ = nullptr;
+            cap_ = 0;
+        }
+
+        void fill_init(size_type n, const value_type& value);
+
+        template <class IIter>
+        void copy_init(IIter first, IIter last, tinystl::input_iterator_tag);
+
+        template <class FIter>
+        void copy_init(FIter first, FIter last, tinystl::forward_iterator_tag);
+
+        void move_elements(pointer dst);
+        void reallocate(size_type new_cap);
+
+        template <class ...Args>
+        void grow_emplace(bool back, Args&& ...args);
+    };
+
+    //============= implement =================================================================
+
+    // fill_init
+    template <class T>
+    void circular_buffer<T>::fill_init(size_type n, const value_type& value)
+    {
+        if (n == 0)
+            return;
+        reserve(n);
+        try
+        {
+            for (; size_ < n; ++size_)
+                data_allocator::construct(data_ + size_, value);
+        }
+        catch (...)
+        {
+            clear();
+            release();
+            throw;
+        }
+    }
+
+    // copy_init
+    template <class T>
+    template <class IIter>
+    void circular_buffer<T>::copy_init(IIter first, IIter last, tinystl::input_iterator_tag)
+    {
+        try
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+        catch (...)
+        {
+            clear();
+            release();
+            throw;
+        }
+    }
+
+    template <class T>
+    template <class FIter>
+    void circular_buffer<T>::copy_init(FIter first, FIter last, tinystl::forward_iterator_tag)
+    {
+        const size_type n = tinystl::distance(first, last);
+        if (n == 0)
+            return;
+        reserve(n);
+        try
+        {
+            for (; first != last; ++first, ++size_)
+                data_allocator::construct(data_ + size_, *first);
+        }
+        catch (...)
+        {
+            clear();
+            release();
+            throw;
+        }
+    }
+
+    // move the elements in order to [dst, dst + size_), the old ones are left moved-from
+    template <class T>
+    void circular_buffer<T>::move_elements(pointer dst)
+    {
+        const auto one = array_one();
+        const auto two = array_two();
+        tinystl::uninitialized_move_n(one.first, one.second, dst);
+        try
+        {
+            tinystl::uninitialized_move_n(two.first, two.second, dst + one.second);
+        }
+        catch (...)
+        {
+            tinystl::destroy(dst, dst + one.second);
+            throw;
+        }
+    }
+
+    // moves the elements to a new array of new_cap slots (new_cap >= size_), head_ becomes 0
+    template <class T>
+    void circular_buffer<T>::reallocate(size_type new_cap)
+    {
+        TINYSTL_DEBUG(new_cap >= size_);
+        auto new_data = data_allocator::allocate(new_cap);
+        try
+        {
+            move_elements(new_data);
+        }
+        catch (...)
+        {
+            data_allocator::deallocate(new_data, new_cap);
+            throw;
+        }
+        const size_type n = size_;
+        clear();
+        release();
+        data_ = new_data;
+        cap_ = new_cap;
+        head_ = 0;
+        size_ = n;
+    }
+
+    // reserve
+    template <class T>
+    void circular_buffer<T>::reserve(size_type n)
+    {
+        if (n <= cap_)
+            return;
+        THROW_LENGTH_ERROR_IF(n > max_size(),
+                              "n can not larger than max_size() in circular_buffer<T>::reserve(n)");
+        reallocate(circular_buffer_ceil_pow2(n));
+    }
+
+    // set_capacity
+    template <class T>
+    void circular_buffer<T>::set_capacity(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(),
+                              "n can not larger than max_size() in circular_buffer<T>::set_capacity(n)");
+        const size_type new_cap = circular_buffer_ceil_pow2(n);
+        while (size_ > new_cap)
+            pop_front();
+        if (new_cap != cap_)
+            reallocate(new_cap);
+        fixed_ = true;
+    }
+
+    // linearize
+    template <class T>
+    typename circular_buffer<T>::pointer circular_buffer<T>::linearize()
+    {
+        if (array_two().second != 0)
+            reallocate(cap_);
+        return data_ + (head_ & mask());
+    }
+
+    // a full growable buffer: build the new element in the new array first,
+    // then move the old ones around it, so args may refer to an element of the buffer
+    template <class T>
+    template <class ...Args>
+    void circular_buffer<T>::grow_emplace(bool back, Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(cap_ >= max_size(), "circular_buffer<T>'s size too big");
+        const size_type new_cap = cap_ == 0 ? CIRCULAR_BUFFER_INIT_SIZE : cap_ * 2;
+        auto new_data = data_allocator::allocate(new_cap);
+        const auto pos = new_data + (back ? size_ : 0);
+        try
+        {
+            data_allocator::construct(pos, tinystl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            data_allocator::deallocate(new_data, new_cap);
+            throw;
+        }
+        try
+        {
+            move_elements(new_data + (back ? 0 : 1));
+        }
+        catch (...)
+        {
+            data_allocator::destroy(pos);
+            data_allocator::deallocate(new_data, new_cap);
+            throw;
+        }
+        const size_type n = size_ + 1;
+        clear();
+        release();
+        data_ = new_data;
+        cap_ = new_cap;
+        head_ = 0;
+        size_ = n;
+    }
+
+    // emplace_back
+    // full and fixed: the new element replaces the oldest one
+    template <class T>
+    template <class ...Args>
+    void circular_buffer<T>::emplace_back(Args&& ...args)
+    {
+        if (size_ < cap_)
+        {
+            data_allocator::construct(data_ + ((head_ + size_) & mask()),
+                                      tinystl::forward<Args>(args)...);
+            ++size_;
+        }
+        else if (fixed_)
+        {
+            // the slot after the back is the front
+            data_[head_ & mask()] = value_type(tinystl::forward<Args>(args)...);
+            ++head_;
+        }
+        else
+        {
+            grow_emplace(true, tinystl::forward<Args>(args)...);
+        }
+    }
+
+    // emplace_front
+    // full and fixed: the new element replaces the newest one
+    template <class T>
+    template <class ...Args>
+    void circular_buffer<T>::emplace_front(Args&& ...args)
+    {
+        if (size_ < cap_)
+        {
+            data_allocator::construct(data_ + ((head_ - 1) & mask()),
+                                      tinystl::forward<Args>(args)...);
+            --head_;
+            ++size_;
+        }
+        else if (fixed_)
+        {
+            // the slot before the front is the back
+            data_[(head_ - 1) & mask()] = value_type(tinystl::forward<Args>(args)...);
+            --head_;
+        }
+        else
+        {
+            grow_emplace(false, tinystl::forward<Args>(args)...);
+        }
+    }
+
+    // resize
+    template <class T>
+    void circular_buffer<T>::resize(size_type new_size, const value_type& value)
+    {
+        while (size_ > new_size)
+            pop_back();
+        while (size_ < new_size)
+            emplace_back(value);
+    }
+
+    // clear: destroy the elements, the array is kept
+    template <class T>
+    void circular_buffer<T>::clear() noexcept
+    {
+        const auto one = array_one();
+        const auto two = array_two();
+        tinystl::destroy(one.first, one.first + one.second);
+        tinystl::destroy(two.first, two.first + two.second);
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // overloaded comparison operator
+    template <class T>
+    bool operator==(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T>
+    bool operator<(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+    {
+        return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T>
+    bool operator!=(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T>
+    bool operator>(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T>
+    bool operator<=(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T>
+    bool operator>=(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overload tinystl's swap
+    template <class T>
+    void swap(circular_buffer<T>& lhs, circular_buffer<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+}
+#endif
@@ -38,10 +38,36 @@ namespace tinystl
     #define DEQUE_MAP_INIT_SIZE 8
     #endif
 
+    // deque buffer size mode
+    // 1: round the buffer size down to a power of two,
+    //    so that indexing uses shift / mask instead of division / modulo
+    // 0: keep the raw size (4096 / sizeof(T)), no element slot is wasted
+    #ifndef DEQUE_POW2_BUFFER
+    #define DEQUE_POW2_BUFFER 1
+    #endif
+
+    // the largest power of two which is not greater than n (n > 0)
+    constexpr size_t deque_floor_pow2(size_t n)
+    {
+        return (n & (n - 1)) == 0 ? n : deque_floor_pow2(n & (n - 1));
+    }
+
+    // log2(n) when n is a power of two
+    constexpr size_t deque_log2(size_t n)
+    {
+        return n <= 1 ? 0 : 1 + deque_log2(n >> 1);
+    }
+
     template <class T>
     struct deque_buf_size
     {
-        static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+        static constexpr size_t raw   = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+        static constexpr size_t value = DEQUE_POW2_BUFFER ? deque_floor_pow2(raw) : raw;
+
+        // used by the shift / mask path, only meaningful when is_pow2 is true
+        static constexpr bool   is_pow2 = (value & (value - 1)) == 0;
+        static constexpr size_t shift   = deque_log2(value);
+        static constexpr size_t mask    = value - 1;
     };
 
     // deque's iterator
@@ -188,6 +214,20 @@ namespace tinystl
                 // Determine whether the offset is 
                 // in the buffer in front of the current buffer 
                 // or the buffer behind the current buffer
+                if (deque_buf_size<T>::is_pow2)
+                {
+                    // power of two buffer: the node is offset >> shift (rounded down),
+                    // the position in the buffer is the low bits of offset
+                    const auto node_offset = offset > 0
+                        ? static_cast<difference_type>(
+                            static_cast<size_type>(offset) >> deque_buf_size<T>::shift)
+                        : -static_cast<difference_type>(
+                            static_cast<size_type>(-offset - 1) >> deque_buf_size<T>::shift) - 1;
+
+                    set_node(node + node_offset);
+                    cur = first + (static_cast<size_type>(offset) & deque_buf_size<T>::mask);
+                    return *this;
+                }
                 const auto node_offset = offset > 0
                     ? offset / static_cast<difference_type>(buffer_size)
                     : -static_cast<difference_type>((-offset - 1) / buffer_size) - 1;
@@ -244,6 +284,36 @@ namespace tinystl
         }
     };
 
+    // deque_iterator is a segmented iterator: each buffer is a contiguous array,
+    // copy / fill / find / for_each / accumulate work on it buffer by buffer
+    template <class T, class Ref, class Ptr>
+    struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr>>
+    {
+        typedef m_true_type                             is_segmented_iterator;
+        typedef deque_iterator<T, Ref, Ptr>             iterator;
+        typedef typename iterator::map_pointer          segment_iterator;
+        typedef Ptr                                     local_iterator;
+
+        static segment_iterator segment(const iterator& it) { return it.node; }
+        static local_iterator   local(const iterator& it)   { return it.cur; }
+        static local_iterator   begin(segment_iterator s)   { return *s; }
+        static local_iterator   end(segment_iterator s)     { return *s + iterator::buffer_size; }
+
+        static iterator compose(segment_iterator s, local_iterator l)
+        {
+            // an iterator never stays at the end of a buffer, go to the next one
+            if (l == end(s))
+            {
+                ++s;
+                l = begin(s);
+            }
+            iterator it;
+            it.set_node(s);
+            it.cur = const_cast<T*>(l);
+            return it;
+        }
+    };
+
     // deque
     // Template parameters represent data types
     template <class T>
@@ -431,15 +501,17 @@ namespace tinystl
 
         // access element 
         // [] overload
+        // go to the buffer directly instead of begin_ + n,
+        // which copies an iterator and takes the signed offset path
         reference operator[](size_type n)
         {
             TINYSTL_DEBUG(n < size());
-            return begin_[n];
+            return *elem_ptr(n);
         }
         const_reference operator[](size_type n) const
         {
             TINYSTL_DEBUG(n < size());
-            return begin_[n];
+            return *elem_ptr(n);
         }
 
         reference at(size_type n)      
@@ -546,6 +618,18 @@ namespace tinystl
 
     private:
         // helper functions
+        // address of the n-th element, the offset from begin_.first is never negative
+        pointer elem_ptr(size_type n) const noexcept
+        {
+            const size_type offset = n + static_cast<size_type>(begin_.cur - begin_.first);
+            if (deque_buf_size<T>::is_pow2)
+            {
+                return begin_.node[offset >> deque_buf_size<T>::shift]
+                    + (offset & deque_buf_size<T>::mask);
+            }
+            return begin_.node[offset / buffer_size] + offset % buffer_size;
+        }
+
         // create node / destroy node
         map_pointer create_map(size_type size);
 
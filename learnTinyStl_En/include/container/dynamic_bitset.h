@@ -0,0 +1,853 @@
+#ifndef _DYNAMIC_BITSET_H_
+#define _DYNAMIC_BITSET_H_
+
+// dynamic_bitset
+// A resizable sequence of bits, packed 64 per word,
+// so a set of 10^9 flags costs 125MB instead of 1GB as vector<bool>.
+// operator[] and the iterators return the proxy class bit_reference.
+
+// notes:
+// The unused high bits of the last word are always kept zero,
+// so count / any / find_first / operator== can work word by word.
+// The bulk operations (count, find_first, find_next, &=, |=, ^=, -=)
+// use AVX2 when the compiler targets it (-mavx2) and TINYSTL_NO_SIMD is not defined,
+// otherwise they fall back to one word at a time.
+//
+// tinystl::count / tinystl::find on a range of dynamic_bitset iterators
+// are overloaded below to work word by word as well.
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+#include "vector.h"
+
+#if defined(__AVX2__) && !defined(TINYSTL_NO_SIMD)
+#define TINYSTL_BITSET_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tinystl
+{
+
+    typedef uint64_t bitset_word;
+
+    // number of bits in a word
+    constexpr size_t bitset_word_bits = 64;
+
+    //===================================================================================
+    // word helpers
+    //===================================================================================
+
+    // number of set bits in w
+    inline size_t bitset_popcount(bitset_word w) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_popcountll(w));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<size_t>(__popcnt64(w));
+#else
+        w = w - ((w >> 1) & 0x5555555555555555ULL);
+        w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<size_t>((w * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    // index of the lowest set bit, w must not be zero
+    inline size_t bitset_ctz(bitset_word w) noexcept
+    {
+        TINYSTL_DEBUG(w != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(w));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, w);
+        return static_cast<size_t>(index);
+#else
+        size_t n = 0;
+        while ((w & 1) == 0)
+        {
+            w >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    // a word with the low n bits set, 0 < n <= 64
+    inline bitset_word bitset_low_mask(size_t n) noexcept
+    {
+        return n >= bitset_word_bits ? ~bitset_word(0) : (bitset_word(1) << n) - 1;
+    }
+
+    //===================================================================================
+    // bulk word kernels
+    //===================================================================================
+
+    // bitset_count_words
+    // Total number of set bits in [p, p + n)
+    inline size_t bitset_count_words(const bitset_word* p, size_t n) noexcept
+    {
+        size_t total = 0;
+        size_t i = 0;
+#ifdef TINYSTL_BITSET_AVX2
+        // popcount of every byte by a 4-bit lookup table, summed with sad_epu8
+        const __m256i lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low = _mm256_set1_epi8(0x0f);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+            const __m256i hi = _mm256_shuffle_epi8(lookup,
+                _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+            acc = _mm256_add_epi64(acc,
+                _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        total += static_cast<size_t>(_mm256_extract_epi64(acc, 0))
+            + static_cast<size_t>(_mm256_extract_epi64(acc, 1))
+            + static_cast<size_t>(_mm256_extract_epi64(acc, 2))
+            + static_cast<size_t>(_mm256_extract_epi64(acc, 3));
+#endif
+        for (; i < n; ++i)
+            total += bitset_popcount(p[i]);
+        return total;
+    }
+
+    // bitset_find_word
+    // Index of the first word in [p, p + n) with (p[i] ^ flip) != 0, n if there is none.
+    // flip is 0 to look for a set bit, ~0 to look for a clear bit
+    inline size_t bitset_find_word(const bitset_word* p, size_t n, bitset_word flip) noexcept
+    {
+        size_t i = 0;
+#ifdef TINYSTL_BITSET_AVX2
+        const __m256i f = _mm256_set1_epi64x(static_cast<long long>(flip));
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256i v = _mm256_xor_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), f);
+            if (!_mm256_testz_si256(v, v))
+                break;
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            if ((p[i] ^ flip) != 0)
+                return i;
+        }
+        return n;
+    }
+
+    // dst[i] = dst[i] op src[i] for i in [0, n)
+#ifdef TINYSTL_BITSET_AVX2
+#define TINYSTL_BITSET_BINARY_OP(name, simd_expr, word_expr)                            \
+    inline void name(bitset_word* dst, const bitset_word* src, size_t n) noexcept     \
+    {                                                                                 \
+        size_t i = 0;                                                                 \
+        for (; i + 4 <= n; i += 4)                                                    \
+        {                                                                             \
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i)); \
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)); \
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), simd_expr);      \
+        }                                                                             \
+        for (; i < n; ++i)                                                            \
+        {                                                                             \
+            const bitset_word a = dst[i], b = src[i];                                 \
+            dst[i] = word_expr;                                                       \
+        }                                                                             \
+    }
+#else
+#define TINYSTL_BITSET_BINARY_OP(name, simd_expr, word_expr)                            \
+    inline void name(bitset_word* dst, const bitset_word* src, size_t n) noexcept     \
+    {                                                                                 \
+        for (size_t i = 0; i < n; ++i)                                                \
+        {                                                                             \
+            const bitset_word a = dst[i], b = src[i];                                 \
+            dst[i] = word_expr;                                                       \
+        }                                                                             \
+    }
+#endif
+
+    TINYSTL_BITSET_BINARY_OP(bitset_and_words,    _mm256_and_si256(a, b),    a & b)
+    TINYSTL_BITSET_BINARY_OP(bitset_or_words,     _mm256_or_si256(a, b),     a | b)
+    TINYSTL_BITSET_BINARY_OP(bitset_xor_words,    _mm256_xor_si256(a, b),    a ^ b)
+    // note: _mm256_andnot_si256(x, y) computes ~x & y
+    TINYSTL_BITSET_BINARY_OP(bitset_andnot_words, _mm256_andnot_si256(b, a), a & ~b)
+
+#undef TINYSTL_BITSET_BINARY_OP
+
+    //===================================================================================
+    // bit_reference
+    //===================================================================================
+
+    // A proxy to one bit of a word, what dynamic_bitset::operator[] returns
+    class bit_reference
+    {
+    private:
+        bitset_word* p_;
+        bitset_word  mask_;
+
+    public:
+        bit_reference(bitset_word* p, size_t offset) noexcept
+            :p_(p), mask_(bitset_word(1) << offset)
+        {}
+
+        operator bool() const noexcept
+        { return (*p_ & mask_) != 0; }
+
+        bool operator~() const noexcept
+        { return (*p_ & mask_) == 0; }
+
+        bit_reference& operator=(bool value) noexcept
+        {
+            if (value)
+                *p_ |= mask_;
+            else
+                *p_ &= ~mask_;
+            return *this;
+        }
+
+        bit_reference& operator=(const bit_reference& rhs) noexcept
+        { return *this = static_cast<bool>(rhs); }
+
+        bit_reference& operator|=(bool value) noexcept
+        {
+            if (value)
+                *p_ |= mask_;
+            return *this;
+        }
+
+        bit_reference& operator&=(bool value) noexcept
+        {
+            if (!value)
+                *p_ &= ~mask_;
+            return *this;
+        }
+
+        bit_reference& operator^=(bool value) noexcept
+        {
+            if (value)
+                *p_ ^= mask_;
+            return *this;
+        }
+
+        bit_reference& flip() noexcept
+        {
+            *p_ ^= mask_;
+            return *this;
+        }
+    };
+
+    // swap two referenced bits, so that tinystl::swap works on *it
+    inline void swap(bit_reference a, bit_reference b) noexcept
+    {
+        const bool tmp = a;
+        a = static_cast<bool>(b);
+        b = tmp;
+    }
+
+    //===================================================================================
+    // iterators
+    //===================================================================================
+
+    // The position of a bit: a word pointer and the offset inside the word [0, 64)
+    template <class WordPtr>
+    struct bit_iterator_base
+    {
+        typedef ptrdiff_t difference_type;
+
+        WordPtr  p_;
+        unsigned offset_;
+
+        bit_iterator_base() noexcept :p_(nullptr), offset_(0) {}
+        bit_iterator_base(WordPtr p, unsigned offset) noexcept :p_(p), offset_(offset) {}
+
+        void bump_up() noexcept
+        {
+            if (++offset_ == bitset_word_bits)
+            {
+                offset_ = 0;
+                ++p_;
+            }
+        }
+
+        void bump_down() noexcept
+        {
+            if (offset_-- == 0)
+            {
+                offset_ = bitset_word_bits - 1;
+                --p_;
+            }
+        }
+
+        void advance(difference_type n) noexcept
+        {
+            const difference_type bits = static_cast<difference_type>(bitset_word_bits);
+            difference_type pos = n + static_cast<difference_type>(offset_);
+            difference_type q = pos / bits;
+            if (pos % bits < 0)
+                --q;
+            p_ += q;
+            offset_ = static_cast<unsigned>(pos - q * bits);
+        }
+
+        difference_type distance_to(const bit_iterator_base& rhs) const noexcept
+        {
+            return (rhs.p_ - p_) * static_cast<difference_type>(bitset_word_bits)
+                + static_cast<difference_type>(rhs.offset_)
+                - static_cast<difference_type>(offset_);
+        }
+
+        bool operator==(const bit_iterator_base& rhs) const noexcept
+        { return p_ == rhs.p_ && offset_ == rhs.offset_; }
+        bool operator!=(const bit_iterator_base& rhs) const noexcept
+        { return !(*this == rhs); }
+        bool operator<(const bit_iterator_base& rhs) const noexcept
+        { return p_ < rhs.p_ || (p_ == rhs.p_ && offset_ < rhs.offset_); }
+        bool operator>(const bit_iterator_base& rhs) const noexcept
+        { return rhs < *this; }
+        bool operator<=(const bit_iterator_base& rhs) const noexcept
+        { return !(rhs < *this); }
+        bool operator>=(const bit_iterator_base& rhs) const noexcept
+        { return !(*this < rhs); }
+    };
+
+    // bit_iterator
+    struct bit_iterator : public bit_iterator_base<bitset_word*>,
+        public tinystl::iterator<tinystl::random_access_iterator_tag, bool,
+        ptrdiff_t, void, bit_reference>
+    {
+        typedef bit_iterator_base<bitset_word*> base;
+        typedef bool                            value_type;
+        typedef bit_reference                   reference;
+        typedef void                            pointer;
+        typedef ptrdiff_t                       difference_type;
+        typedef bit_iterator                    self;
+
+        bit_iterator() noexcept = default;
+        bit_iterator(bitset_word* p, unsigned offset) noexcept :base(p, offset) {}
+
+        reference operator*() const noexcept
+        { return reference(p_, offset_); }
+        reference operator[](difference_type n) const noexcept
+        { return *(*this + n); }
+
+        self& operator++() noexcept { bump_up(); return *this; }
+        self& operator--() noexcept { bump_down(); return *this; }
+        self operator++(int) noexcept { self tmp = *this; bump_up(); return tmp; }
+        self operator--(int) noexcept { self tmp = *this; bump_down(); return tmp; }
+
+        self& operator+=(difference_type n) noexcept { advance(n); return *this; }
+        self& operator-=(difference_type n) noexcept { advance(-n); return *this; }
+        self operator+(difference_type n) const noexcept { self tmp = *this; return tmp += n; }
+        self operator-(difference_type n) const noexcept { self tmp = *this; return tmp -= n; }
+
+        difference_type operator-(const self& rhs) const noexcept
+        { return rhs.distance_to(*this); }
+    };
+
+    inline bit_iterator operator+(ptrdiff_t n, const bit_iterator& it) noexcept
+    { return it + n; }
+
+    // bit_const_iterator
+    struct bit_const_iterator : public bit_iterator_base<const bitset_word*>,
+        public tinystl::iterator<tinystl::random_access_iterator_tag, bool,
+        ptrdiff_t, void, bool>
+    {
+        typedef bit_iterator_base<const bitset_word*> base;
+        typedef bool                                  value_type;
+        typedef bool                                  reference;
+        typedef void                                  pointer;
+        typedef ptrdiff_t                             difference_type;
+        typedef bit_const_iterator                    self;
+
+        bit_const_iterator() noexcept = default;
+        bit_const_iterator(const bitset_word* p, unsigned offset) noexcept :base(p, offset) {}
+        bit_const_iterator(const bit_iterator& rhs) noexcept :base(rhs.p_, rhs.offset_) {}
+
+        reference operator*() const noexcept
+        { return (*p_ >> offset_) & 1; }
+        reference operator[](difference_type n) const noexcept
+        { return *(*this + n); }
+
+        self& operator++() noexcept { bump_up(); return *this; }
+        self& operator--() noexcept { bump_down(); return *this; }
+        self operator++(int) noexcept { self tmp = *this; bump_up(); return tmp; }
+        self operator--(int) noexcept { self tmp = *this; bump_down(); return tmp; }
+
+        self& operator+=(difference_type n) noexcept { advance(n); return *this; }
+        self& operator-=(difference_type n) noexcept { advance(-n); return *this; }
+        self operator+(difference_type n) const noexcept { self tmp = *this; return tmp += n; }
+        self operator-(difference_type n) const noexcept { self tmp = *this; return tmp -= n; }
+
+        difference_type operator-(const self& rhs) const noexcept
+        { return rhs.distance_to(*this); }
+    };
+
+    inline bit_const_iterator operator+(ptrdiff_t n, const bit_const_iterator& it) noexcept
+    { return it + n; }
+
+    //===================================================================================
+    // dynamic_bitset
+    //===================================================================================
+
+    class dynamic_bitset
+    {
+    public:
+        typedef bitset_word         word_type;
+        typedef bool                value_type;
+        typedef size_t              size_type;
+        typedef ptrdiff_t           difference_type;
+        typedef bit_reference       reference;
+        typedef bool                const_reference;
+
+        typedef bit_iterator        iterator;
+        typedef bit_const_iterator  const_iterator;
+        typedef tinystl::reverse_iterator<iterator>        reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+        // returned by find_first / find_next when there is no set bit
+        static constexpr size_type npos = static_cast<size_type>(-1);
+        static constexpr size_type bits_per_word = bitset_word_bits;
+
+    private:
+        tinystl::vector<word_type> words_;
+        size_type                  size_;  // number of bits
+
+    public:
+        // constructor, copy/move/destructor are the ones of the word vector
+        dynamic_bitset() noexcept
+            :words_(), size_(0)
+        {}
+
+        explicit dynamic_bitset(size_type n, bool value = false)
+            :words_(words_for(n), value ? ~word_type(0) : word_type(0)), size_(n)
+        { clear_unused_bits(); }
+
+        dynamic_bitset(std::initializer_list<bool> ilist)
+            :words_(words_for(ilist.size()), word_type(0)), size_(ilist.size())
+        {
+            size_type i = 0;
+            for (auto b : ilist)
+            {
+                if (b)
+                    set_unchecked(i);
+                ++i;
+            }
+        }
+
+    public:
+        // iterator
+        iterator begin() noexcept
+        { return iterator(words_.data(), 0); }
+        const_iterator begin() const noexcept
+        { return const_iterator(words_.data(), 0); }
+        iterator end() noexcept
+        { return begin() + static_cast<difference_type>(size_); }
+        const_iterator end() const noexcept
+        { return begin() + static_cast<difference_type>(size_); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return size_ == 0; }
+        size_type size() const noexcept
+        { return size_; }
+        size_type num_words() const noexcept
+        { return words_.size(); }
+        size_type capacity() const noexcept
+        { return words_.capacity() * bits_per_word; }
+        void reserve(size_type n)
+        { words_.reserve(words_for(n)); }
+        void shrink_to_fit()
+        { words_.shrink_to_fit(); }
+
+        // access
+        reference operator[](size_type pos) noexcept
+        {
+            TINYSTL_DEBUG(pos < size_);
+            return reference(&words_[pos / bits_per_word], pos % bits_per_word);
+        }
+        const_reference operator[](size_type pos) const noexcept
+        {
+            TINYSTL_DEBUG(pos < size_);
+            return test_unchecked(pos);
+        }
+
+        bool test(size_type pos) const
+        {
+            THROW_OUT_OF_RANGE_IF(pos >= size_, "dynamic_bitset::test() subscript out of range");
+            return test_unchecked(pos);
+        }
+
+        reference front() noexcept
+        { return (*this)[0]; }
+        const_reference front() const noexcept
+        { return (*this)[0]; }
+        reference back() noexcept
+        { return (*this)[size_ - 1]; }
+        const_reference back() const noexcept
+        { return (*this)[size_ - 1]; }
+
+        word_type* data() noexcept
+        { return words_.data(); }
+        const word_type* data() const noexcept
+        { return words_.data(); }
+
+        // modify
+        dynamic_bitset& set() noexcept;
+        dynamic_bitset& set(size_type pos, bool value = true);
+        dynamic_bitset& reset() noexcept;
+        dynamic_bitset& reset(size_type pos);
+        dynamic_bitset& flip() noexcept;
+        dynamic_bitset& flip(size_type pos);
+
+        void push_back(bool value);
+        void pop_back() noexcept;
+
+        void resize(size_type n, bool value = false);
+        void clear() noexcept
+        {
+            words_.clear();
+            size_ = 0;
+        }
+
+        void swap(dynamic_bitset& rhs) noexcept
+        {
+            words_.swap(rhs.words_);
+            tinystl::swap(size_, rhs.size_);
+        }
+
+        // bulk operations, both sides must have the same size
+        dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept;
+        dynamic_bitset& operator|=(const dynamic_bitset& rhs) noexcept;
+        dynamic_bitset& operator^=(const dynamic_bitset& rhs) noexcept;
+        // and-not: clear every bit that is set in rhs
+        dynamic_bitset& operator-=(const dynamic_bitset& rhs) noexcept;
+
+        dynamic_bitset operator~() const
+        {
+            dynamic_bitset tmp(*this);
+            tmp.flip();
+            return tmp;
+        }
+
+        // query
+        size_type count() const noexcept
+        { return tinystl::bitset_count_words(words_.data(), words_.size()); }
+
+        bool any() const noexcept
+        { return tinystl::bitset_find_word(words_.data(), words_.size(), 0) != words_.size(); }
+        bool none() const noexcept
+        { return !any(); }
+        bool all() const noexcept
+        { return count() == size_; }
+
+        // index of the first set bit, npos if there is none
+        size_type find_first() const noexcept
+        { return find_from(0); }
+
+        // index of the first set bit after pos, npos if there is none
+        size_type find_next(size_type pos) const noexcept
+        { return pos + 1 >= size_ ? npos : find_from(pos + 1); }
+
+        bool operator==(const dynamic_bitset& rhs) const noexcept
+        { return size_ == rhs.size_ && words_ == rhs.words_; }
+        bool operator!=(const dynamic_bitset& rhs) const noexcept
+        { return !(*this == rhs); }
+
+    private:
+        // helper functions
+        static size_type words_for(size_type n) noexcept
+        { return (n + bits_per_word - 1) / bits_per_word; }
+
+        bool test_unchecked(size_type pos) const noexcept
+        { return (words_[pos / bits_per_word] >> (pos % bits_per_word)) & 1; }
+
+        void set_unchecked(size_type pos) noexcept
+        { words_[pos / bits_per_word] |= word_type(1) << (pos % bits_per_word); }
+
+        void clear_unused_bits() noexcept;
+
+        size_type find_from(size_type pos) const noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    // set all bits
+    inline dynamic_bitset& dynamic_bitset::set() noexcept
+    {
+        for (auto& w : words_)
+            w = ~word_type(0);
+        clear_unused_bits();
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::set(size_type pos, bool value)
+    {
+        THROW_OUT_OF_RANGE_IF(pos >= size_, "dynamic_bitset::set() subscript out of range");
+        (*this)[pos] = value;
+        return *this;
+    }
+
+    // clear all bits
+    inline dynamic_bitset& dynamic_bitset::reset() noexcept
+    {
+        for (auto& w : words_)
+            w = 0;
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::reset(size_type pos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos >= size_, "dynamic_bitset::reset() subscript out of range");
+        (*this)[pos] = false;
+        return *this;
+    }
+
+    // flip all bits
+    inline dynamic_bitset& dynamic_bitset::flip() noexcept
+    {
+        for (auto& w : words_)
+            w = ~w;
+        clear_unused_bits();
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::flip(size_type pos)
+    {
+        THROW_OUT_OF_RANGE_IF(pos >= size_, "dynamic_bitset::flip() subscript out of range");
+        (*this)[pos].flip();
+        return *this;
+    }
+
+    // push_back / pop_back
+    inline void dynamic_bitset::push_back(bool value)
+    {
+        if (size_ % bits_per_word == 0)
+            words_.push_back(word_type(0));
+        if (value)
+            set_unchecked(size_);
+        ++size_;
+    }
+
+    inline void dynamic_bitset::pop_back() noexcept
+    {
+        TINYSTL_DEBUG(size_ != 0);
+        --size_;
+        if (size_ % bits_per_word == 0)
+            words_.pop_back();
+        else
+            clear_unused_bits();
+    }
+
+    // resize
+    inline void dynamic_bitset::resize(size_type n, bool value)
+    {
+        const size_type old_size = size_;
+        words_.resize(words_for(n), value ? ~word_type(0) : word_type(0));
+        size_ = n;
+        // the tail of the old last word was zero, fill it too
+        if (value && n > old_size && old_size % bits_per_word != 0)
+            words_[old_size / bits_per_word] |= ~word_type(0) << (old_size % bits_per_word);
+        clear_unused_bits();
+    }
+
+    // bulk operations
+    inline dynamic_bitset& dynamic_bitset::operator&=(const dynamic_bitset& rhs) noexcept
+    {
+        TINYSTL_DEBUG(size_ == rhs.size_);
+        tinystl::bitset_and_words(words_.data(), rhs.words_.data(), words_.size());
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator|=(const dynamic_bitset& rhs) noexcept
+    {
+        TINYSTL_DEBUG(size_ == rhs.size_);
+        tinystl::bitset_or_words(words_.data(), rhs.words_.data(), words_.size());
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator^=(const dynamic_bitset& rhs) noexcept
+    {
+        TINYSTL_DEBUG(size_ == rhs.size_);
+        tinystl::bitset_xor_words(words_.data(), rhs.words_.data(), words_.size());
+        return *this;
+    }
+
+    inline dynamic_bitset& dynamic_bitset::operator-=(const dynamic_bitset& rhs) noexcept
+    {
+        TINYSTL_DEBUG(size_ == rhs.size_);
+        tinystl::bitset_andnot_words(words_.data(), rhs.words_.data(), words_.size());
+        return *this;
+    }
+
+    // keep the bits beyond size_ in the last word zero
+    inline void dynamic_bitset::clear_unused_bits() noexcept
+    {
+        const size_type extra = size_ % bits_per_word;
+        if (extra != 0)
+            words_.back() &= bitset_low_mask(extra);
+    }
+
+    // find_from : the first set bit at or after pos
+    inline dynamic_bitset::size_type dynamic_bitset::find_from(size_type pos) const noexcept
+    {
+        if (pos >= size_)
+            return npos;
+        size_type w = pos / bits_per_word;
+        const word_type first = words_[w] >> (pos % bits_per_word);
+        if (first != 0)
+            return pos + tinystl::bitset_ctz(first);
+        ++w;
+        w += tinystl::bitset_find_word(words_.data() + w, words_.size() - w, 0);
+        if (w == words_.size())
+            return npos;
+        return w * bits_per_word + tinystl::bitset_ctz(words_[w]);
+    }
+
+    // overload operators
+    inline dynamic_bitset operator&(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp &= rhs;
+        return tmp;
+    }
+
+    inline dynamic_bitset operator|(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp |= rhs;
+        return tmp;
+    }
+
+    inline dynamic_bitset operator^(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp ^= rhs;
+        return tmp;
+    }
+
+    inline dynamic_bitset operator-(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(lhs);
+        tmp -= rhs;
+        return tmp;
+    }
+
+    // overload tinystl's swap
+    inline void swap(dynamic_bitset& lhs, dynamic_bitset& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    //===================================================================================
+    // count / find on bit iterators, see algo.h for the generic versions
+    //===================================================================================
+
+    // bitset_count_ones
+    // Number of set bits in the n bits starting at (p, offset)
+    inline size_t bitset_count_ones(const bitset_word* p, unsigned offset, size_t n) noexcept
+    {
+        size_t ones = 0;
+        if (offset != 0 && n != 0)
+        {
+            const size_t take = tinystl::min(n, bitset_word_bits - offset);
+            ones += bitset_popcount((*p >> offset) & bitset_low_mask(take));
+            n -= take;
+            ++p;
+        }
+        ones += bitset_count_words(p, n / bitset_word_bits);
+        p += n / bitset_word_bits;
+        if (n % bitset_word_bits != 0)
+            ones += bitset_popcount(*p & bitset_low_mask(n % bitset_word_bits));
+        return ones;
+    }
+
+    // bitset_find_bit
+    // Index of the first bit equal to value in the n bits starting at (p, offset),
+    // n if there is none
+    inline size_t bitset_find_bit(const bitset_word* p, unsigned offset, size_t n,
+                                  bool value) noexcept
+    {
+        const bitset_word flip = value ? 0 : ~bitset_word(0);
+        size_t i = 0;
+        if (offset != 0 && n != 0)
+        {
+            const size_t take = tinystl::min(n, bitset_word_bits - offset);
+            const bitset_word w = ((*p ^ flip) >> offset) & bitset_low_mask(take);
+            if (w != 0)
+                return bitset_ctz(w);
+            i = take;
+            ++p;
+        }
+        const size_t full = (n - i) / bitset_word_bits;
+        const size_t k = bitset_find_word(p, full, flip);
+        if (k != full)
+            return i + k * bitset_word_bits + bitset_ctz(p[k] ^ flip);
+        i += full * bitset_word_bits;
+        p += full;
+        if (i != n)
+        {
+            const bitset_word w = (*p ^ flip) & bitset_low_mask(n - i);
+            if (w != 0)
+                return i + bitset_ctz(w);
+        }
+        return n;
+    }
+
+    template <class T>
+    size_t count(bit_const_iterator first, bit_const_iterator last, const T& value)
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t ones = tinystl::bitset_count_ones(first.p_, first.offset_, n);
+        return static_cast<bool>(value) ? ones : n - ones;
+    }
+
+    template <class T>
+    size_t count(bit_iterator first, bit_iterator last, const T& value)
+    {
+        return tinystl::count(bit_const_iterator(first), bit_const_iterator(last), value);
+    }
+
+    template <class T>
+    bit_const_iterator find(bit_const_iterator first, bit_const_iterator last, const T& value)
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        return first + static_cast<ptrdiff_t>(
+            tinystl::bitset_find_bit(first.p_, first.offset_, n, static_cast<bool>(value)));
+    }
+
+    template <class T>
+    bit_iterator find(bit_iterator first, bit_iterator last, const T& value)
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        return first + static_cast<ptrdiff_t>(
+            tinystl::bitset_find_bit(first.p_, first.offset_, n, static_cast<bool>(value)));
+    }
+
+} // namespace tinystl
+#endif
@@ -0,0 +1,245 @@
+#ifndef _EYTZINGER_INDEX_H_
+#define _EYTZINGER_INDEX_H_
+
+// eytzinger_index : a static sorted set of values in the Eytzinger (BFS) layout,
+//                   for lower_bound / upper_bound / find on data that never changes
+
+// notes:
+// A binary search over a sorted array looks at a[n/2], then a[n/4] or a[3n/4], ...
+// the first few probes of every search hit the same hot elements, but they are far apart,
+// and every later probe is a cache miss on a line that only holds one useful element.
+// The Eytzinger layout stores the implicit binary search tree in breadth-first order:
+//   node k (1-based) has children 2k and 2k + 1, the root is node 1
+// so the top levels of the tree share a few cache lines that stay hot,
+// and the search is the branchless loop
+//   k = 2k + (node k < value)
+// whose next addresses can be computed ahead: the 2^d descendants of node k that are d levels
+// down are the contiguous nodes [k * 2^d, k * 2^d + 2^d), one cache line when 2^d elements
+// fill a line, so every step prefetches the line it needs d steps later.
+// At the end, the answer is found from k by dropping the trailing ones and one more bit
+// (the last time the search went left).
+//
+// The values are given sorted once, in the constructor or assign(), there is no insert / erase.
+// It is a set: equivalent values given more than once are kept once (the first one).
+// Data node k is data()[k - 1], begin() / end() walk the values in that (BFS) order,
+// not in sorted order. lower_bound / upper_bound / find return end() when there is no answer.
+
+#include <initializer_list>
+
+#include "functional.h"
+#include "algo.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tinystl
+{
+    // number of trailing zero bits of x, x must not be zero
+    inline size_t eytzinger_ctz(size_t x) noexcept
+    {
+        TINYSTL_DEBUG(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(static_cast<unsigned long long>(x)));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, static_cast<unsigned __int64>(x));
+        return static_cast<size_t>(index);
+#else
+        size_t n = 0;
+        while ((x & 1) == 0)
+        {
+            x >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    // the largest power of two <= n, n > 0
+    constexpr size_t eytzinger_floor_pow2(size_t n, size_t p = 1)
+    {
+        return p * 2 > n ? p : eytzinger_floor_pow2(n, p * 2);
+    }
+
+    template <class T, class Compare = tinystl::less<T>>
+    class eytzinger_index
+    {
+    public:
+        typedef T               value_type;
+        typedef Compare         value_compare;
+        typedef const T*        const_pointer;
+        typedef const T&        const_reference;
+        typedef const T*        const_iterator;
+        typedef const_iterator  iterator;
+        typedef size_t          size_type;
+        typedef ptrdiff_t       difference_type;
+
+        // nodes per 64-byte cache line (a power of two, at least 2):
+        // the search prefetches node k * prefetch_stride, log2(prefetch_stride) levels ahead
+        static constexpr size_type prefetch_stride =
+            sizeof(T) * 2 > 64 ? 2 : eytzinger_floor_pow2(64 / sizeof(T));
+
+    private:
+        tinystl::vector<T> data_;  // data_[k - 1] is the node k
+        value_compare      comp_;
+
+    public:
+        // constructor, [first, last) must be sorted by comp
+        eytzinger_index() = default;
+
+        explicit eytzinger_index(const value_compare& comp) :data_(), comp_(comp) {}
+
+        template <class InputIter>
+        eytzinger_index(InputIter first, InputIter last, const value_compare& comp = value_compare())
+            :data_(), comp_(comp)
+        {
+            assign(first, last);
+        }
+
+        eytzinger_index(std::initializer_list<value_type> ilist)
+            :data_(), comp_()
+        {
+            assign(ilist.begin(), ilist.end());
+        }
+
+        template <class InputIter>
+        void assign(InputIter first, InputIter last);
+
+        // iterator, in the BFS order of the nodes
+        const_iterator begin() const noexcept { return data_.begin(); }
+        const_iterator end()   const noexcept { return data_.end(); }
+        const_pointer  data()  const noexcept { return data_.data(); }
+
+        // capacity
+        bool      empty() const noexcept { return data_.empty(); }
+        size_type size()  const noexcept { return data_.size(); }
+
+        value_compare value_comp() const { return comp_; }
+
+        // the first value that is not less than value
+        const_iterator lower_bound(const value_type& value) const
+        {
+            return node_to_iterator(search(value, [this](const T& node, const T& v)
+                                           { return comp_(node, v); }));
+        }
+
+        // the first value that is greater than value
+        const_iterator upper_bound(const value_type& value) const
+        {
+            return node_to_iterator(search(value, [this](const T& node, const T& v)
+                                           { return !comp_(v, node); }));
+        }
+
+        const_iterator find(const value_type& value) const
+        {
+            const_iterator it = lower_bound(value);
+            return (it == end() || comp_(value, *it)) ? end() : it;
+        }
+
+        bool contains(const value_type& value) const
+        { return find(value) != end(); }
+
+        size_type count(const value_type& value) const
+        { return contains(value) ? 1 : 0; }
+
+        void swap(eytzinger_index& rhs) noexcept
+        {
+            data_.swap(rhs.data_);
+            tinystl::swap(comp_, rhs.comp_);
+        }
+
+    private:
+        // go down from the root, right while go_right(node, value), left otherwise,
+        // return the node where the search last went left (0 if it never did)
+        template <class GoRight>
+        size_type search(const value_type& value, GoRight go_right) const
+        {
+            const size_type n = data_.size();
+            const T* base = data_.data();
+            size_type k = 1;
+            while (k <= n)
+            {
+                if (k * prefetch_stride <= n)
+                    TINYSTL_PREFETCH(base + k * prefetch_stride - 1);
+                k = 2 * k + (go_right(base[k - 1], value) ? 1 : 0);
+            }
+            // k went right (bit 1) since the last left turn (bit 0): drop those bits and that one
+            k >>= eytzinger_ctz(~k) + 1;
+            return k;
+        }
+
+        const_iterator node_to_iterator(size_type k) const
+        {
+            return k == 0 ? end() : data_.data() + (k - 1);
+        }
+    };
+
+    template <class T, class Compare>
+    constexpr typename eytzinger_index<T, Compare>::size_type eytzinger_index<T, Compare>::prefetch_stride;
+
+    /*****************************************************************************************/
+
+    // assign
+    // the i-th node of an in-order walk of the implicit tree gets the i-th smallest value
+    template <class T, class Compare>
+    template <class InputIter>
+    void eytzinger_index<T, Compare>::assign(InputIter first, InputIter last)
+    {
+        tinystl::vector<T> sorted(first, last);
+        for (size_type i = 1; i < sorted.size(); ++i)
+            TINYSTL_DEBUG(!comp_(sorted[i], sorted[i - 1]));
+
+        // keep the first of each run of equivalent values, so count() is 0 or 1
+        size_type u = 0;
+        for (size_type i = 0; i < sorted.size(); ++i)
+        {
+            if (u != 0 && !comp_(sorted[u - 1], sorted[i]))
+                continue;
+            if (u != i)
+                sorted[u] = tinystl::move(sorted[i]);
+            ++u;
+        }
+        sorted.erase(sorted.begin() + u, sorted.end());
+        const size_type n = sorted.size();
+
+        // rank[k] = position of node k in sorted order
+        tinystl::vector<size_type> rank(n + 1, 0);
+        size_type k = 1;
+        while (2 * k <= n)
+            k *= 2;
+        for (size_type i = 0; i < n; ++i)
+        {
+            rank[k] = i;
+            // in-order successor: leftmost node of the right subtree,
+            // or the first ancestor of which k is in the left subtree
+            if (2 * k + 1 <= n)
+            {
+                k = 2 * k + 1;
+                while (2 * k <= n)
+                    k *= 2;
+            }
+            else
+            {
+                k >>= eytzinger_ctz(~k) + 1;
+            }
+        }
+
+        tinystl::vector<T> nodes;
+        nodes.reserve(n);
+        for (k = 1; k <= n; ++k)
+            nodes.push_back(tinystl::move(sorted[rank[k]]));
+        data_.swap(nodes);
+    }
+
+    // overloaded swap
+    template <class T, class Compare>
+    void swap(eytzinger_index<T, Compare>& lhs, eytzinger_index<T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_EYTZINGER_INDEX_H_
@@ -0,0 +1,570 @@
+#ifndef _FLAT_MAP_H_
+#define _FLAT_MAP_H_
+
+// flat_map      : map kept as a sorted vector of pair<Key, T>, the keys are unique
+// flat_multimap : flat_map that allows equivalent keys
+
+// notes:
+// Same interface as map / multimap, but the elements are stored in one sorted tinystl::vector
+// (see flat_tree.h): smaller and faster to search and to scan,
+// but a single insert / erase is O(n) and may invalidate every iterator.
+// Build it in one go with the range constructor / insert(first, last),
+// or insert(sorted_unique, first, last) when the range is already sorted and unique.
+//
+// value_type is pair<Key, T>, the mapped value can be changed through an iterator,
+// the key must not be.
+//
+// Exception guarantees:
+// tinystl::flat_map<Key, T> / tinystl::flat_multimap<Key, T>
+// Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace
+//   * insert of one element
+
+#include "flat_tree.h"
+
+namespace tinystl
+{
+    //======================================================================================
+    // flat_map
+    // first parameter: key type
+    // second parameter: mapped type
+    // third parameter: key comparison, default: tinystl::less
+    template <class Key, class T, class Compare = tinystl::less<Key>>
+    class flat_map
+    {
+    public:
+        typedef Key                        key_type;
+        typedef T                          mapped_type;
+        typedef tinystl::pair<Key, T>      value_type;
+        typedef Compare                    key_compare;
+
+        // functor for comparing elements
+        class value_compare : public binary_function<value_type, value_type, bool>
+        {
+            friend class flat_map<Key, T, Compare>;
+        private:
+            Compare comp;
+            value_compare(Compare c) : comp(c) {}
+        public:
+            bool operator()(const value_type& lhs, const value_type& rhs) const
+            {
+                return comp(lhs.first, rhs.first);
+            }
+        };
+
+    private:
+        typedef tinystl::flat_tree<value_type, key_compare>  base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::container_type         container_type;
+        typedef typename base_type::pointer                pointer;
+        typedef typename base_type::const_pointer          const_pointer;
+        typedef typename base_type::reference              reference;
+        typedef typename base_type::const_reference        const_reference;
+        typedef typename base_type::iterator               iterator;
+        typedef typename base_type::const_iterator         const_iterator;
+        typedef typename base_type::reverse_iterator       reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::size_type              size_type;
+        typedef typename base_type::difference_type        difference_type;
+        typedef typename base_type::allocator_type         allocator_type;
+
+    public:
+        // constructor
+        flat_map() = default;
+
+        template <class InputIterator>
+        flat_map(InputIterator first, InputIterator last): tree_()
+        { tree_.insert_unique(first, last); }
+
+        template <class InputIterator>
+        flat_map(sorted_unique_t, InputIterator first, InputIterator last): tree_()
+        { tree_.insert_unique(sorted_unique, first, last); }
+
+        flat_map(std::initializer_list<value_type> ilist): tree_()
+        { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+        flat_map(const flat_map& rhs) = default;
+        flat_map(flat_map&& rhs) noexcept: tree_(tinystl::move(rhs.tree_))
+        {}
+
+        flat_map& operator=(const flat_map& rhs) = default;
+        flat_map& operator=(flat_map&& rhs) noexcept
+        {
+            tree_ = tinystl::move(rhs.tree_);
+            return *this;
+        }
+        flat_map& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // interface
+        key_compare key_comp() const
+        { return tree_.key_comp(); }
+
+        value_compare value_comp() const
+        { return value_compare(tree_.key_comp()); }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+        // the sorted elements
+        const container_type& container() const noexcept
+        { return tree_.container(); }
+
+        // iterator related operations
+        iterator begin() noexcept
+        { return tree_.begin(); }
+
+        const_iterator begin() const noexcept
+        { return tree_.begin(); }
+
+        iterator end() noexcept
+        { return tree_.end(); }
+
+        const_iterator end() const noexcept
+        { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return tree_.empty(); }
+
+        size_type size() const noexcept
+        { return tree_.size(); }
+
+        size_type max_size() const noexcept
+        { return tree_.max_size(); }
+
+        size_type capacity() const noexcept
+        { return tree_.capacity(); }
+
+        void reserve(size_type n)
+        { tree_.reserve(n); }
+
+        void shrink_to_fit()
+        { tree_.shrink_to_fit(); }
+
+        // access elements
+        mapped_type& at(const key_type& key)
+        {
+            iterator it = tree_.find(key);
+            THROW_OUT_OF_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+            return it->second;
+        }
+        const mapped_type& at(const key_type& key) const
+        {
+            const_iterator it = tree_.find(key);
+            THROW_OUT_OF_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key)
+        {
+            iterator it = lower_bound(key);
+            // it->first >= key
+            if (it == end() || key_comp()(key, it->first))
+                it = tree_.emplace_at(it, key, T{});
+            return it->second;
+        }
+        mapped_type& operator[](key_type&& key)
+        {
+            iterator it = lower_bound(key);
+            // it->first >= key
+            if (it == end() || key_comp()(key, it->first))
+                it = tree_.emplace_at(it, tinystl::move(key), T{});
+            return it->second;
+        }
+
+        // insert / erase
+        template <class ...Args>
+        pair<iterator, bool> emplace(Args&& ...args)
+        { return tree_.emplace_unique(tinystl::forward<Args>(args)...); }
+
+        pair<iterator, bool> insert(const value_type& value)
+        { return tree_.insert_unique(value); }
+
+        pair<iterator, bool> insert(value_type&& value)
+        { return tree_.insert_unique(tinystl::move(value)); }
+
+        // sorts and deduplicates the range once, the first of equivalent keys is kept
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        { tree_.insert_unique(first, last); }
+
+        // the range is already sorted and unique
+        template <class InputIterator>
+        void insert(sorted_unique_t, InputIterator first, InputIterator last)
+        { tree_.insert_unique(sorted_unique, first, last); }
+
+        iterator erase(const_iterator position)
+        { return tree_.erase(position); }
+
+        size_type erase(const key_type& key)
+        { return tree_.erase_unique(key); }
+
+        iterator erase(const_iterator first, const_iterator last)
+        { return tree_.erase(first, last); }
+
+        void clear()
+        { tree_.clear(); }
+
+        // map related operations
+        iterator find(const key_type& key)
+        { return tree_.find(key); }
+
+        const_iterator find(const key_type& key) const
+        { return tree_.find(key); }
+
+        size_type count(const key_type& key) const
+        { return tree_.count_unique(key); }
+
+        bool contains(const key_type& key) const
+        { return tree_.find(key) != tree_.end(); }
+
+        iterator lower_bound(const key_type& key)
+        { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type& key) const
+        { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key)
+        { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type& key) const
+        { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key)
+        { return tree_.equal_range_unique(key); }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        { return tree_.equal_range_unique(key); }
+
+        void swap(flat_map& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+        { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator< (const flat_map& lhs, const flat_map& rhs)
+        { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // overloaded operators
+    template <class Key, class T, class Compare>
+    bool operator!=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class T, class Compare>
+    bool operator>(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class Key, class T, class Compare>
+    bool operator<=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class Key, class T, class Compare>
+    bool operator>=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overloaded swap
+    template <class Key, class T, class Compare>
+    void swap(flat_map<Key, T, Compare>& lhs, flat_map<Key, T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    //======================================================================================
+    // flat_multimap
+    // first parameter: key type
+    // second parameter: mapped type
+    // third parameter: key comparison, default: tinystl::less
+    template <class Key, class T, class Compare = tinystl::less<Key>>
+    class flat_multimap
+    {
+    public:
+        typedef Key                        key_type;
+        typedef T                          mapped_type;
+        typedef tinystl::pair<Key, T>      value_type;
+        typedef Compare                    key_compare;
+
+        // functor for comparing elements
+        class value_compare : public binary_function<value_type, value_type, bool>
+        {
+            friend class flat_multimap<Key, T, Compare>;
+        private:
+            Compare comp;
+            value_compare(Compare c) : comp(c) {}
+        public:
+            bool operator()(const value_type& lhs, const value_type& rhs) const
+            {
+                return comp(lhs.first, rhs.first);
+            }
+        };
+
+    private:
+        typedef tinystl::flat_tree<value_type, key_compare>  base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::container_type         container_type;
+        typedef typename base_type::pointer                pointer;
+        typedef typename base_type::const_pointer          const_pointer;
+        typedef typename base_type::reference              reference;
+        typedef typename base_type::const_reference        const_reference;
+        typedef typename base_type::iterator               iterator;
+        typedef typename base_type::const_iterator         const_iterator;
+        typedef typename base_type::reverse_iterator       reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::size_type              size_type;
+        typedef typename base_type::difference_type        difference_type;
+        typedef typename base_type::allocator_type         allocator_type;
+
+    public:
+        // constructor
+        flat_multimap() = default;
+
+        template <class InputIterator>
+        flat_multimap(InputIterator first, InputIterator last): tree_()
+        { tree_.insert_multi(first, last); }
+
+        template <class InputIterator>
+        flat_multimap(sorted_equivalent_t, InputIterator first, InputIterator last): tree_()
+        { tree_.insert_multi(sorted_equivalent, first, last); }
+
+        flat_multimap(std::initializer_list<value_type> ilist): tree_()
+        { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+        flat_multimap(const flat_multimap& rhs) = default;
+        flat_multimap(flat_multimap&& rhs) noexcept: tree_(tinystl::move(rhs.tree_))
+        {}
+
+        flat_multimap& operator=(const flat_multimap& rhs) = default;
+        flat_multimap& operator=(flat_multimap&& rhs) noexcept
+        {
+            tree_ = tinystl::move(rhs.tree_);
+            return *this;
+        }
+        flat_multimap& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // interface
+        key_compare key_comp() const
+        { return tree_.key_comp(); }
+
+        value_compare value_comp() const
+        { return value_compare(tree_.key_comp()); }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+        // the sorted elements
+        const container_type& container() const noexcept
+        { return tree_.container(); }
+
+        // iterator related operations
+        iterator begin() noexcept
+        { return tree_.begin(); }
+
+        const_iterator begin() const noexcept
+        { return tree_.begin(); }
+
+        iterator end() noexcept
+        { return tree_.end(); }
+
+        const_iterator end() const noexcept
+        { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return tree_.empty(); }
+
+        size_type size() const noexcept
+        { return tree_.size(); }
+
+        size_type max_size() const noexcept
+        { return tree_.max_size(); }
+
+        size_type capacity() const noexcept
+        { return tree_.capacity(); }
+
+        void reserve(size_type n)
+        { tree_.reserve(n); }
+
+        void shrink_to_fit()
+        { tree_.shrink_to_fit(); }
+
+        // insert / erase
+        template <class ...Args>
+        iterator emplace(Args&& ...args)
+        { return tree_.emplace_multi(tinystl::forward<Args>(args)...); }
+
+        iterator insert(const value_type& value)
+        { return tree_.insert_multi(value); }
+
+        iterator insert(value_type&& value)
+        { return tree_.insert_multi(tinystl::move(value)); }
+
+        // sorts the range once, equivalent keys keep their order after the old ones
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        { tree_.insert_multi(first, last); }
+
+        // the range is already sorted
+        template <class InputIterator>
+        void insert(sorted_equivalent_t, InputIterator first, InputIterator last)
+        { tree_.insert_multi(sorted_equivalent, first, last); }
+
+        iterator erase(const_iterator position)
+        { return tree_.erase(position); }
+
+        size_type erase(const key_type& key)
+        { return tree_.erase_multi(key); }
+
+        iterator erase(const_iterator first, const_iterator last)
+        { return tree_.erase(first, last); }
+
+        void clear()
+        { tree_.clear(); }
+
+        // multimap related operations
+        iterator find(const key_type& key)
+        { return tree_.find(key); }
+
+        const_iterator find(const key_type& key) const
+        { return tree_.find(key); }
+
+        size_type count(const key_type& key) const
+        { return tree_.count_multi(key); }
+
+        bool contains(const key_type& key) const
+        { return tree_.find(key) != tree_.end(); }
+
+        iterator lower_bound(const key_type& key)
+        { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type& key) const
+        { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key)
+        { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type& key) const
+        { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key)
+        { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        { return tree_.equal_range_multi(key); }
+
+        void swap(flat_multimap& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const flat_multimap& lhs, const flat_multimap& rhs)
+        { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator< (const flat_multimap& lhs, const flat_multimap& rhs)
+        { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // overloaded operators
+    template <class Key, class T, class Compare>
+    bool operator!=(const flat_multimap<Key, T, Compare>& lhs, const flat_multimap<Key, T, Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class T, class Compare>
+    bool operator>(const flat_multimap<Key, T, Compare>& lhs, const flat_multimap<Key, T, Compare>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class Key, class T, class Compare>
+    bool operator<=(const flat_multimap<Key, T, Compare>& lhs, const flat_multimap<Key, T, Compare>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class Key, class T, class Compare>
+    bool operator>=(const flat_multimap<Key, T, Compare>& lhs, const flat_multimap<Key, T, Compare>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overloaded swap
+    template <class Key, class T, class Compare>
+    void swap(flat_multimap<Key, T, Compare>& lhs, flat_multimap<Key, T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_FLAT_MAP_H_
@@ -0,0 +1,476 @@
+#ifndef _FLAT_SET_H_
+#define _FLAT_SET_H_
+
+// flat_set      : set kept as a sorted vector, the keys are unique
+// flat_multiset : flat_set that allows equivalent keys
+
+// notes:
+// Same interface as set / multiset, but the elements are stored in one sorted tinystl::vector
+// (see flat_tree.h): smaller and faster to search and to scan,
+// but a single insert / erase is O(n) and may invalidate every iterator.
+// Build it in one go with the range constructor / insert(first, last),
+// or insert(sorted_unique, first, last) when the range is already sorted and unique.
+//
+// Exception guarantees:
+// tinystl::flat_set<Key> / tinystl::flat_multiset<Key>
+// Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace
+//   * insert of one element
+
+#include "flat_tree.h"
+
+namespace tinystl
+{
+    //======================================================================================
+    // flat_set
+    // first parameter: key type
+    // second parameter: key comparison, default: tinystl::less
+    template <class Key, class Compare = tinystl::less<Key>>
+    class flat_set
+    {
+    public:
+        typedef Key        key_type;
+        typedef Key        value_type;
+        typedef Compare    key_compare;
+        typedef Compare    value_compare;
+
+    private:
+        typedef tinystl::flat_tree<value_type, key_compare>  base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::container_type         container_type;
+
+        typedef typename base_type::const_pointer          pointer;
+        typedef typename base_type::const_pointer          const_pointer;
+
+        typedef typename base_type::const_reference        reference;
+        typedef typename base_type::const_reference        const_reference;
+
+        typedef typename base_type::const_iterator         iterator;
+        typedef typename base_type::const_iterator         const_iterator;
+
+        typedef typename base_type::const_reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+
+        typedef typename base_type::size_type              size_type;
+        typedef typename base_type::difference_type        difference_type;
+        typedef typename base_type::allocator_type         allocator_type;
+
+    public:
+        // constructor
+        flat_set() = default;
+
+        template <class InputIterator>
+        flat_set(InputIterator first, InputIterator last): tree_()
+        { tree_.insert_unique(first, last); }
+
+        template <class InputIterator>
+        flat_set(sorted_unique_t, InputIterator first, InputIterator last): tree_()
+        { tree_.insert_unique(sorted_unique, first, last); }
+
+        flat_set(std::initializer_list<value_type> ilist): tree_()
+        { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+        flat_set(const flat_set& rhs) = default;
+        flat_set(flat_set&& rhs) noexcept: tree_(tinystl::move(rhs.tree_))
+        {}
+
+        flat_set& operator=(const flat_set& rhs) = default;
+        flat_set& operator=(flat_set&& rhs) noexcept
+        {
+            tree_ = tinystl::move(rhs.tree_);
+            return *this;
+        }
+        flat_set& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // interface
+        key_compare key_comp() const
+        { return tree_.key_comp(); }
+
+        value_compare value_comp() const
+        { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+        // the sorted keys
+        const container_type& container() const noexcept
+        { return tree_.container(); }
+
+        // iterator related operations
+        const_iterator begin() const noexcept
+        { return tree_.begin(); }
+
+        const_iterator end() const noexcept
+        { return tree_.end(); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return tree_.empty(); }
+
+        size_type size() const noexcept
+        { return tree_.size(); }
+
+        size_type max_size() const noexcept
+        { return tree_.max_size(); }
+
+        size_type capacity() const noexcept
+        { return tree_.capacity(); }
+
+        void reserve(size_type n)
+        { tree_.reserve(n); }
+
+        void shrink_to_fit()
+        { tree_.shrink_to_fit(); }
+
+        // insert / erase
+        template <class ...Args>
+        pair<iterator, bool> emplace(Args&& ...args)
+        {
+            auto p = tree_.emplace_unique(tinystl::forward<Args>(args)...);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+
+        pair<iterator, bool> insert(const value_type& value)
+        {
+            auto p = tree_.insert_unique(value);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        pair<iterator, bool> insert(value_type&& value)
+        {
+            auto p = tree_.insert_unique(tinystl::move(value));
+            return pair<iterator, bool>(p.first, p.second);
+        }
+
+        // sorts and deduplicates the range once
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        { tree_.insert_unique(first, last); }
+
+        // the range is already sorted and unique
+        template <class InputIterator>
+        void insert(sorted_unique_t, InputIterator first, InputIterator last)
+        { tree_.insert_unique(sorted_unique, first, last); }
+
+        iterator erase(const_iterator position)
+        { return tree_.erase(position); }
+
+        size_type erase(const key_type& key)
+        { return tree_.erase_unique(key); }
+
+        iterator erase(const_iterator first, const_iterator last)
+        { return tree_.erase(first, last); }
+
+        void clear()
+        { tree_.clear(); }
+
+        // set related operations
+        const_iterator find(const key_type& key) const
+        { return tree_.find(key); }
+
+        size_type count(const key_type& key) const
+        { return tree_.count_unique(key); }
+
+        bool contains(const key_type& key) const
+        { return tree_.find(key) != tree_.end(); }
+
+        const_iterator lower_bound(const key_type& key) const
+        { return tree_.lower_bound(key); }
+
+        const_iterator upper_bound(const key_type& key) const
+        { return tree_.upper_bound(key); }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        { return tree_.equal_range_unique(key); }
+
+        void swap(flat_set& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+        { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator< (const flat_set& lhs, const flat_set& rhs)
+        { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // overloaded operators
+    template <class Key, class Compare>
+    bool operator!=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class Compare>
+    bool operator>(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class Key, class Compare>
+    bool operator<=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class Key, class Compare>
+    bool operator>=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overloaded swap
+    template <class Key, class Compare>
+    void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    //======================================================================================
+    // flat_multiset
+    // first parameter: key type
+    // second parameter: key comparison, default: tinystl::less
+    template <class Key, class Compare = tinystl::less<Key>>
+    class flat_multiset
+    {
+    public:
+        typedef Key        key_type;
+        typedef Key        value_type;
+        typedef Compare    key_compare;
+        typedef Compare    value_compare;
+
+    private:
+        typedef tinystl::flat_tree<value_type, key_compare>  base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::container_type         container_type;
+
+        typedef typename base_type::const_pointer          pointer;
+        typedef typename base_type::const_pointer          const_pointer;
+
+        typedef typename base_type::const_reference        reference;
+        typedef typename base_type::const_reference        const_reference;
+
+        typedef typename base_type::const_iterator         iterator;
+        typedef typename base_type::const_iterator         const_iterator;
+
+        typedef typename base_type::const_reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+
+        typedef typename base_type::size_type              size_type;
+        typedef typename base_type::difference_type        difference_type;
+        typedef typename base_type::allocator_type         allocator_type;
+
+    public:
+        // constructor
+        flat_multiset() = default;
+
+        template <class InputIterator>
+        flat_multiset(InputIterator first, InputIterator last): tree_()
+        { tree_.insert_multi(first, last); }
+
+        template <class InputIterator>
+        flat_multiset(sorted_equivalent_t, InputIterator first, InputIterator last): tree_()
+        { tree_.insert_multi(sorted_equivalent, first, last); }
+
+        flat_multiset(std::initializer_list<value_type> ilist): tree_()
+        { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+        flat_multiset(const flat_multiset& rhs) = default;
+        flat_multiset(flat_multiset&& rhs) noexcept: tree_(tinystl::move(rhs.tree_))
+        {}
+
+        flat_multiset& operator=(const flat_multiset& rhs) = default;
+        flat_multiset& operator=(flat_multiset&& rhs) noexcept
+        {
+            tree_ = tinystl::move(rhs.tree_);
+            return *this;
+        }
+        flat_multiset& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // interface
+        key_compare key_comp() const
+        { return tree_.key_comp(); }
+
+        value_compare value_comp() const
+        { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+        // the sorted keys
+        const container_type& container() const noexcept
+        { return tree_.container(); }
+
+        // iterator related operations
+        const_iterator begin() const noexcept
+        { return tree_.begin(); }
+
+        const_iterator end() const noexcept
+        { return tree_.end(); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return tree_.empty(); }
+
+        size_type size() const noexcept
+        { return tree_.size(); }
+
+        size_type max_size() const noexcept
+        { return tree_.max_size(); }
+
+        size_type capacity() const noexcept
+        { return tree_.capacity(); }
+
+        void reserve(size_type n)
+        { tree_.reserve(n); }
+
+        void shrink_to_fit()
+        { tree_.shrink_to_fit(); }
+
+        // insert / erase
+        template <class ...Args>
+        iterator emplace(Args&& ...args)
+        { return tree_.emplace_multi(tinystl::forward<Args>(args)...); }
+
+        iterator insert(const value_type& value)
+        { return tree_.insert_multi(value); }
+
+        iterator insert(value_type&& value)
+        { return tree_.insert_multi(tinystl::move(value)); }
+
+        // sorts the range once, equivalent keys keep their order after the old ones
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        { tree_.insert_multi(first, last); }
+
+        // the range is already sorted
+        template <class InputIterator>
+        void insert(sorted_equivalent_t, InputIterator first, InputIterator last)
+        { tree_.insert_multi(sorted_equivalent, first, last); }
+
+        iterator erase(const_iterator position)
+        { return tree_.erase(position); }
+
+        size_type erase(const key_type& key)
+        { return tree_.erase_multi(key); }
+
+        iterator erase(const_iterator first, const_iterator last)
+        { return tree_.erase(first, last); }
+
+        void clear()
+        { tree_.clear(); }
+
+        // multiset related operations
+        const_iterator find(const key_type& key) const
+        { return tree_.find(key); }
+
+        size_type count(const key_type& key) const
+        { return tree_.count_multi(key); }
+
+        bool contains(const key_type& key) const
+        { return tree_.find(key) != tree_.end(); }
+
+        const_iterator lower_bound(const key_type& key) const
+        { return tree_.lower_bound(key); }
+
+        const_iterator upper_bound(const key_type& key) const
+        { return tree_.upper_bound(key); }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        { return tree_.equal_range_multi(key); }
+
+        void swap(flat_multiset& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const flat_multiset& lhs, const flat_multiset& rhs)
+        { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator< (const flat_multiset& lhs, const flat_multiset& rhs)
+        { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // overloaded operators
+    template <class Key, class Compare>
+    bool operator!=(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class Compare>
+    bool operator>(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class Key, class Compare>
+    bool operator<=(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class Key, class Compare>
+    bool operator>=(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overloaded swap
+    template <class Key, class Compare>
+    void swap(flat_multiset<Key, Compare>& lhs, flat_multiset<Key, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_FLAT_SET_H_
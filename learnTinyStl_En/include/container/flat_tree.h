@@ -0,0 +1,540 @@
+#ifndef _FLAT_TREE_H_
+#define _FLAT_TREE_H_
+
+// flat_tree : the sorted vector behind flat_set / flat_multiset / flat_map / flat_multimap
+
+// notes:
+// The elements are kept sorted by key in one tinystl::vector, there is no node per element:
+//   * lookups are a binary search (tinystl::lower_bound / upper_bound of algo.h) over
+//     contiguous memory, no pointer chasing, and a scan is a plain array scan
+//   * an element takes sizeof(value_type), an rb_tree node adds three pointers and a color
+//   * a single insert / erase moves the elements behind it, O(n)
+// So it is for tables that are built once (or rarely) and then read a lot.
+// Build them with the range insert / constructor: the new elements are appended,
+// sorted and deduplicated once and merged with the old ones, O(n + m log m) for m new elements,
+// instead of m single inserts, O(n * m).
+// When the range is already sorted (and unique), pass sorted_unique (sorted_equivalent),
+// the sort is skipped.
+//
+// Iterators are vector iterators: any insert / erase may invalidate all of them.
+//
+// The value_type of a map is pair<Key, T> (not pair<const Key, T>, the elements are moved around
+// in the vector), do not change the key through an iterator.
+
+// Exception guarantees:
+// tinystl::flat_tree<T, Compare>
+// Satisfy the basic exception guarantee
+// (a range insert that throws leaves the tree empty),
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace_unique / emplace_multi
+//   * insert_unique / insert_multi of one element
+
+#include <initializer_list>
+
+#include "functional.h"
+#include "iterator.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+#include "algo.h"
+#include "vector.h"
+
+namespace tinystl
+{
+    // the range is sorted and has no equivalent keys
+    struct sorted_unique_t
+    {
+        explicit sorted_unique_t() = default;
+    };
+
+    constexpr sorted_unique_t sorted_unique{};
+
+    // the range is sorted, equivalent keys are allowed
+    struct sorted_equivalent_t
+    {
+        explicit sorted_equivalent_t() = default;
+    };
+
+    constexpr sorted_equivalent_t sorted_equivalent{};
+
+    // key of an element: the element itself, or first for a pair
+    template <class T, bool>
+    struct flat_tree_value_traits_imp
+    {
+        typedef T   key_type;
+        typedef T   mapped_type;
+        typedef T   value_type;
+
+        static const key_type& get_key(const value_type& value)
+        { return value; }
+    };
+
+    template <class T>
+    struct flat_tree_value_traits_imp<T, true>
+    {
+        typedef typename std::remove_cv<typename T::first_type>::type   key_type;
+        typedef typename T::second_type                                 mapped_type;
+        typedef T                                                       value_type;
+
+        static const key_type& get_key(const value_type& value)
+        { return value.first; }
+    };
+
+    template <class T>
+    struct flat_tree_value_traits
+        : public flat_tree_value_traits_imp<T, tinystl::is_pair<T>::value>
+    {
+    };
+
+    //=========== flat_tree ===========================================================
+    template <class T, class Compare>
+    class flat_tree
+    {
+    public:
+        typedef flat_tree_value_traits<T>                   value_traits;
+
+        typedef typename value_traits::key_type             key_type;
+        typedef typename value_traits::mapped_type          mapped_type;
+        typedef typename value_traits::value_type           value_type;
+        typedef Compare                                     key_compare;
+
+        typedef tinystl::vector<T>                          container_type;
+        typedef typename container_type::allocator_type     allocator_type;
+        typedef typename container_type::pointer            pointer;
+        typedef typename container_type::const_pointer      const_pointer;
+        typedef typename container_type::reference          reference;
+        typedef typename container_type::const_reference    const_reference;
+        typedef typename container_type::size_type          size_type;
+        typedef typename container_type::difference_type    difference_type;
+
+        typedef typename container_type::iterator           iterator;
+        typedef typename container_type::const_iterator     const_iterator;
+        typedef tinystl::reverse_iterator<iterator>         reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+    private:
+        // compares elements and keys in any order, for lower_bound / upper_bound
+        struct key_less
+        {
+            key_compare comp;
+
+            explicit key_less(const key_compare& c) :comp(c) {}
+
+            template <class A, class B>
+            bool operator()(const A& a, const B& b) const
+            { return comp(key_of(a), key_of(b)); }
+        };
+
+        template <class U>
+        static const key_type& key_of(const U& u)
+        { return key_of(u, typename std::is_same<U, value_type>::type()); }
+
+        static const key_type& key_of(const value_type& value, std::true_type)
+        { return value_traits::get_key(value); }
+
+        static const key_type& key_of(const key_type& key, std::false_type)
+        { return key; }
+
+        container_type data_;
+        key_compare    comp_;
+
+    public:
+        // constructor, copy and move
+        flat_tree() :data_(), comp_() {}
+
+        explicit flat_tree(const key_compare& comp) :data_(), comp_(comp) {}
+
+        flat_tree(const flat_tree& rhs) = default;
+        flat_tree(flat_tree&& rhs) noexcept
+            :data_(tinystl::move(rhs.data_)), comp_(rhs.comp_) {}
+
+        flat_tree& operator=(const flat_tree& rhs) = default;
+        flat_tree& operator=(flat_tree&& rhs) noexcept
+        {
+            data_ = tinystl::move(rhs.data_);
+            comp_ = rhs.comp_;
+            return *this;
+        }
+
+        ~flat_tree() = default;
+
+    public:
+        // interface
+        key_compare    key_comp()      const { return comp_; }
+        allocator_type get_allocator() const { return data_.get_allocator(); }
+
+        // the sorted elements
+        const container_type& container() const noexcept { return data_; }
+
+        // iterator
+        iterator       begin()         noexcept { return data_.begin(); }
+        const_iterator begin()   const noexcept { return data_.begin(); }
+        iterator       end()           noexcept { return data_.end(); }
+        const_iterator end()     const noexcept { return data_.end(); }
+
+        reverse_iterator       rbegin()       noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()         noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()   const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend()   const noexcept { return rend(); }
+
+        // capacity
+        bool      empty()    const noexcept { return data_.empty(); }
+        size_type size()     const noexcept { return data_.size(); }
+        size_type max_size() const noexcept { return data_.max_size(); }
+        size_type capacity() const noexcept { return data_.capacity(); }
+
+        void reserve(size_type n) { data_.reserve(n); }
+        void shrink_to_fit()      { data_.shrink_to_fit(); }
+
+        // insert / erase
+        template <class ...Args>
+        tinystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+        {
+            value_type value(tinystl::forward<Args>(args)...);
+            return insert_unique(tinystl::move(value));
+        }
+
+        template <class ...Args>
+        iterator emplace_multi(Args&& ...args)
+        {
+            value_type value(tinystl::forward<Args>(args)...);
+            return insert_multi(tinystl::move(value));
+        }
+
+        tinystl::pair<iterator, bool> insert_unique(const value_type& value)
+        {
+            return insert_unique_value(value);
+        }
+        tinystl::pair<iterator, bool> insert_unique(value_type&& value)
+        {
+            return insert_unique_value(tinystl::move(value));
+        }
+
+        iterator insert_multi(const value_type& value)
+        {
+            return data_.insert(upper_bound(key_of(value)), value);
+        }
+        iterator insert_multi(value_type&& value)
+        {
+            const_iterator pos = upper_bound(key_of(value));
+            return data_.insert(pos, tinystl::move(value));
+        }
+
+        // pos must be where the new element belongs (e.g. lower_bound of its key)
+        template <class ...Args>
+        iterator emplace_at(const_iterator pos, Args&& ...args)
+        {
+            return data_.emplace(pos, tinystl::forward<Args>(args)...);
+        }
+
+        // bulk insert: append, sort and deduplicate the new elements once, merge
+        template <class InputIter>
+        void insert_unique(InputIter first, InputIter last)
+        {
+            const size_type old = data_.size();
+            data_.insert(data_.end(), first, last);
+            merge_tail(old, true, false);
+        }
+
+        template <class InputIter>
+        void insert_unique(sorted_unique_t, InputIter first, InputIter last)
+        {
+            const size_type old = data_.size();
+            data_.insert(data_.end(), first, last);
+            merge_tail(old, true, true);
+        }
+
+        template <class InputIter>
+        void insert_multi(InputIter first, InputIter last)
+        {
+            const size_type old = data_.size();
+            data_.insert(data_.end(), first, last);
+            merge_tail(old, false, false);
+        }
+
+        template <class InputIter>
+        void insert_multi(sorted_equivalent_t, InputIter first, InputIter last)
+        {
+            const size_type old = data_.size();
+            data_.insert(data_.end(), first, last);
+            merge_tail(old, false, true);
+        }
+
+        iterator erase(const_iterator pos)
+        { return data_.erase(pos); }
+
+        iterator erase(const_iterator first, const_iterator last)
+        { return data_.erase(first, last); }
+
+        size_type erase_unique(const key_type& key)
+        {
+            iterator it = find(key);
+            if (it == end())
+                return 0;
+            data_.erase(it);
+            return 1;
+        }
+
+        size_type erase_multi(const key_type& key)
+        {
+            auto p = equal_range_multi(key);
+            const size_type n = static_cast<size_type>(p.second - p.first);
+            data_.erase(p.first, p.second);
+            return n;
+        }
+
+        void clear() { data_.clear(); }
+
+        // lookup
+        iterator find(const key_type& key)
+        {
+            iterator it = lower_bound(key);
+            return (it == end() || comp_(key, key_of(*it))) ? end() : it;
+        }
+        const_iterator find(const key_type& key) const
+        {
+            const_iterator it = lower_bound(key);
+            return (it == end() || comp_(key, key_of(*it))) ? end() : it;
+        }
+
+        size_type count_unique(const key_type& key) const
+        { return find(key) != end() ? 1 : 0; }
+
+        size_type count_multi(const key_type& key) const
+        {
+            auto p = equal_range_multi(key);
+            return static_cast<size_type>(p.second - p.first);
+        }
+
+        iterator lower_bound(const key_type& key)
+        { return tinystl::lower_bound(begin(), end(), key, key_less(comp_)); }
+        const_iterator lower_bound(const key_type& key) const
+        { return tinystl::lower_bound(begin(), end(), key, key_less(comp_)); }
+
+        iterator upper_bound(const key_type& key)
+        { return tinystl::upper_bound(begin(), end(), key, key_less(comp_)); }
+        const_iterator upper_bound(const key_type& key) const
+        { return tinystl::upper_bound(begin(), end(), key, key_less(comp_)); }
+
+        tinystl::pair<iterator, iterator> equal_range_unique(const key_type& key)
+        {
+            iterator it = find(key);
+            return tinystl::pair<iterator, iterator>(it, it == end() ? it : it + 1);
+        }
+        tinystl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+        {
+            const_iterator it = find(key);
+            return tinystl::pair<const_iterator, const_iterator>(it, it == end() ? it : it + 1);
+        }
+
+        tinystl::pair<iterator, iterator> equal_range_multi(const key_type& key)
+        { return tinystl::equal_range(begin(), end(), key, key_less(comp_)); }
+        tinystl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+        { return tinystl::equal_range(begin(), end(), key, key_less(comp_)); }
+
+        void swap(flat_tree& rhs) noexcept
+        {
+            data_.swap(rhs.data_);
+            tinystl::swap(comp_, rhs.comp_);
+        }
+
+    private:
+        // helper functions
+        bool less(const value_type& a, const value_type& b) const
+        { return comp_(key_of(a), key_of(b)); }
+
+        template <class V>
+        tinystl::pair<iterator, bool> insert_unique_value(V&& value)
+        {
+            iterator pos = lower_bound(key_of(value));
+            if (pos != end() && !comp_(key_of(value), key_of(*pos)))
+                return tinystl::pair<iterator, bool>(pos, false);
+            return tinystl::pair<iterator, bool>(data_.insert(pos, tinystl::forward<V>(value)), true);
+        }
+
+        void insertion_sort(iterator first, iterator last);
+        void stable_sort(iterator first, iterator last);
+        iterator unique_keys(iterator first, iterator last);
+        void merge_tail(size_type old, bool unique, bool sorted);
+    };
+
+    /*****************************************************************************************/
+
+    // insertion_sort: stable, for the short runs of stable_sort
+    template <class T, class Compare>
+    void flat_tree<T, Compare>::insertion_sort(iterator first, iterator last)
+    {
+        if (first == last)
+            return;
+        for (iterator i = first + 1; i != last; ++i)
+        {
+            if (!less(*i, *(i - 1)))
+                continue;
+            value_type tmp = tinystl::move(*i);
+            iterator j = i;
+            do
+            {
+                *j = tinystl::move(*(j - 1));
+                --j;
+            } while (j != first && less(tmp, *(j - 1)));
+            *j = tinystl::move(tmp);
+        }
+    }
+
+    // stable_sort: insertion sort on runs of 16 elements, then bottom-up merge passes
+    // through a buffer, so equivalent keys keep their order (the first one is kept by unique_keys)
+    template <class T, class Compare>
+    void flat_tree<T, Compare>::stable_sort(iterator first, iterator last)
+    {
+        const size_type n = static_cast<size_type>(last - first);
+        const size_type run = 16;
+        for (size_type i = 0; i < n; i += run)
+            insertion_sort(first + i, first + (n - i < run ? n : i + run));
+        if (n <= run)
+            return;
+
+        container_type buf;
+        buf.reserve(n);
+        for (size_type width = run; width < n; width *= 2)
+        {
+            buf.clear();
+            for (size_type lo = 0; lo < n; lo += 2 * width)
+            {
+                iterator a = first + lo;
+                iterator a_end = first + (n - lo < width ? n : lo + width);
+                iterator b = a_end;
+                iterator b_end = first + (n - lo < 2 * width ? n : lo + 2 * width);
+                while (a != a_end && b != b_end)
+                {
+                    if (less(*b, *a))
+                        buf.emplace_back(tinystl::move(*b++));
+                    else
+                        buf.emplace_back(tinystl::move(*a++));
+                }
+                for (; a != a_end; ++a)
+                    buf.emplace_back(tinystl::move(*a));
+                for (; b != b_end; ++b)
+                    buf.emplace_back(tinystl::move(*b));
+            }
+            tinystl::move(buf.begin(), buf.end(), first);
+        }
+    }
+
+    // unique_keys: keep the first element of every run of equivalent keys, return the new end
+    template <class T, class Compare>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::unique_keys(iterator first, iterator last)
+    {
+        if (first == last)
+            return last;
+        iterator result = first;
+        while (++first != last)
+        {
+            if (less(*result, *first) && ++result != first)
+                *result = tinystl::move(*first);
+        }
+        return ++result;
+    }
+
+    // merge_tail: [0, old) is sorted, the elements appended after it are sorted (unless sorted)
+    // and merged into it. With unique, a key that is already there is not added again.
+    template <class T, class Compare>
+    void flat_tree<T, Compare>::merge_tail(size_type old, bool unique, bool sorted)
+    {
+        try
+        {
+            iterator mid = begin() + old;
+            if (!sorted)
+                stable_sort(mid, end());
+            if (unique)
+                data_.erase(unique_keys(mid, end()), end());
+#ifndef NDEBUG
+            for (iterator it = mid; it != end() && it + 1 != end(); ++it)
+                TINYSTL_DEBUG(unique ? less(*it, *(it + 1)) : !less(*(it + 1), *it));
+#endif
+            // nothing to merge: empty before, or every new key comes after the old ones
+            if (old == 0 || mid == end() ||
+                (unique ? less(*(mid - 1), *mid) : !less(*mid, *(mid - 1))))
+                return;
+
+            container_type buf;
+            buf.reserve(size());
+            iterator a = begin(), b = mid, b_end = end();
+            while (a != mid && b != b_end)
+            {
+                if (less(*b, *a))
+                {
+                    buf.emplace_back(tinystl::move(*b++));
+                }
+                else
+                {
+                    // the old element goes first, an equivalent new one is dropped for unique
+                    if (unique && !less(*a, *b))
+                        ++b;
+                    buf.emplace_back(tinystl::move(*a++));
+                }
+            }
+            for (; a != mid; ++a)
+                buf.emplace_back(tinystl::move(*a));
+            for (; b != b_end; ++b)
+                buf.emplace_back(tinystl::move(*b));
+            data_.swap(buf);
+        }
+        catch (...)
+        {
+            // the order may be broken half way
+            data_.clear();
+            throw;
+        }
+    }
+
+    // overloaded operators
+    template <class T, class Compare>
+    bool operator==(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs)
+    {
+        return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Compare>
+    bool operator<(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs)
+    {
+        return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, class Compare>
+    bool operator!=(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class Compare>
+    bool operator>(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, class Compare>
+    bool operator<=(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, class Compare>
+    bool operator>=(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overloaded swap
+    template <class T, class Compare>
+    void swap(flat_tree<T, Compare>& lhs, flat_tree<T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_FLAT_TREE_H_
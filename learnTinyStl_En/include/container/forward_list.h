@@ -0,0 +1,770 @@
+#ifndef _FORWARD_LIST_H_
+#define _FORWARD_LIST_H_
+
+// forward_list : singly linked list
+
+// notes:
+// A node holds one next pointer and the value, and the container holds only the
+// head node, it does not keep a size (there is no size(), as in std::forward_list).
+// On a 64-bit platform a forward_list<int> node is 16 bytes against 24 for list<int>,
+// and an empty forward_list is one pointer, without the sentinel node list allocates.
+//
+// merge / sort use list_chain_merge / list_chain_sort from list.h.
+//
+// tinystl::forward_list<T> Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace_front
+//   * emplace_after
+//   * push_front
+//   * insert_after
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "allocator.h"
+#include "list.h"
+
+namespace tinystl
+{
+
+    template <class T>
+    struct forward_list_node_base;
+
+    template <class T>
+    struct forward_list_node;
+
+    template <class T>
+    struct forward_list_node_traits
+    {
+        typedef forward_list_node_base<T>*  base_ptr;
+        typedef forward_list_node<T>*       node_ptr;
+    };
+
+    // forward_list node
+    template <class T>
+    struct forward_list_node_base
+    {
+        typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+        typedef typename forward_list_node_traits<T>::node_ptr node_ptr;
+
+        base_ptr next;  // next node
+
+        forward_list_node_base() = default;
+
+        node_ptr as_node()
+        {
+            return static_cast<node_ptr>(this);
+        }
+    };
+
+    template <class T>
+    struct forward_list_node : public forward_list_node_base<T>
+    {
+        T value;
+    };
+
+    // forward_list iterator-------------------------------------------------------------
+    template <class T>
+    struct forward_list_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, T>
+    {
+        typedef T                           value_type;
+        typedef T*                          pointer;
+        typedef T&                          reference;
+        typedef forward_list_iterator<T>    self;
+
+        typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+
+        base_ptr node_;  // point to the current node
+
+        forward_list_iterator() = default;
+        forward_list_iterator(base_ptr x) :node_(x)
+        {}
+
+        reference operator*() const
+        { return node_->as_node()->value; }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node_ != nullptr);
+            node_ = node_->next;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return node_ == rhs.node_; }
+
+        bool operator!=(const self& rhs) const
+        { return node_ != rhs.node_; }
+    };
+
+    // forward_list const iterator-------------------------------------------------------
+    template <class T>
+    struct forward_list_const_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, T>
+    {
+        typedef T                               value_type;
+        typedef const T*                        pointer;
+        typedef const T&                        reference;
+        typedef forward_list_const_iterator<T>  self;
+
+        typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+
+        base_ptr node_;
+
+        forward_list_const_iterator() = default;
+        forward_list_const_iterator(base_ptr x) :node_(x)
+        {}
+
+        forward_list_const_iterator(const forward_list_iterator<T>& rhs) :node_(rhs.node_)
+        {}
+
+        reference operator*() const
+        { return node_->as_node()->value; }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node_ != nullptr);
+            node_ = node_->next;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return node_ == rhs.node_; }
+
+        bool operator!=(const self& rhs) const
+        { return node_ != rhs.node_; }
+    };
+
+    //=================== forward_list template ==============================================
+    template <class T>
+    class forward_list
+    {
+    public:
+        // Nested typedefs for forward_list
+        typedef tinystl::allocator<T>                       allocator_type;
+        typedef tinystl::allocator<T>                       data_allocator;
+        typedef tinystl::allocator<forward_list_node<T>>    node_allocator;
+
+        typedef typename allocator_type::value_type         value_type;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+        typedef forward_list_iterator<T>                    iterator;
+        typedef forward_list_const_iterator<T>              const_iterator;
+
+        typedef typename forward_list_node_traits<T>::base_ptr  base_ptr;
+        typedef typename forward_list_node_traits<T>::node_ptr  node_ptr;
+
+        allocator_type get_allocator()
+        { return allocator_type(); }
+
+    private:
+        // head_.next is the first node, the last node points to nullptr
+        mutable forward_list_node_base<T> head_;
+
+    public:
+        //---------------------------------------------------------------------------------
+        // constructor
+        forward_list() noexcept
+        { head_.next = nullptr; }
+
+        explicit forward_list(size_type n)
+        {
+            head_.next = nullptr;
+            fill_insert_after(before_begin(), n, value_type());
+        }
+
+        forward_list(size_type n, const T& value)
+        {
+            head_.next = nullptr;
+            fill_insert_after(before_begin(), n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        forward_list(Iter first, Iter last)
+        {
+            head_.next = nullptr;
+            copy_insert_after(before_begin(), first, last);
+        }
+
+        forward_list(std::initializer_list<T> ilist)
+        {
+            head_.next = nullptr;
+            copy_insert_after(before_begin(), ilist.begin(), ilist.end());
+        }
+
+        forward_list(const forward_list& rhs)
+        {
+            head_.next = nullptr;
+            copy_insert_after(before_begin(), rhs.begin(), rhs.end());
+        }
+
+        // move constructor
+        forward_list(forward_list&& rhs) noexcept
+        {
+            head_.next = rhs.head_.next;
+            rhs.head_.next = nullptr;
+        }
+
+        // assignment operator overloaded function
+        forward_list& operator=(const forward_list& rhs)
+        {
+            if (this != &rhs)
+                assign(rhs.begin(), rhs.end());
+            return *this;
+        }
+
+        forward_list& operator=(forward_list&& rhs) noexcept
+        {
+            clear();
+            head_.next = rhs.head_.next;
+            rhs.head_.next = nullptr;
+            return *this;
+        }
+
+        forward_list& operator=(std::initializer_list<T> ilist)
+        {
+            forward_list tmp(ilist.begin(), ilist.end());
+            swap(tmp);
+            return *this;
+        }
+
+        ~forward_list()
+        { clear(); }
+
+    public:
+        // iterator operation----------------------------------------------------------------
+        // before_begin : the position before the first element, for insert_after / erase_after
+        iterator before_begin() noexcept
+        { return iterator(&head_); }
+
+        const_iterator before_begin() const noexcept
+        { return const_iterator(&head_); }
+
+        iterator begin() noexcept
+        { return iterator(head_.next); }
+
+        const_iterator begin() const noexcept
+        { return const_iterator(head_.next); }
+
+        iterator end() noexcept
+        { return iterator(nullptr); }
+
+        const_iterator end() const noexcept
+        { return const_iterator(nullptr); }
+
+        const_iterator cbefore_begin() const noexcept
+        { return before_begin(); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // container operation---------------------------------------------------------------
+        bool empty() const noexcept
+        { return head_.next == nullptr; }
+
+        size_type max_size() const noexcept
+        { return static_cast<size_type>(-1); }
+
+        // visit element---------------------------------------------------------------------
+        reference front()
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        const_reference front() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        // adjust container operation--------------------------------------------------------
+        // assign
+        void assign(size_type n, const value_type& value)
+        {
+            forward_list tmp(n, value);
+            swap(tmp);
+        }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        { copy_assign(first, last); }
+
+        void assign(std::initializer_list<T> ilist)
+        { copy_assign(ilist.begin(), ilist.end()); }
+
+        // emplace_front / emplace_after
+        template <class ...Args>
+        void emplace_front(Args&& ...args)
+        { emplace_after(before_begin(), tinystl::forward<Args>(args)...); }
+
+        template <class ...Args>
+        iterator emplace_after(const_iterator pos, Args&& ...args)
+        {
+            auto link_node = create_node(tinystl::forward<Args>(args)...);
+            link_node->next = pos.node_->next;
+            pos.node_->next = link_node;
+            return iterator(link_node);
+        }
+
+        // insert_after
+        iterator insert_after(const_iterator pos, const value_type& value)
+        { return emplace_after(pos, value); }
+
+        iterator insert_after(const_iterator pos, value_type&& value)
+        { return emplace_after(pos, tinystl::move(value)); }
+
+        iterator insert_after(const_iterator pos, size_type n, const value_type& value)
+        { return fill_insert_after(pos, n, value); }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert_after(const_iterator pos, Iter first, Iter last)
+        { return copy_insert_after(pos, first, last); }
+
+        iterator insert_after(const_iterator pos, std::initializer_list<T> ilist)
+        { return copy_insert_after(pos, ilist.begin(), ilist.end()); }
+
+        // push_front / pop_front
+        void push_front(const value_type& value)
+        { emplace_after(before_begin(), value); }
+
+        void push_front(value_type&& value)
+        { emplace_after(before_begin(), tinystl::move(value)); }
+
+        void pop_front()
+        {
+            TINYSTL_DEBUG(!empty());
+            erase_after(before_begin());
+        }
+
+        // erase_after / clear
+        iterator erase_after(const_iterator pos);
+        iterator erase_after(const_iterator first, const_iterator last);
+
+        void clear()
+        { erase_after(before_begin(), end()); }
+
+        // resize
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+
+        void resize(size_type new_size, const value_type& value);
+
+        void swap(forward_list& rhs) noexcept
+        { tinystl::swap(head_.next, rhs.head_.next); }
+
+        // forward_list related operations-------------------------------------------------
+        // splice_after : move the nodes of other after pos, nothing is copied
+        void splice_after(const_iterator pos, forward_list& other);
+
+        // move the node after it
+        void splice_after(const_iterator pos, forward_list& other, const_iterator it);
+
+        // move the nodes in (first, last)
+        void splice_after(const_iterator pos, forward_list& other,
+                          const_iterator first, const_iterator last);
+
+        void remove(const value_type& value)
+        { remove_if([&](const value_type& v) {return v == value; }); }
+
+        template <class UnaryPredicate>
+        void remove_if(UnaryPredicate pred);
+
+        void unique()
+        { unique(tinystl::equal_to<T>()); }
+
+        template <class BinaryPredicate>
+        void unique(BinaryPredicate pred);
+
+        void merge(forward_list& x)
+        { merge(x, tinystl::less<T>()); }
+
+        template <class Compare>
+        void merge(forward_list& x, Compare comp);
+
+        // sort : stable, bottom-up merge sort on the links, see list_chain_sort
+        void sort()
+        { sort(tinystl::less<T>()); }
+
+        template <class Compared>
+        void sort(Compared comp);
+
+        void reverse() noexcept;
+
+    private:
+        // helper functions----------------------------------------------------------------
+        // create / destroy node
+        template <class ...Args>
+        node_ptr create_node(Args&& ...args);
+
+        void destroy_node(node_ptr p);
+
+        // insert
+        iterator fill_insert_after(const_iterator pos, size_type n, const value_type& value);
+
+        template <class Iter>
+        iterator copy_insert_after(const_iterator pos, Iter first, Iter last);
+
+        // assign
+        template <class Iter>
+        void copy_assign(Iter first, Iter last);
+    };
+
+    //============= implement ===============================================================
+    // create node
+    template <class T>
+    template <class ...Args>
+    typename forward_list<T>::node_ptr forward_list<T>::create_node(Args&& ...args)
+    {
+        node_ptr p = node_allocator::allocate(1);
+        try
+        {
+            data_allocator::construct(tinystl::address_of(p->value),
+                                      tinystl::forward<Args>(args)...);
+            p->next = nullptr;
+        }
+        catch (...)
+        {
+            node_allocator::deallocate(p);
+            throw;
+        }
+        return p;
+    }
+
+    // destroy node
+    template <class T>
+    void forward_list<T>::destroy_node(node_ptr p)
+    {
+        data_allocator::destroy(tinystl::address_of(p->value));
+        node_allocator::deallocate(p);
+    }
+
+    // Insert n elements after pos, the nodes are linked only when all of them are built
+    template <class T>
+    typename forward_list<T>::iterator
+    forward_list<T>::fill_insert_after(const_iterator pos, size_type n, const value_type& value)
+    {
+        if (n == 0)
+            return iterator(pos.node_);
+        base_ptr first = create_node(value);
+        base_ptr last = first;
+        try
+        {
+            for (--n; n > 0; --n)
+            {
+                last->next = create_node(value);
+                last = last->next;
+            }
+        }
+        catch (...)
+        {
+            while (first != nullptr)
+            {
+                auto next = first->next;
+                destroy_node(first->as_node());
+                first = next;
+            }
+            throw;
+        }
+        last->next = pos.node_->next;
+        pos.node_->next = first;
+        return iterator(last);
+    }
+
+    // Insert [first, last) after pos, the nodes are linked only when all of them are built
+    template <class T>
+    template <class Iter>
+    typename forward_list<T>::iterator
+    forward_list<T>::copy_insert_after(const_iterator pos, Iter first, Iter last)
+    {
+        if (first == last)
+            return iterator(pos.node_);
+        base_ptr head = create_node(*first);
+        base_ptr tail = head;
+        try
+        {
+            for (++first; first != last; ++first)
+            {
+                tail->next = create_node(*first);
+                tail = tail->next;
+            }
+        }
+        catch (...)
+        {
+            while (head != nullptr)
+            {
+                auto next = head->next;
+                destroy_node(head->as_node());
+                head = next;
+            }
+            throw;
+        }
+        tail->next = pos.node_->next;
+        pos.node_->next = head;
+        return iterator(tail);
+    }
+
+    // Reuse the existing nodes, then erase or append the difference
+    template <class T>
+    template <class Iter>
+    void forward_list<T>::copy_assign(Iter first, Iter last)
+    {
+        auto prev = before_begin();
+        auto cur = begin();
+        for (; cur != end() && first != last; ++prev, ++cur, ++first)
+            *cur = *first;
+        if (first == last)
+            erase_after(prev, end());
+        else
+            copy_insert_after(prev, first, last);
+    }
+
+    // Erase the element after pos
+    template <class T>
+    typename forward_list<T>::iterator
+    forward_list<T>::erase_after(const_iterator pos)
+    {
+        TINYSTL_DEBUG(pos.node_->next != nullptr);
+        auto n = pos.node_->next;
+        pos.node_->next = n->next;
+        destroy_node(n->as_node());
+        return iterator(pos.node_->next);
+    }
+
+    // Erase the elements in (first, last)
+    template <class T>
+    typename forward_list<T>::iterator
+    forward_list<T>::erase_after(const_iterator first, const_iterator last)
+    {
+        auto cur = first.node_->next;
+        while (cur != last.node_)
+        {
+            auto next = cur->next;
+            destroy_node(cur->as_node());
+            cur = next;
+        }
+        first.node_->next = last.node_;
+        return iterator(last.node_);
+    }
+
+    // Resize the container
+    template <class T>
+    void forward_list<T>::resize(size_type new_size, const value_type& value)
+    {
+        auto prev = before_begin();
+        auto cur = begin();
+        for (; cur != end() && new_size > 0; ++prev, ++cur, --new_size)
+            ;
+        if (cur != end())
+            erase_after(prev, end());
+        else
+            fill_insert_after(prev, new_size, value);
+    }
+
+    // Move all nodes of x after pos
+    template <class T>
+    void forward_list<T>::splice_after(const_iterator pos, forward_list& x)
+    {
+        TINYSTL_DEBUG(this != &x);
+        if (!x.empty())
+            splice_after(pos, x, x.before_begin(), x.end());
+    }
+
+    // Move the node after it in x to after pos
+    template <class T>
+    void forward_list<T>::splice_after(const_iterator pos, forward_list&, const_iterator it)
+    {
+        auto n = it.node_->next;
+        if (pos.node_ == it.node_ || pos.node_ == n || n == nullptr)
+            return;
+        it.node_->next = n->next;
+        n->next = pos.node_->next;
+        pos.node_->next = n;
+    }
+
+    // Move the nodes in (first, last) of x to after pos
+    template <class T>
+    void forward_list<T>::splice_after(const_iterator pos, forward_list&,
+                                       const_iterator first, const_iterator last)
+    {
+        if (first == last || first.node_->next == last.node_)
+            return;
+        // find the node before last
+        base_ptr l = first.node_->next;
+        while (l->next != last.node_)
+            l = l->next;
+        base_ptr f = first.node_->next;
+        first.node_->next = last.node_;
+        l->next = pos.node_->next;
+        pos.node_->next = f;
+    }
+
+    // Remove all elements for which pred is true
+    template <class T>
+    template <class UnaryPredicate>
+    void forward_list<T>::remove_if(UnaryPredicate pred)
+    {
+        auto prev = before_begin();
+        auto cur = begin();
+        while (cur != end())
+        {
+            if (pred(*cur))
+            {
+                cur = erase_after(prev);
+            }
+            else
+            {
+                prev = cur;
+                ++cur;
+            }
+        }
+    }
+
+    // Remove consecutive duplicates
+    template <class T>
+    template <class BinaryPredicate>
+    void forward_list<T>::unique(BinaryPredicate pred)
+    {
+        if (empty())
+            return;
+        auto i = begin();
+        auto j = i;
+        for (++j; j != end(); )
+        {
+            if (pred(*i, *j))
+            {
+                j = erase_after(i);
+            }
+            else
+            {
+                i = j;
+                ++j;
+            }
+        }
+    }
+
+    // Merge with another sorted list, stable: on equal elements the ones of *this come first
+    template <class T>
+    template <class Compare>
+    void forward_list<T>::merge(forward_list& x, Compare comp)
+    {
+        if (this != &x)
+        {
+            base_ptr other = x.head_.next;
+            x.head_.next = nullptr;
+            auto node_comp = [&comp](base_ptr a, base_ptr b)
+            { return comp(a->as_node()->value, b->as_node()->value); };
+            tinystl::list_chain_merge(head_.next, other, node_comp);
+        }
+    }
+
+    // Sort the list
+    template <class T>
+    template <class Compared>
+    void forward_list<T>::sort(Compared comp)
+    {
+        auto node_comp = [&comp](base_ptr a, base_ptr b)
+        { return comp(a->as_node()->value, b->as_node()->value); };
+        tinystl::list_chain_sort(head_.next, node_comp);
+    }
+
+    // Reverse the list
+    template <class T>
+    void forward_list<T>::reverse() noexcept
+    {
+        base_ptr prev = nullptr;
+        base_ptr cur = head_.next;
+        while (cur != nullptr)
+        {
+            auto next = cur->next;
+            cur->next = prev;
+            prev = cur;
+            cur = next;
+        }
+        head_.next = prev;
+    }
+
+    // overloaded comparison operator
+    template <class T>
+    bool operator==(const forward_list<T>& lhs, const forward_list<T>& rhs)
+    {
+        auto f1 = lhs.cbegin();
+        auto f2 = rhs.cbegin();
+        auto l1 = lhs.cend();
+        auto l2 = rhs.cend();
+        for (; f1 != l1 && f2 != l2 && *f1 == *f2; ++f1, ++f2)
+            ;
+        return f1 == l1 && f2 == l2;
+    }
+
+    template <class T>
+    bool operator<(const forward_list<T>& lhs, const forward_list<T>& rhs)
+    {
+        return tinystl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+    }
+
+    template <class T>
+    bool operator!=(const forward_list<T>& lhs, const forward_list<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T>
+    bool operator>(const forward_list<T>& lhs, const forward_list<T>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T>
+    bool operator<=(const forward_list<T>& lhs, const forward_list<T>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T>
+    bool operator>=(const forward_list<T>& lhs, const forward_list<T>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overload tinystl's swap
+    template <class T>
+    void swap(forward_list<T>& lhs, forward_list<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+}
+#endif
@@ -0,0 +1,526 @@
+#ifndef _FROZEN_MAP_H_
+#define _FROZEN_MAP_H_
+
+// frozen_map        : an immutable key -> value map with a minimal perfect hash, built once at construction
+// static_frozen_map : the same with N keys in fixed arrays, can be built as constexpr from a literal list (C++14)
+
+// notes:
+// When the set of keys is known up front and never changes (the keywords of a protocol, the names
+// of the fields of a format), the hash table does not have to handle collisions at all:
+// a perfect hash sends each of the n keys to its own slot of [0, n), so a lookup is
+// one hash, one slot, one key comparison, and the n entries are stored side by side without gaps.
+//
+// The perfect hash is built the PTHash way (hash and displace, like CHD):
+//   * every key gets a 64-bit hash h: tinystl::hash (or the hash given) mixed with a seed
+//   * the keys are split into about n / 4 buckets by the high bits of h
+//   * the buckets are placed from the largest one down: for bucket b, the pilot p = 0, 1, 2 ...
+//     is tried until every key of b lands on a free slot, slot = mix(h ^ mix(p)) scaled to [0, n),
+//     and mix(p) is kept for b
+// so a lookup is  slot = mix(h ^ pilot[bucket(h)]) scaled to [0, n),  and the table costs 2 bytes per key
+// for the pilots on top of the entries. The big buckets are placed while the table is still empty,
+// the last ones are single keys that only need one free slot; if a bucket finds no pilot
+// (or two different keys have the same 64-bit hash) everything starts again with another seed.
+//
+// The keys are unique, a key that appears again in the input is ignored, as in insert_unique.
+// For const char* keys the default hash and comparison are on the characters, not on the pointer.
+
+#include <initializer_list>
+#include <cstdint>
+
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+// constexpr functions with loops need C++14
+#if __cplusplus >= 201402L
+#define FROZEN_MAP_CONSTEXPR constexpr
+#else
+#define FROZEN_MAP_CONSTEXPR inline
+#endif
+
+namespace tinystl
+{
+
+    // the finalizer of splitmix64, every input bit changes about half of the output bits
+    FROZEN_MAP_CONSTEXPR uint64_t frozen_mix(uint64_t x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // the bucket of a key: the high 32 bits of h scaled to [0, m)
+    FROZEN_MAP_CONSTEXPR size_t frozen_bucket(uint64_t h, size_t m) noexcept
+    {
+        return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(m)) >> 32);
+    }
+
+    // the slot of a key whose bucket has the (mixed) pilot ph: the high 32 bits of mix(h ^ ph)
+    // scaled to [0, n), a multiply instead of a 64-bit division on the lookup path (n < 2^32)
+    FROZEN_MAP_CONSTEXPR size_t frozen_slot(uint64_t h, uint64_t ph, size_t n) noexcept
+    {
+        return static_cast<size_t>(((frozen_mix(h ^ ph) >> 32) * static_cast<uint64_t>(n)) >> 32);
+    }
+
+    // the number of buckets for n keys
+    constexpr size_t frozen_bucket_count(size_t n)
+    {
+        return n / 4 + 1;
+    }
+
+    // frozen_place
+    // Find the pilot of every bucket for the n different hashes h[0, n).
+    // out:  pilots[0, m) the mixed pilot of each bucket, slots[0, n) the slot of each key
+    // work: start[0, m], items[0, n), order[0, m), taken[0, n)
+    // returns n when every key has its slot,
+    //         i < n when h[i] == h[*dup] for an earlier key *dup,
+    //         n + 1 when a bucket found no pilot
+    FROZEN_MAP_CONSTEXPR size_t
+    frozen_place(const uint64_t* h, size_t n, size_t m, uint64_t* pilots, size_t* slots,
+                 size_t* start, size_t* items, size_t* order, unsigned char* taken, size_t* dup)
+    {
+        // items: the keys grouped by bucket, bucket b is items[start[b], start[b + 1])
+        for (size_t b = 0; b <= m; ++b)
+            start[b] = 0;
+        for (size_t i = 0; i < n; ++i)
+            ++start[frozen_bucket(h[i], m) + 1];
+        for (size_t b = 0; b < m; ++b)
+            start[b + 1] += start[b];
+        for (size_t i = 0; i < n; ++i)
+            items[start[frozen_bucket(h[i], m)]++] = i;
+        for (size_t b = m; b > 0; --b)
+            start[b] = start[b - 1];
+        start[0] = 0;
+
+        // equal hashes would need the same slot, they end up in the same bucket
+        size_t max_size = 0;
+        for (size_t b = 0; b < m; ++b)
+        {
+            for (size_t x = start[b]; x < start[b + 1]; ++x)
+            {
+                for (size_t y = start[b]; y < x; ++y)
+                {
+                    if (h[items[x]] == h[items[y]])
+                    {
+                        const bool later = items[x] > items[y];
+                        *dup = later ? items[y] : items[x];
+                        return later ? items[x] : items[y];
+                    }
+                }
+            }
+            if (start[b + 1] - start[b] > max_size)
+                max_size = start[b + 1] - start[b];
+        }
+
+        // the largest buckets first
+        size_t k = 0;
+        for (size_t sz = max_size; sz > 0; --sz)
+        {
+            for (size_t b = 0; b < m; ++b)
+            {
+                if (start[b + 1] - start[b] == sz)
+                    order[k++] = b;
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            taken[i] = 0;
+        for (size_t b = 0; b < m; ++b)
+            pilots[b] = 0;
+        const uint64_t limit = static_cast<uint64_t>(n) * 64 + 1024;
+        for (size_t j = 0; j < k; ++j)
+        {
+            const size_t b = order[j];
+            uint64_t p = 0;
+            for (; p < limit; ++p)
+            {
+                const uint64_t ph = frozen_mix(p + 1);
+                bool ok = true;
+                for (size_t x = start[b]; ok && x < start[b + 1]; ++x)
+                {
+                    const size_t s = frozen_slot(h[items[x]], ph, n);
+                    if (taken[s])
+                        ok = false;
+                    // two keys of the bucket on the same slot
+                    for (size_t y = start[b]; ok && y < x; ++y)
+                    {
+                        if (slots[items[y]] == s)
+                            ok = false;
+                    }
+                    slots[items[x]] = s;
+                }
+                if (ok)
+                {
+                    pilots[b] = ph;
+                    for (size_t x = start[b]; x < start[b + 1]; ++x)
+                        taken[slots[items[x]]] = 1;
+                    break;
+                }
+            }
+            if (p == limit)
+                return n + 1;
+        }
+        return n;
+    }
+
+    // FNV-1a over the characters of a null-terminated string
+    struct frozen_cstr_hash
+    {
+        FROZEN_MAP_CONSTEXPR size_t operator()(const char* s) const noexcept
+        {
+            uint64_t h = 14695981039346656037ull;
+            for (; *s != '\0'; ++s)
+            {
+                h ^= static_cast<unsigned char>(*s);
+                h *= 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    struct frozen_cstr_equal
+    {
+        FROZEN_MAP_CONSTEXPR bool operator()(const char* a, const char* b) const noexcept
+        {
+            for (; *a != '\0' && *a == *b; ++a, ++b) {}
+            return *a == *b;
+        }
+    };
+
+    // the default hash and comparison: tinystl's, but on the characters for const char*
+    template <class Key>
+    struct frozen_default_hash { typedef tinystl::hash<Key> type; };
+
+    template <>
+    struct frozen_default_hash<const char*> { typedef frozen_cstr_hash type; };
+
+    template <class Key>
+    struct frozen_default_equal { typedef tinystl::equal_to<Key> type; };
+
+    template <>
+    struct frozen_default_equal<const char*> { typedef frozen_cstr_equal type; };
+
+    //=================== frozen_map =========================================================
+    template <class Key, class T,
+              class Hash = typename frozen_default_hash<Key>::type,
+              class KeyEqual = typename frozen_default_equal<Key>::type>
+    class frozen_map
+    {
+    public:
+        typedef Key                         key_type;
+        typedef T                           mapped_type;
+        typedef tinystl::pair<const Key, T> value_type;
+        typedef Hash                        hasher;
+        typedef KeyEqual                    key_equal;
+        typedef size_t                      size_type;
+
+        typedef value_type*                 iterator;
+        typedef const value_type*           const_iterator;
+
+    private:
+        tinystl::vector<value_type> data_;    // data_[s] is the entry of slot s
+        tinystl::vector<uint64_t>   pilots_;  // the mixed pilot of each bucket
+        uint64_t                    seed_;
+        hasher                      hash_;
+        key_equal                   equal_;
+
+    public:
+        // constructor
+        frozen_map() :data_(), pilots_(), seed_(0), hash_(), equal_()
+        {}
+
+        template <class InputIter>
+        frozen_map(InputIter first, InputIter last, const Hash& hash = Hash(),
+                   const KeyEqual& equal = KeyEqual())
+            :data_(), pilots_(), seed_(0), hash_(hash), equal_(equal)
+        {
+            build(first, last);
+        }
+
+        frozen_map(std::initializer_list<value_type> ilist, const Hash& hash = Hash(),
+                   const KeyEqual& equal = KeyEqual())
+            :data_(), pilots_(), seed_(0), hash_(hash), equal_(equal)
+        {
+            build(ilist.begin(), ilist.end());
+        }
+
+        // iterator, in slot order
+        iterator       begin()        noexcept { return data_.data(); }
+        const_iterator begin()  const noexcept { return data_.data(); }
+        iterator       end()          noexcept { return data_.data() + data_.size(); }
+        const_iterator end()    const noexcept { return data_.data() + data_.size(); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend()   const noexcept { return end(); }
+
+        // capacity
+        bool      empty() const noexcept { return data_.empty(); }
+        size_type size()  const noexcept { return data_.size(); }
+
+        // lookup: one slot, one comparison
+        iterator find(const key_type& key)
+        {
+            const size_type s = slot_of(key);
+            return s != size() && equal_(data_[s].first, key) ? begin() + s : end();
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            const size_type s = slot_of(key);
+            return s != size() && equal_(data_[s].first, key) ? begin() + s : end();
+        }
+
+        bool contains(const key_type& key) const
+        { return find(key) != end(); }
+
+        size_type count(const key_type& key) const
+        { return contains(key) ? 1 : 0; }
+
+        mapped_type& at(const key_type& key)
+        {
+            iterator it = find(key);
+            THROW_OUT_OF_RANGE_IF(it == end(), "frozen_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            const_iterator it = find(key);
+            THROW_OUT_OF_RANGE_IF(it == end(), "frozen_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        hasher    hash_fcn() const { return hash_; }
+        key_equal key_eq()   const { return equal_; }
+
+        void swap(frozen_map& rhs) noexcept
+        {
+            data_.swap(rhs.data_);
+            pilots_.swap(rhs.pilots_);
+            tinystl::swap(seed_, rhs.seed_);
+            tinystl::swap(hash_, rhs.hash_);
+            tinystl::swap(equal_, rhs.equal_);
+        }
+
+    private:
+        uint64_t hash_of(const key_type& key) const
+        { return frozen_mix(static_cast<uint64_t>(hash_(key)) ^ seed_); }
+
+        // the slot key would be in, size() for an empty map
+        size_type slot_of(const key_type& key) const
+        {
+            if (data_.empty())
+                return 0;
+            const uint64_t h = hash_of(key);
+            return frozen_slot(h, pilots_[frozen_bucket(h, pilots_.size())], data_.size());
+        }
+
+        template <class InputIter>
+        void build(InputIter first, InputIter last);
+    };
+
+    /*****************************************************************************************/
+
+    // build
+    template <class Key, class T, class Hash, class KeyEqual>
+    template <class InputIter>
+    void frozen_map<Key, T, Hash, KeyEqual>::build(InputIter first, InputIter last)
+    {
+        tinystl::vector<value_type> input;
+        for (; first != last; ++first)
+            input.push_back(*first);
+
+        // keys[i] is the index in input of the i-th key that is kept.
+        // The repeated keys are dropped here in one pass: the keys are chained by hash_ in a
+        // table of 2^k >= 2n heads, a key is compared only with the kept keys of its chain
+        tinystl::vector<size_type> keys;
+        keys.reserve(input.size());
+        {
+            const size_type none = static_cast<size_type>(-1);
+            size_type mask = 1;
+            while (mask < input.size() * 2)
+                mask <<= 1;
+            --mask;
+            tinystl::vector<size_type> head(mask + 1, none), next(input.size(), none), raw(input.size(), 0);
+            for (size_type i = 0; i < input.size(); ++i)
+            {
+                raw[i] = static_cast<size_type>(hash_(input[i].first));
+                size_type& b = head[raw[i] & mask];
+                size_type j = b;
+                while (j != none && !(raw[j] == raw[i] && equal_(input[j].first, input[i].first)))
+                    j = next[j];
+                if (j != none)
+                    continue;  // the same key again, the first one is kept
+                next[i] = b;
+                b = i;
+                keys.push_back(i);
+            }
+        }
+
+        tinystl::vector<uint64_t> h;
+        tinystl::vector<size_type> slots, start, items, order;
+        tinystl::vector<unsigned char> taken;
+        THROW_LENGTH_ERROR_IF(static_cast<uint64_t>(keys.size()) > 0xFFFFFFFFull,
+                              "frozen_map<Key, T> too many keys");
+        for (size_type attempt = 0; !keys.empty(); )
+        {
+            const size_type n = keys.size();
+            const size_type m = frozen_bucket_count(n);
+            h.assign(n, 0);
+            slots.assign(n, 0);
+            start.assign(m + 1, 0);
+            items.assign(n, 0);
+            order.assign(m, 0);
+            taken.assign(n, 0);
+            pilots_.assign(m, 0);
+            for (size_type i = 0; i < n; ++i)
+                h[i] = hash_of(input[keys[i]].first);
+
+            size_type dup = 0;
+            const size_type r = frozen_place(h.data(), n, m, pilots_.data(), slots.data(), start.data(),
+                                             items.data(), order.data(), taken.data(), &dup);
+            if (r == n)
+            {
+                // the entries in slot order
+                for (size_type i = 0; i < n; ++i)
+                    items[slots[i]] = keys[i];
+                data_.reserve(n);
+                for (size_type s = 0; s < n; ++s)
+                    data_.push_back(tinystl::move(input[items[s]]));
+                return;
+            }
+            // the keys are unique by now: two different keys with the same 64-bit hash
+            // or a bucket without a pilot, try another seed
+            TINYSTL_DEBUG(r == n + 1 || !equal_(input[keys[r]].first, input[keys[dup]].first));
+            ++attempt;
+            THROW_LENGTH_ERROR_IF(attempt == 64, "frozen_map<Key, T> can not build a perfect hash");
+            seed_ = frozen_mix(seed_ + 0x9E3779B97F4A7C15ull);
+        }
+        pilots_.clear();
+    }
+
+    // overloaded swap
+    template <class Key, class T, class Hash, class KeyEqual>
+    void swap(frozen_map<Key, T, Hash, KeyEqual>& lhs, frozen_map<Key, T, Hash, KeyEqual>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+#if __cplusplus >= 201402L
+
+    //=================== static_frozen_map ==================================================
+    // N keys and values in fixed arrays, built by a constexpr constructor, e.g.
+    //
+    //     constexpr auto methods = tinystl::make_frozen_map<const char*, int>({
+    //         { "GET", 1 }, { "PUT", 2 }, { "POST", 3 }, { "DELETE", 4 } });
+    //     static_assert(methods.at("PUT") == 2, "");
+    //
+    // Key and T must be literal types with a default constructor, and Hash / KeyEqual must be
+    // usable in constant expressions (the integral tinystl::hash, equal_to and the cstr ones are).
+    // A key that appears twice is an error here: in a constant expression it does not compile.
+    template <class Key, class T, size_t N,
+              class Hash = typename frozen_default_hash<Key>::type,
+              class KeyEqual = typename frozen_default_equal<Key>::type>
+    class static_frozen_map
+    {
+        static_assert(N > 0, "static_frozen_map needs at least one key");
+
+    public:
+        typedef Key         key_type;
+        typedef T           mapped_type;
+        typedef Hash        hasher;
+        typedef KeyEqual    key_equal;
+        typedef size_t      size_type;
+
+    private:
+        static constexpr size_type M = frozen_bucket_count(N);
+
+        Key      keys_[N];
+        T        values_[N];
+        uint64_t pilots_[M];
+        uint64_t seed_;
+        hasher   hash_;
+        key_equal equal_;
+
+    public:
+        constexpr explicit static_frozen_map(const tinystl::pair<Key, T> (&list)[N],
+                                             const Hash& hash = Hash(),
+                                             const KeyEqual& equal = KeyEqual())
+            :keys_(), values_(), pilots_(), seed_(0), hash_(hash), equal_(equal)
+        {
+            uint64_t h[N] = {};
+            size_t slots[N] = {}, start[M + 1] = {}, items[N] = {}, order[M] = {};
+            unsigned char taken[N] = {};
+            for (size_t attempt = 0; ; ++attempt)
+            {
+                THROW_LENGTH_ERROR_IF(attempt == 64, "static_frozen_map can not build a perfect hash");
+                for (size_t i = 0; i < N; ++i)
+                    h[i] = hash_of(list[i].first);
+                size_t dup = 0;
+                const size_t r = frozen_place(h, N, M, pilots_, slots, start, items, order, taken, &dup);
+                if (r == N)
+                    break;
+                THROW_LENGTH_ERROR_IF(r < N && equal_(list[r].first, list[dup].first),
+                                      "static_frozen_map has a duplicate key");
+                seed_ = frozen_mix(seed_ + 0x9E3779B97F4A7C15ull);
+            }
+            for (size_t i = 0; i < N; ++i)
+            {
+                keys_[slots[i]] = list[i].first;
+                values_[slots[i]] = list[i].second;
+            }
+        }
+
+        constexpr size_type size()  const noexcept { return N; }
+        constexpr bool      empty() const noexcept { return false; }
+
+        // the value of key, nullptr if key is not in the map
+        constexpr const mapped_type* find(const key_type& key) const
+        {
+            const size_type s = slot_of(key);
+            return equal_(keys_[s], key) ? values_ + s : nullptr;
+        }
+
+        constexpr bool contains(const key_type& key) const
+        { return find(key) != nullptr; }
+
+        constexpr size_type count(const key_type& key) const
+        { return contains(key) ? 1 : 0; }
+
+        constexpr const mapped_type& at(const key_type& key) const
+        {
+            const mapped_type* p = find(key);
+            THROW_OUT_OF_RANGE_IF(p == nullptr, "static_frozen_map no such element exists");
+            return *p;
+        }
+
+        // the i-th entry in slot order
+        constexpr const key_type&    key(size_type i)    const { return keys_[i]; }
+        constexpr const mapped_type& mapped(size_type i) const { return values_[i]; }
+
+    private:
+        constexpr uint64_t hash_of(const key_type& key) const
+        { return frozen_mix(static_cast<uint64_t>(hash_(key)) ^ seed_); }
+
+        constexpr size_type slot_of(const key_type& key) const
+        {
+            const uint64_t h = hash_of(key);
+            return frozen_slot(h, pilots_[frozen_bucket(h, M)], N);
+        }
+    };
+
+    // build a static_frozen_map from a braced list, N is deduced
+    template <class Key, class T, size_t N>
+    constexpr static_frozen_map<Key, T, N> make_frozen_map(const tinystl::pair<Key, T> (&list)[N])
+    {
+        return static_frozen_map<Key, T, N>(list);
+    }
+
+#endif // C++14
+
+} // namespace tinystl
+
+#endif // !_FROZEN_MAP_H_
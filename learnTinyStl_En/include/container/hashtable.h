@@ -5,6 +5,7 @@
 // hashtable : Use the open chain method to handle conflicts
 
 #include <initializer_list>
+#include <cmath>
 
 #include "algo.h"
 #include "functional.h"
@@ -498,6 +499,48 @@ namespace tinystl
         return pos == last ? *(last - 1) : *pos;
     }
 
+    // keys handled together by find_batch / count_batch
+    constexpr size_t ht_batch_size = 16;
+
+    // entries of ht_stats::chain_histogram: chains of 0, 1, ... ht_histogram_size - 2 nodes,
+    // the last entry counts all the longer chains
+    constexpr size_t ht_histogram_size = 16;
+
+    // hashtable::stats()
+    // the probe cost of a lookup is the number of nodes it compares with the key:
+    // a hit on the k-th node of a chain costs k, a miss costs the length of the chain.
+    // With a good hash and load factor a, the chains follow a Poisson(a) distribution:
+    // about e^-a of the buckets are empty and a hit costs about 1 + a / 2.
+    // Long chains and many empty buckets at a normal load factor mean the hash clusters.
+    struct ht_stats
+    {
+        size_t size;
+        size_t bucket_count;
+        size_t empty_buckets;
+        size_t max_chain;
+        size_t rehash_count;      // bucket arrays rebuilt since construction or reset_stats()
+        double load_factor;
+        double empty_ratio;       // empty_buckets / bucket_count
+        double avg_chain;         // average length of the non-empty chains
+        double avg_probe;         // average cost of a hit, over all the elements
+        size_t chain_histogram[ht_histogram_size];
+
+        // filled by lookup sampling (sample_lookups, needs TINYSTL_HT_SAMPLING), zero when it is off
+        size_t sampled_lookups;
+        size_t sampled_max_probe;
+        double sampled_avg_probe;
+    };
+
+    // lookup sampling state of a hashtable: every period-th find records its probe cost
+    struct ht_lookup_sampler
+    {
+        size_t period = 0;     // 0: off
+        size_t countdown = 0;  // finds left before the next sampled one
+        size_t lookups = 0;
+        size_t probes = 0;
+        size_t max_probe = 0;
+    };
+
     //=============hashtable===============================================================
     // first parameter: value type
     // second parameter: hash function
@@ -546,9 +589,14 @@ namespace tinystl
         size_type   bucket_size_;
         size_type   size_;
         float       mlf_;    // used for: 
+        float       min_lf_; // shrink when an erase takes the load factor below it, 0: never
         hasher      hash_;
         key_equal   equal_;
 
+        // statistics
+        size_type                 rehash_count_;
+        mutable ht_lookup_sampler sampler_;  // written by the (const) find
+
     private:
         bool is_equal(const key_type& key1, const key_type& key2)
         {
@@ -590,7 +638,7 @@ namespace tinystl
         // constructor
         explicit hashtable(size_type bucket_count, const Hash& hash = Hash(),
                            const KeyEqual& equal = KeyEqual())
-            :size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
+            :size_(0), mlf_(1.0f), min_lf_(0.0f), hash_(hash), equal_(equal), rehash_count_(0)
         {
             init(bucket_count);
         }
@@ -599,24 +647,29 @@ namespace tinystl
             tinystl::is_input_iterator<Iter>::value, int>::type = 0>
             hashtable(Iter first, Iter last, size_type bucket_count,
                       const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
-            :size_(tinystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal)
+            :size_(tinystl::distance(first, last)), mlf_(1.0f), min_lf_(0.0f), hash_(hash), equal_(equal),
+             rehash_count_(0)
         {
             init(tinystl::max(bucket_count, static_cast<size_type>(tinystl::distance(first, last))));
         }
 
         // copy constructor
-        hashtable(const hashtable& rhs): hash_(rhs.hash_), equal_(rhs.equal_)
+        hashtable(const hashtable& rhs): hash_(rhs.hash_), equal_(rhs.equal_), rehash_count_(0)
         {
             copy_init(rhs);
         }
 
         hashtable(hashtable&& rhs) noexcept: bucket_size_(rhs.bucket_size_), size_(rhs.size_),
-                                             mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+                                             mlf_(rhs.mlf_), min_lf_(rhs.min_lf_),
+                                             hash_(rhs.hash_), equal_(rhs.equal_),
+                                             rehash_count_(rhs.rehash_count_), sampler_(rhs.sampler_)
         {
             buckets_ = tinystl::move(rhs.buckets_);
             rhs.bucket_size_ = 0;
             rhs.size_ = 0;
-            rhs.mlf_ = 0.0f;
+            // rhs keeps its load factors: a moved-from table must still be able to grow
+            rhs.rehash_count_ = 0;
+            rhs.sampler_ = ht_lookup_sampler();
         }
 
         hashtable& operator=(const hashtable& rhs);
@@ -738,6 +791,19 @@ namespace tinystl
         pair<iterator, iterator> equal_range_unique(const key_type& key);
         pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
 
+        // batch lookup: *result++ = find(key) / count(key) for every key in [first, last),
+        // returns the end of the output. The keys must be key_type lvalues.
+        // A single find waits for the bucket slot, then for the node;
+        // here ht_batch_size keys are hashed and their slots prefetched, then their first nodes,
+        // and only then the chains are walked, so the cache misses of the keys overlap.
+        template <class ForwardIter, class OutputIter>
+        OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result);
+        template <class ForwardIter, class OutputIter>
+        OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result) const;
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter result) const;
+
         // bucket interface
         local_iterator begin(size_type n) noexcept
         { 
@@ -791,18 +857,66 @@ namespace tinystl
 
         void max_load_factor(float ml)
         {
-            THROW_OUT_OF_RANGE_IF(ml != ml || ml < 0, "invalid hash load factor");
+            THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0, "invalid hash load factor");
             mlf_ = ml;
+            // keep the gap between the two load factors
+            if (min_lf_ >= mlf_ * 0.5f)
+                min_lf_ = mlf_ * 0.25f;
+        }
+
+        // automatic shrink: when an erase takes the load factor below ml, the bucket array
+        // shrinks so that the load factor is about max_load_factor() / 2 again.
+        // 0 turns it off (the default). ml must be under max_load_factor() / 2, the gap is
+        // the hysteresis that keeps a table from shrinking and growing in turn; a later
+        // max_load_factor(x) that closes the gap lowers min_load_factor() to x / 4.
+        // With it on, an erase can rehash and invalidate iterators, as an insert can.
+        float min_load_factor() const noexcept
+        { return min_lf_; }
+
+        void min_load_factor(float ml)
+        {
+            THROW_OUT_OF_RANGE_IF(ml != ml || ml < 0 || ml >= mlf_ * 0.5f, "invalid hash load factor");
+            min_lf_ = ml;
         }
 
+        // rehash: at least count buckets, and enough for size() under max_load_factor()
         void rehash(size_type count);
 
+        // reserve: enough buckets for count elements, so inserting up to count elements
+        // does not rehash again (the same test as the one insert uses)
         void reserve(size_type count)
-        { rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); }
+        { rehash(bucket_count_for(count)); }
+
+        // shrink_to_fit: the smallest bucket count that keeps size() under max_load_factor()
+        void shrink_to_fit();
 
         hasher    hash_fcn() const { return hash_; }
         key_equal key_eq()   const { return equal_; }
 
+        // statistics
+        // stats() walks every bucket once, O(bucket_count()), it does not allocate
+        ht_stats stats() const noexcept;
+
+        // lookup sampling: every period-th find records how many nodes it compared,
+        // period = 0 turns it off (the default). It is only compiled in when TINYSTL_HT_SAMPLING
+        // is defined: the hook may write to the table, so the compiler has to reload the buckets
+        // in every find, which cost ~15% on a find loop even with sampling off.
+        // A sampled find writes to the table, do not sample a table that several threads read.
+        void sample_lookups(size_type period) noexcept
+        {
+            sampler_.period = period;
+            sampler_.countdown = period;
+        }
+
+        // forget the rehash count and the samples, sampling keeps its period
+        void reset_stats() noexcept
+        {
+            rehash_count_ = 0;
+            const size_type period = sampler_.period;
+            sampler_ = ht_lookup_sampler();
+            sample_lookups(period);
+        }
+
     private:
         // init
         void init(size_type n);
@@ -814,11 +928,30 @@ namespace tinystl
 
         void destroy_node(node_ptr n);
 
+        // find
+        // find_node: the first node that holds key, nullptr if none
+        node_ptr find_node(const key_type& key) const
+        {
+#ifdef TINYSTL_HT_SAMPLING
+            if (sampler_.period != 0 && --sampler_.countdown == 0)
+                return sampled_find_node(key);
+#endif
+            node_ptr first = buckets_[hash(key)];
+            for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
+            return first;
+        }
+
+        node_ptr sampled_find_node(const key_type& key) const;
+
         // hash
         size_type next_size(size_type n) const;
         size_type hash(const key_type& key, size_type n) const;
         size_type hash(const key_type& key) const;
         void rehash_if_need(size_type n);
+        void shrink_if_need();
+        size_type bucket_count_for(size_type count, float lf) const;
+        size_type bucket_count_for(size_type count) const
+        { return bucket_count_for(count, mlf_); }
 
         // insert
         template <class InputIter>
@@ -839,12 +972,19 @@ namespace tinystl
 
         // bucket operator
         void replace_bucket(size_type bucket_count);
+        void move_nodes(bucket_type& bucket);
         void erase_bucket(size_type n, node_ptr first, node_ptr last);
         void erase_bucket(size_type n, node_ptr last);
 
         // comparision
         bool equal_to_multi(const hashtable& other);
         bool equal_to_unique(const hashtable& other);
+
+        // batch lookup
+        template <class ForwardIter>
+        ForwardIter gather_batch(ForwardIter first, ForwardIter last,
+                                 const key_type** keys, size_type& n) const;
+        void probe_batch(const key_type* const* keys, node_ptr* nodes, size_type n) const;
     };
 
     //========implement====================================================================
@@ -882,8 +1022,7 @@ namespace tinystl
         auto np = create_node(tinystl::forward<Args>(args)...);
         try
         {
-            if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-            rehash(size_ + 1);
+            rehash_if_need(1);
         }
         catch (...)
         {
@@ -903,8 +1042,7 @@ namespace tinystl
         auto np = create_node(tinystl::forward<Args>(args)...);
         try
         {
-            if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-            rehash(size_ + 1);
+            rehash_if_need(1);
         }
         catch (...)
         {
@@ -996,6 +1134,7 @@ namespace tinystl
                 }
             }
             }
+            shrink_if_need();
         }
     }
 
@@ -1031,6 +1170,7 @@ namespace tinystl
                 erase_bucket(last_bucket, last.node);
             }
         }
+        shrink_if_need();
     }
 
     // delete the key node
@@ -1041,8 +1181,10 @@ namespace tinystl
         auto p = equal_range_multi(key);
         if (p.first.node != nullptr)
         {
+            // count before the nodes are gone
+            const size_type n = tinystl::distance(p.first, p.second);
             erase(p.first, p.second);
-            return tinystl::distance(p.first, p.second);
+            return n;
         }
         return 0;
     }
@@ -1060,6 +1202,7 @@ namespace tinystl
                 buckets_[n] = first->next;
                 destroy_node(first);
                 --size_;
+                shrink_if_need();
                 return 1;
             }
             else
@@ -1072,6 +1215,7 @@ namespace tinystl
                         first->next = next->next;
                         destroy_node(next);
                         --size_;
+                        shrink_if_need();
                         return 1;
                     }
                     first = next;
@@ -1120,7 +1264,7 @@ namespace tinystl
     template <class T, class Hash, class KeyEqual>
     void hashtable<T, Hash, KeyEqual>::rehash(size_type count)
     {
-        auto n = ht_next_prime(count);
+        auto n = ht_next_prime(tinystl::max(count, bucket_count_for(size_)));
         if (n > bucket_size_)
         {
             replace_bucket(n);
@@ -1135,25 +1279,28 @@ namespace tinystl
         }
     }
 
+    // shrink_to_fit
+    template <class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::shrink_to_fit()
+    {
+        const auto n = ht_next_prime(bucket_count_for(size_));
+        if (n < bucket_size_)
+            replace_bucket(n);
+    }
+
     //Find the node whose key value is key and return its iterator
     template <class T, class Hash, class KeyEqual>
     typename hashtable<T, Hash, KeyEqual>::iterator
     hashtable<T, Hash, KeyEqual>::find(const key_type& key)
     {
-        const auto n = hash(key);
-        node_ptr first = buckets_[n];
-        for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-        return iterator(first, this);
+        return iterator(find_node(key), this);
     }
 
     template <class T, class Hash, class KeyEqual>
     typename hashtable<T, Hash, KeyEqual>::const_iterator
     hashtable<T, Hash, KeyEqual>::find(const key_type& key) const
     {
-        const auto n = hash(key);
-        node_ptr first = buckets_[n];
-        for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-        return M_cit(first);
+        return M_cit(find_node(key));
     }
 
     // Find the number of occurrences of the key value key
@@ -1171,6 +1318,70 @@ namespace tinystl
         return result;
     }
 
+    // find_batch / count_batch
+    template <class T, class Hash, class KeyEqual>
+    template <class ForwardIter, class OutputIter>
+    OutputIter hashtable<T, Hash, KeyEqual>::
+    find_batch(ForwardIter first, ForwardIter last, OutputIter result)
+    {
+        const key_type* keys[ht_batch_size];
+        node_ptr nodes[ht_batch_size];
+        while (first != last)
+        {
+            size_type n = 0;
+            first = gather_batch(first, last, keys, n);
+            probe_batch(keys, nodes, n);
+            for (size_type i = 0; i < n; ++i)
+                *result++ = iterator(nodes[i], this);
+        }
+        return result;
+    }
+
+    template <class T, class Hash, class KeyEqual>
+    template <class ForwardIter, class OutputIter>
+    OutputIter hashtable<T, Hash, KeyEqual>::
+    find_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+    {
+        const key_type* keys[ht_batch_size];
+        node_ptr nodes[ht_batch_size];
+        while (first != last)
+        {
+            size_type n = 0;
+            first = gather_batch(first, last, keys, n);
+            probe_batch(keys, nodes, n);
+            for (size_type i = 0; i < n; ++i)
+                *result++ = M_cit(nodes[i]);
+        }
+        return result;
+    }
+
+    template <class T, class Hash, class KeyEqual>
+    template <class ForwardIter, class OutputIter>
+    OutputIter hashtable<T, Hash, KeyEqual>::
+    count_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+    {
+        const key_type* keys[ht_batch_size];
+        node_ptr nodes[ht_batch_size];
+        while (first != last)
+        {
+            size_type n = 0;
+            first = gather_batch(first, last, keys, n);
+            probe_batch(keys, nodes, n);
+            for (size_type i = 0; i < n; ++i)
+            {
+                // the rest of the chain is counted like count() does
+                size_type c = 0;
+                for (node_ptr cur = nodes[i]; cur; cur = cur->next)
+                {
+                    if (is_equal(value_traits::get_key(cur->value), *keys[i]))
+                        ++c;
+                }
+                *result++ = c;
+            }
+        }
+        return result;
+    }
+
     // Find the interval equal to the key value key, and return a pair, 
     // pointing to the beginning and end of the equal interval
     template <class T, class Hash, class KeyEqual>
@@ -1286,11 +1497,45 @@ namespace tinystl
             tinystl::swap(bucket_size_, rhs.bucket_size_);
             tinystl::swap(size_, rhs.size_);
             tinystl::swap(mlf_, rhs.mlf_);
+            tinystl::swap(min_lf_, rhs.min_lf_);
             tinystl::swap(hash_, rhs.hash_);
             tinystl::swap(equal_, rhs.equal_);
+            tinystl::swap(rehash_count_, rhs.rehash_count_);
+            tinystl::swap(sampler_, rhs.sampler_);
         }
     }
 
+    // stats
+    template <class T, class Hash, class KeyEqual>
+    ht_stats hashtable<T, Hash, KeyEqual>::stats() const noexcept
+    {
+        ht_stats s = {};
+        s.size = size_;
+        s.bucket_count = bucket_size_;
+        s.rehash_count = rehash_count_;
+        s.load_factor = load_factor();
+        size_type probes = 0;
+        for (size_type i = 0; i < bucket_size_; ++i)
+        {
+            size_type len = 0;
+            for (node_ptr cur = buckets_[i]; cur; cur = cur->next)
+                probes += ++len;
+            ++s.chain_histogram[tinystl::min(len, ht_histogram_size - 1)];
+            s.max_chain = tinystl::max(s.max_chain, len);
+        }
+        s.empty_buckets = s.chain_histogram[0];
+        const size_type used = bucket_size_ - s.empty_buckets;
+        s.empty_ratio = bucket_size_ == 0 ? 0.0 : (double)s.empty_buckets / (double)bucket_size_;
+        s.avg_chain = used == 0 ? 0.0 : (double)size_ / (double)used;
+        s.avg_probe = size_ == 0 ? 0.0 : (double)probes / (double)size_;
+
+        s.sampled_lookups = sampler_.lookups;
+        s.sampled_max_probe = sampler_.max_probe;
+        s.sampled_avg_probe = sampler_.lookups == 0
+            ? 0.0 : (double)sampler_.probes / (double)sampler_.lookups;
+        return s;
+    }
+
     // helper function=====================================================================
     // init 
     template <class T, class Hash, class KeyEqual>
@@ -1337,6 +1582,7 @@ namespace tinystl
             }
             bucket_size_ = ht.bucket_size_;
             mlf_ = ht.mlf_;
+            min_lf_ = ht.min_lf_;
             size_ = ht.size_;
         }
         catch (...)
@@ -1398,13 +1644,111 @@ namespace tinystl
         return hash_(key) % bucket_size_;
     }
 
+    // sampled_find_node: find_node that records the number of nodes it compared
+    template <class T, class Hash, class KeyEqual>
+    typename hashtable<T, Hash, KeyEqual>::node_ptr
+    hashtable<T, Hash, KeyEqual>::sampled_find_node(const key_type& key) const
+    {
+        sampler_.countdown = sampler_.period;
+        size_type probes = 0;
+        node_ptr first = buckets_[hash(key)];
+        for (; first; first = first->next)
+        {
+            ++probes;
+            if (is_equal(value_traits::get_key(first->value), key))
+                break;
+        }
+        ++sampler_.lookups;
+        sampler_.probes += probes;
+        sampler_.max_probe = tinystl::max(sampler_.max_probe, probes);
+        return first;
+    }
+
+    // gather_batch: the addresses of the next (at most ht_batch_size) keys
+    template <class T, class Hash, class KeyEqual>
+    template <class ForwardIter>
+    ForwardIter hashtable<T, Hash, KeyEqual>::
+    gather_batch(ForwardIter first, ForwardIter last, const key_type** keys, size_type& n) const
+    {
+        for (n = 0; first != last && n < ht_batch_size; ++first)
+            keys[n++] = tinystl::address_of(*first);
+        return first;
+    }
+
+    // probe_batch: nodes[i] = the first node that holds keys[i], nullptr if none
+    // three passes over the keys, each pass only touches memory that the previous one prefetched
+    template <class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    probe_batch(const key_type* const* keys, node_ptr* nodes, size_type n) const
+    {
+        size_type slots[ht_batch_size];
+        for (size_type i = 0; i < n; ++i)
+        {
+            slots[i] = hash(*keys[i]);
+            TINYSTL_PREFETCH(buckets_.data() + slots[i]);
+        }
+        for (size_type i = 0; i < n; ++i)
+        {
+            nodes[i] = buckets_[slots[i]];
+            if (nodes[i] != nullptr)
+                TINYSTL_PREFETCH(nodes[i]);
+        }
+        for (size_type i = 0; i < n; ++i)
+        {
+            node_ptr cur = nodes[i];
+            while (cur && !is_equal(value_traits::get_key(cur->value), *keys[i]))
+                cur = cur->next;
+            nodes[i] = cur;
+        }
+    }
+
     // rehash_if_need 
+    // grows straight to the bucket count that size() + n needs under max_load_factor(),
+    // with the same test as bucket_count_for, so an insert after reserve(n) never rehashes
     template <class T, class Hash, class KeyEqual>
     void hashtable<T, Hash, KeyEqual>::
     rehash_if_need(size_type n)
     {
-        if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
-            rehash(size_ + n);
+        if ((double)(size_ + n) > (double)bucket_size_ * (double)mlf_)
+            rehash(bucket_count_for(size_ + n));
+    }
+
+    // shrink_if_need
+    // below min_load_factor(), shrink to a load factor of about max_load_factor() / 2.
+    // The bucket counts are primes about 1.7 times apart, so the table shrinks at most
+    // once per 1.7 times fewer elements however low min_load_factor() is set
+    template <class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::shrink_if_need()
+    {
+        if (min_lf_ == 0.0f || (double)size_ >= (double)bucket_size_ * (double)min_lf_)
+            return;
+        const auto n = ht_next_prime(bucket_count_for(size_, mlf_ * 0.5f));
+        if (n >= bucket_size_)
+            return;
+        bucket_type bucket;
+        try
+        {
+            bucket.assign(n, nullptr);
+        }
+        catch (...)
+        {
+            return;  // shrinking is only a saving, the erase itself has succeeded
+        }
+        move_nodes(bucket);
+    }
+
+    // bucket_count_for
+    // the fewest buckets that hold count elements under the load factor lf
+    template <class T, class Hash, class KeyEqual>
+    typename hashtable<T, Hash, KeyEqual>::size_type
+    hashtable<T, Hash, KeyEqual>::bucket_count_for(size_type count, float lf) const
+    {
+        TINYSTL_DEBUG(lf > 0);
+        // in double: a float has 24 bits, (float)count is already off by a few above 16M
+        auto n = static_cast<size_type>(std::ceil((double)count / (double)lf));
+        while ((double)n * (double)lf < (double)count)
+            ++n;
+        return n;
     }
 
     // copy_insert
@@ -1412,9 +1756,9 @@ namespace tinystl
     template <class InputIter>
     void hashtable<T, Hash, KeyEqual>::copy_insert_multi(InputIter first, InputIter last, tinystl::input_iterator_tag)
     {
-        rehash_if_need(tinystl::distance(first, last));
+        // an input range can only be walked once, it can not be counted first
         for (; first != last; ++first)
-            insert_multi_noresize(*first);
+            insert_multi(*first);
     }
 
     template <class T, class Hash, class KeyEqual>
@@ -1431,9 +1775,9 @@ namespace tinystl
     template <class InputIter>
     void hashtable<T, Hash, KeyEqual>::copy_insert_unique(InputIter first, InputIter last, tinystl::input_iterator_tag)
     {
-        rehash_if_need(tinystl::distance(first, last));
+        // an input range can only be walked once, it can not be counted first
         for (; first != last; ++first)
-            insert_unique_noresize(*first);
+            insert_unique(*first);
     }
 
     template <class T, class Hash, class KeyEqual>
@@ -1506,36 +1850,57 @@ namespace tinystl
     void hashtable<T, Hash, KeyEqual>::replace_bucket(size_type bucket_count)
     {
         bucket_type bucket(bucket_count);
-        if (size_ != 0)
+        move_nodes(bucket);
+    }
+
+    // move_nodes
+    // relinks every node into bucket (all nullptr) and makes it the bucket array:
+    // no node is allocated or copied, only the bucket array changes.
+    // The nodes with equal keys are adjacent in a chain, such a run is moved as a whole,
+    // so they stay adjacent for equal_range_multi.
+    // If hash or key_equal throws, all the elements are destroyed (basic guarantee)
+    template <class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::move_nodes(bucket_type& bucket)
+    {
+        const size_type bucket_count = bucket.size();
+        size_type i = 0;
+        try
         {
-            for (size_type i = 0; i < bucket_size_; ++i)
+            for (; i < bucket_size_; ++i)
             {
-                for (auto first = buckets_[i]; first; first = first->next)
+                while (buckets_[i])
                 {
-                    auto tmp = create_node(first->value);
+                    node_ptr first = buckets_[i];
+                    node_ptr last = first;
+                    while (last->next && is_equal(value_traits::get_key(last->next->value),
+                                                  value_traits::get_key(first->value)))
+                        last = last->next;
                     const auto n = hash(value_traits::get_key(first->value), bucket_count);
-                    auto f = bucket[n];
-                    bool is_inserted = false;
-                    for (auto cur = f; cur; cur = cur->next)
-                    {
-                        if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value)))
-                        {
-                            tmp->next = cur->next;
-                            cur->next = tmp;
-                            is_inserted = true;
-                            break;
-                        }
-                        }
-                        if (!is_inserted)
-                        {
-                        tmp->next = f;
-                        bucket[n] = tmp;
-                    }
+                    buckets_[i] = last->next;
+                    last->next = bucket[n];
+                    bucket[n] = first;
+                }
+            }
+        }
+        catch (...)
+        {
+            for (size_type k = 0; k < bucket_count; ++k)
+            {
+                for (node_ptr cur = bucket[k]; cur; )
+                {
+                    node_ptr next = cur->next;
+                    destroy_node(cur);
+                    cur = next;
                 }
             }
+            for (; i < bucket_size_; ++i)
+                erase_bucket(i, nullptr);
+            size_ = 0;
+            throw;
         }
         buckets_.swap(bucket);
         bucket_size_ = buckets_.size();
+        ++rehash_count_;
     }
 
     // erase_bucket 
@@ -0,0 +1,734 @@
+#ifndef _INTERVAL_MAP_H_
+#define _INTERVAL_MAP_H_
+
+// interval_set : half-open intervals [low, high), sorted by low (then high),
+//                duplicates and overlapping intervals are allowed
+// interval_map : interval_set where every interval has a mapped value
+
+// notes:
+// Both are an rb_tree with rb_tree_interval_augment:
+// every node keeps the largest high of its subtree (max_high).
+// An overlap query for [a, b) walks the tree in order and skips
+//   * a subtree whose max_high <= a (every interval in it ends before a)
+//   * the right subtree of a node whose low >= b (every interval in it starts after b)
+// so find_overlap is O(log n) and for_each_overlap visits O(min(n, k log n)) nodes
+// for k results, instead of scanning all n intervals.
+//
+// [low, high) and [a, b) overlap when low < b && a < high,
+// so [1, 3) and [3, 5) do not overlap.
+// for_each_containing(p) is the point query: low <= p < high.
+// The bound type only needs operator<.
+//
+// The key of an element can not be changed, erase it and insert the new one.
+// The mapped value of interval_map can be changed, it is not part of the augmentation.
+
+// Exception guarantees:
+// tinystl::interval_set<T> / tinystl::interval_map<T, V>
+// Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace
+//   * insert
+
+#include "rb_tree.h"
+#include "vector.h"
+
+namespace tinystl
+{
+    // half-open interval [low, high)
+    template <class T>
+    struct interval
+    {
+        typedef T   bound_type;
+
+        T low;
+        T high;
+
+        interval() :low(), high() {}
+        interval(const T& l, const T& h) :low(l), high(h) {}
+
+        bool empty() const
+        { return !(low < high); }
+
+        bool contains(const T& point) const
+        { return !(point < low) && point < high; }
+
+        bool overlaps(const T& a, const T& b) const
+        { return low < b && a < high; }
+    };
+
+    template <class T>
+    interval<T> make_interval(const T& low, const T& high)
+    {
+        return interval<T>(low, high);
+    }
+
+    template <class T>
+    bool operator==(const interval<T>& lhs, const interval<T>& rhs)
+    {
+        return !(lhs.low < rhs.low) && !(rhs.low < lhs.low) &&
+               !(lhs.high < rhs.high) && !(rhs.high < lhs.high);
+    }
+
+    template <class T>
+    bool operator!=(const interval<T>& lhs, const interval<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // order by low, then by high
+    template <class T>
+    bool operator<(const interval<T>& lhs, const interval<T>& rhs)
+    {
+        return lhs.low < rhs.low || (!(rhs.low < lhs.low) && lhs.high < rhs.high);
+    }
+
+    //=========== augmentation ============================================================
+    // every node keeps the largest high of its subtree
+    template <class T>
+    struct rb_tree_interval_augment
+    {
+        typedef T   data_type;
+
+        template <class Value>
+        static void update(data_type& self, const Value& value,
+                           const data_type* left, const data_type* right)
+        {
+            self = rb_tree_value_traits<Value>::get_key(value).high;
+            if (left != nullptr && self < *left)
+                self = *left;
+            if (right != nullptr && self < *right)
+                self = *right;
+        }
+    };
+
+    //=========== overlap queries ==========================================================
+    // Tree is an rb_tree with rb_tree_interval_augment, Iter is its (const_)iterator
+
+    // some interval that overlaps [a, b), end if there is none
+    // if the left subtree may have one (max_high > a) go left: when it has none,
+    // its interval with high > a starts at or after b, so the right side has none either
+    template <class Iter, class Tree>
+    Iter interval_tree_find_overlap(const Tree& tree, const typename Tree::key_type::bound_type& a,
+                                    const typename Tree::key_type::bound_type& b, Iter end)
+    {
+        typedef typename Tree::value_traits value_traits;
+        auto x = tree.root_node();
+        while (x != nullptr)
+        {
+            const auto& key = value_traits::get_key(x->get_node_ptr()->value);
+            if (key.overlaps(a, b))
+                return Iter(x);
+            if (x->left != nullptr && a < Tree::augment_of(x->left))
+                x = x->left;
+            else
+                x = x->right;
+        }
+        return end;
+    }
+
+    // call f(Iter) for every interval that overlaps [a, b), in order
+    template <class Iter, class Tree, class Function>
+    void interval_tree_for_each_overlap(const Tree& tree, typename Tree::base_ptr x,
+                                        const typename Tree::key_type::bound_type& a,
+                                        const typename Tree::key_type::bound_type& b,
+                                        Function& f)
+    {
+        typedef typename Tree::value_traits value_traits;
+        // walk down the left spine with the recursion, the right child with the loop
+        while (x != nullptr && a < Tree::augment_of(x))
+        {
+            interval_tree_for_each_overlap<Iter>(tree, x->left, a, b, f);
+            const auto& key = value_traits::get_key(x->get_node_ptr()->value);
+            if (!(key.low < b))
+                return;  // x and its right subtree start at or after b
+            if (a < key.high)
+                f(Iter(x));
+            x = x->right;
+        }
+    }
+
+    // call f(Iter) for every interval containing the point p, in order
+    // the same walk, but a node with low == p is still a result
+    template <class Iter, class Tree, class Function>
+    void interval_tree_for_each_containing(const Tree& tree, typename Tree::base_ptr x,
+                                           const typename Tree::key_type::bound_type& p,
+                                           Function& f)
+    {
+        typedef typename Tree::value_traits value_traits;
+        while (x != nullptr && p < Tree::augment_of(x))
+        {
+            interval_tree_for_each_containing<Iter>(tree, x->left, p, f);
+            const auto& key = value_traits::get_key(x->get_node_ptr()->value);
+            if (p < key.low)
+                return;
+            if (p < key.high)
+                f(Iter(x));
+            x = x->right;
+        }
+    }
+
+    //======================================================================================
+    // interval_set
+    // first parameter: bound type, needs operator<
+    template <class T>
+    class interval_set
+    {
+    public:
+        typedef tinystl::interval<T>        key_type;
+        typedef tinystl::interval<T>        value_type;
+        typedef T                           bound_type;
+        typedef tinystl::less<key_type>     key_compare;
+        typedef tinystl::less<key_type>     value_compare;
+
+    private:
+        typedef tinystl::rb_tree<value_type, key_compare, rb_tree_interval_augment<T>>  base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::node_type              node_type;
+
+        typedef typename base_type::const_pointer          pointer;
+        typedef typename base_type::const_pointer          const_pointer;
+
+        typedef typename base_type::const_reference        reference;
+        typedef typename base_type::const_reference        const_reference;
+
+        typedef typename base_type::const_iterator         iterator;
+        typedef typename base_type::const_iterator         const_iterator;
+
+        typedef typename base_type::const_reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+
+        typedef typename base_type::size_type              size_type;
+        typedef typename base_type::difference_type        difference_type;
+        typedef typename base_type::allocator_type         allocator_type;
+
+    public:
+        // constructor
+        interval_set() = default;
+
+        template <class InputIterator>
+        interval_set(InputIterator first, InputIterator last): tree_()
+        { tree_.insert_multi(first, last); }
+
+        interval_set(std::initializer_list<value_type> ilist): tree_()
+        { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+        // copy constructor
+        interval_set(const interval_set& rhs): tree_(rhs.tree_)
+        {}
+
+        // move constructor
+        interval_set(interval_set&& rhs) noexcept: tree_(tinystl::move(rhs.tree_))
+        {}
+
+        // copy assignment
+        interval_set& operator=(const interval_set& rhs)
+        {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+        // move assignment
+        interval_set& operator=(interval_set&& rhs)
+        {
+            tree_ = tinystl::move(rhs.tree_);
+            return *this;
+        }
+        interval_set& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // interface
+        key_compare key_comp() const
+        { return tree_.key_comp(); }
+
+        value_compare value_comp() const
+        { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+        // iterator related operations
+        iterator begin() noexcept
+        { return tree_.begin(); }
+
+        const_iterator begin() const noexcept
+        { return tree_.begin(); }
+
+        iterator end() noexcept
+        { return tree_.end(); }
+
+        const_iterator end() const noexcept
+        { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return tree_.empty(); }
+
+        size_type size() const noexcept
+        { return tree_.size(); }
+
+        size_type max_size() const noexcept
+        { return tree_.max_size(); }
+
+        // insert / erase
+        template <class ...Args>
+        iterator emplace(Args&& ...args)
+        {
+            return tree_.emplace_multi(tinystl::forward<Args>(args)...);
+        }
+
+        iterator insert(const value_type& value)
+        {
+            TINYSTL_DEBUG(!(value.high < value.low));
+            return tree_.insert_multi(value);
+        }
+
+        iterator insert(const bound_type& low, const bound_type& high)
+        {
+            return insert(value_type(low, high));
+        }
+
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        {
+            tree_.insert_multi(first, last);
+        }
+
+        void erase(iterator position)
+        { tree_.erase(position); }
+
+        size_type erase(const key_type& key)
+        { return tree_.erase_multi(key); }
+
+        void erase(iterator first, iterator last)
+        { tree_.erase(first, last); }
+
+        void clear()
+        { tree_.clear(); }
+
+        // lookup by the whole interval
+        iterator find(const key_type& key)
+        { return tree_.find(key); }
+
+        const_iterator find(const key_type& key) const
+        { return tree_.find(key); }
+
+        size_type count(const key_type& key) const
+        { return tree_.count_multi(key); }
+
+        iterator lower_bound(const key_type& key)
+        { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type& key) const
+        { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key)
+        { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type& key) const
+        { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key)
+        { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        { return tree_.equal_range_multi(key); }
+
+        // overlap queries-----------------------------------------------------------------
+        // some interval overlapping [a, b), end() if there is none, O(log n)
+        const_iterator find_overlap(const bound_type& a, const bound_type& b) const
+        { return interval_tree_find_overlap<const_iterator>(tree_, a, b, end()); }
+
+        bool overlaps(const bound_type& a, const bound_type& b) const
+        { return find_overlap(a, b) != end(); }
+
+        // f(iterator) for every interval overlapping [a, b), in order
+        template <class Function>
+        Function for_each_overlap(const bound_type& a, const bound_type& b, Function f) const
+        {
+            interval_tree_for_each_overlap<const_iterator>(tree_, tree_.root_node(), a, b, f);
+            return f;
+        }
+
+        // every interval overlapping [a, b), in order
+        tinystl::vector<const_iterator> overlapping(const bound_type& a, const bound_type& b) const
+        {
+            tinystl::vector<const_iterator> result;
+            for_each_overlap(a, b, [&result](const_iterator it) { result.push_back(it); });
+            return result;
+        }
+
+        // f(iterator) for every interval containing the point p (low <= p < high), in order
+        template <class Function>
+        Function for_each_containing(const bound_type& p, Function f) const
+        {
+            interval_tree_for_each_containing<const_iterator>(tree_, tree_.root_node(), p, f);
+            return f;
+        }
+
+        void swap(interval_set& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const interval_set& lhs, const interval_set& rhs)
+        { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator< (const interval_set& lhs, const interval_set& rhs)
+        { return lhs.tree_ <  rhs.tree_; }
+    };
+
+    // overload comparison operations
+    template <class T>
+    bool operator!=(const interval_set<T>& lhs, const interval_set<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T>
+    bool operator>(const interval_set<T>& lhs, const interval_set<T>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T>
+    bool operator<=(const interval_set<T>& lhs, const interval_set<T>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T>
+    bool operator>=(const interval_set<T>& lhs, const interval_set<T>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // swap
+    template <class T>
+    void swap(interval_set<T>& lhs, interval_set<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    //======================================================================================
+    // interval_map
+    // first parameter: bound type, needs operator<
+    // second parameter: mapped type
+    template <class T, class V>
+    class interval_map
+    {
+    public:
+        typedef tinystl::interval<T>                key_type;
+        typedef V                                   mapped_type;
+        typedef tinystl::pair<const key_type, V>    value_type;
+        typedef T                                   bound_type;
+        typedef tinystl::less<key_type>             key_compare;
+
+    private:
+        typedef tinystl::rb_tree<value_type, key_compare, rb_tree_interval_augment<T>>  base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::node_type              node_type;
+
+        typedef typename base_type::pointer                pointer;
+        typedef typename base_type::const_pointer          const_pointer;
+
+        typedef typename base_type::reference              reference;
+        typedef typename base_type::const_reference        const_reference;
+
+        typedef typename base_type::iterator               iterator;
+        typedef typename base_type::const_iterator         const_iterator;
+
+        typedef typename base_type::reverse_iterator       reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+
+        typedef typename base_type::size_type              size_type;
+        typedef typename base_type::difference_type        difference_type;
+        typedef typename base_type::allocator_type         allocator_type;
+
+    public:
+        // constructor
+        interval_map() = default;
+
+        template <class InputIterator>
+        interval_map(InputIterator first, InputIterator last): tree_()
+        { tree_.insert_multi(first, last); }
+
+        interval_map(std::initializer_list<value_type> ilist): tree_()
+        { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+        // copy constructor
+        interval_map(const interval_map& rhs): tree_(rhs.tree_)
+        {}
+        // move constructor
+        interval_map(interval_map&& rhs) noexcept: tree_(tinystl::move(rhs.tree_))
+        {}
+
+        // copy assignment
+        interval_map& operator=(const interval_map& rhs)
+        {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+        // move assignment
+        interval_map& operator=(interval_map&& rhs)
+        {
+            tree_ = tinystl::move(rhs.tree_);
+            return *this;
+        }
+
+        interval_map& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // interface
+        key_compare key_comp() const
+        { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+        // iterator related operations
+        iterator begin() noexcept
+        { return tree_.begin(); }
+
+        const_iterator begin() const noexcept
+        { return tree_.begin(); }
+
+        iterator end() noexcept
+        { return tree_.end(); }
+
+        const_iterator end() const noexcept
+        { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // capacity
+        bool empty() const noexcept
+        { return tree_.empty(); }
+
+        size_type size() const noexcept
+        { return tree_.size(); }
+
+        size_type max_size() const noexcept
+        { return tree_.max_size(); }
+
+        // insert / erase
+        template <class ...Args>
+        iterator emplace(Args&& ...args)
+        {
+            return tree_.emplace_multi(tinystl::forward<Args>(args)...);
+        }
+
+        iterator insert(const value_type& value)
+        {
+            TINYSTL_DEBUG(!(value.first.high < value.first.low));
+            return tree_.insert_multi(value);
+        }
+
+        iterator insert(const bound_type& low, const bound_type& high, const mapped_type& value)
+        {
+            return insert(value_type(key_type(low, high), value));
+        }
+
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        {
+            tree_.insert_multi(first, last);
+        }
+
+        void erase(iterator position)
+        { tree_.erase(position); }
+
+        size_type erase(const key_type& key)
+        { return tree_.erase_multi(key); }
+
+        void erase(iterator first, iterator last)
+        { tree_.erase(first, last); }
+
+        void clear()
+        { tree_.clear(); }
+
+        // lookup by the whole interval
+        iterator find(const key_type& key)
+        { return tree_.find(key); }
+
+        const_iterator find(const key_type& key) const
+        { return tree_.find(key); }
+
+        size_type count(const key_type& key) const
+        { return tree_.count_multi(key); }
+
+        iterator lower_bound(const key_type& key)
+        { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type& key) const
+        { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key)
+        { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type& key) const
+        { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key)
+        { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        { return tree_.equal_range_multi(key); }
+
+        // overlap queries-----------------------------------------------------------------
+        // some interval overlapping [a, b), end() if there is none, O(log n)
+        iterator find_overlap(const bound_type& a, const bound_type& b)
+        { return interval_tree_find_overlap<iterator>(tree_, a, b, end()); }
+
+        const_iterator find_overlap(const bound_type& a, const bound_type& b) const
+        { return interval_tree_find_overlap<const_iterator>(tree_, a, b, end()); }
+
+        bool overlaps(const bound_type& a, const bound_type& b) const
+        { return find_overlap(a, b) != end(); }
+
+        // f(iterator) for every interval overlapping [a, b), in order,
+        // f may change the mapped value
+        template <class Function>
+        Function for_each_overlap(const bound_type& a, const bound_type& b, Function f)
+        {
+            interval_tree_for_each_overlap<iterator>(tree_, tree_.root_node(), a, b, f);
+            return f;
+        }
+
+        template <class Function>
+        Function for_each_overlap(const bound_type& a, const bound_type& b, Function f) const
+        {
+            interval_tree_for_each_overlap<const_iterator>(tree_, tree_.root_node(), a, b, f);
+            return f;
+        }
+
+        // every interval overlapping [a, b), in order
+        tinystl::vector<iterator> overlapping(const bound_type& a, const bound_type& b)
+        {
+            tinystl::vector<iterator> result;
+            for_each_overlap(a, b, [&result](iterator it) { result.push_back(it); });
+            return result;
+        }
+
+        tinystl::vector<const_iterator> overlapping(const bound_type& a, const bound_type& b) const
+        {
+            tinystl::vector<const_iterator> result;
+            for_each_overlap(a, b, [&result](const_iterator it) { result.push_back(it); });
+            return result;
+        }
+
+        // f(iterator) for every interval containing the point p (low <= p < high), in order
+        template <class Function>
+        Function for_each_containing(const bound_type& p, Function f)
+        {
+            interval_tree_for_each_containing<iterator>(tree_, tree_.root_node(), p, f);
+            return f;
+        }
+
+        template <class Function>
+        Function for_each_containing(const bound_type& p, Function f) const
+        {
+            interval_tree_for_each_containing<const_iterator>(tree_, tree_.root_node(), p, f);
+            return f;
+        }
+
+        void swap(interval_map& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const interval_map& lhs, const interval_map& rhs)
+        { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator< (const interval_map& lhs, const interval_map& rhs)
+        { return lhs.tree_ <  rhs.tree_; }
+    };
+
+    // overload comparison operations
+    template <class T, class V>
+    bool operator!=(const interval_map<T, V>& lhs, const interval_map<T, V>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class V>
+    bool operator>(const interval_map<T, V>& lhs, const interval_map<T, V>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, class V>
+    bool operator<=(const interval_map<T, V>& lhs, const interval_map<T, V>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, class V>
+    bool operator>=(const interval_map<T, V>& lhs, const interval_map<T, V>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // swap
+    template <class T, class V>
+    void swap(interval_map<T, V>& lhs, interval_map<T, V>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif
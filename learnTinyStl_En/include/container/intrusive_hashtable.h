@@ -0,0 +1,711 @@
+#ifndef _INTRUSIVE_HASHTABLE_H_
+#define _INTRUSIVE_HASHTABLE_H_
+
+// intrusive_hashtable : chained hash table whose links live inside the elements
+
+// notes:
+// An element type derives from ht_base_hook<Tag> to be put into an intrusive_hashtable,
+// the Tag allows one object to be in several tables (or also in an intrusive_list):
+//
+//     struct conn : tinystl::ht_base_hook<>, tinystl::list_base_hook<> { int fd; ... };
+//     struct conn_fd { int operator()(const conn& c) const { return c.fd; } };
+//     tinystl::intrusive_hashtable<conn, tinystl::hash<int>, tinystl::equal_to<int>, conn_fd> by_fd;
+//
+// KeyOfValue extracts the key from an element, by default the element is its own key.
+// The table never allocates per element, never copies and never destroys the elements,
+// only the bucket array is allocated, when it grows (call reserve() up front to avoid it).
+//
+// The hook keeps the hash of its element, and the address of the pointer that points to it
+// (the bucket slot or the previous hook's next), so:
+//   * erase(obj) unlinks an element in O(1), without hashing or walking its bucket
+//   * rehash moves the hooks without calling the hash function again
+//
+// The buckets use the prime sizes and the load factor rules of hashtable.h.
+
+#include <type_traits>
+
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+#include "hashtable.h"
+
+namespace tinystl
+{
+
+    // ht_base_hook
+    template <class Tag = void>
+    struct ht_base_hook
+    {
+        ht_base_hook*  next;   // next hook in the bucket
+        ht_base_hook** pprev;  // the pointer that points to this hook
+        size_t         hash;   // hash of the element's key
+
+        ht_base_hook() noexcept :next(nullptr), pprev(nullptr), hash(0)
+        {}
+
+        // A copied object is not in any table
+        ht_base_hook(const ht_base_hook&) noexcept :next(nullptr), pprev(nullptr), hash(0)
+        {}
+
+        ht_base_hook& operator=(const ht_base_hook&) noexcept
+        { return *this; }
+
+        ~ht_base_hook()
+        {
+            // the element must be erased from its table before it dies
+            TINYSTL_DEBUG(!is_linked());
+        }
+
+        bool is_linked() const noexcept
+        { return pprev != nullptr; }
+    };
+
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    class intrusive_hashtable;
+
+    // iterator
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag, bool IsConst>
+    struct iht_iterator :public tinystl::iterator<tinystl::forward_iterator_tag, T>
+    {
+        typedef intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>    hashtable;
+        typedef iht_iterator<T, Hash, KeyEqual, KeyOfValue, Tag, IsConst>  self;
+        typedef ht_base_hook<Tag>*                                          base_ptr;
+
+        typedef T                                                       value_type;
+        typedef typename std::conditional<IsConst, const T*, T*>::type  pointer;
+        typedef typename std::conditional<IsConst, const T&, T&>::type  reference;
+
+        base_ptr         node;  // the hook currently pointed by the iterator
+        const hashtable* ht;    // keep connecting with the container
+
+        iht_iterator() = default;
+        iht_iterator(base_ptr n, const hashtable* t) :node(n), ht(t)
+        {}
+
+        // iterator to const_iterator
+        template <bool C, typename std::enable_if<IsConst && !C, int>::type = 0>
+        iht_iterator(const iht_iterator<T, Hash, KeyEqual, KeyOfValue, Tag, C>& rhs)
+            :node(rhs.node), ht(rhs.ht)
+        {}
+
+        reference operator*() const
+        { return static_cast<reference>(*node); }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node != nullptr);
+            const base_ptr old = node;
+            node = node->next;
+            if (node == nullptr)
+            {
+                // skip to the beginning of the next bucket, the hash is kept in the hook
+                auto index = old->hash % ht->bucket_size_;
+                while (!node && ++index < ht->bucket_size_)
+                    node = ht->buckets_[index];
+            }
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return node == rhs.node; }
+
+        bool operator!=(const self& rhs) const
+        { return node != rhs.node; }
+    };
+
+    // local iterator : walks one bucket
+    template <class T, class Tag, bool IsConst>
+    struct iht_local_iterator :public tinystl::iterator<tinystl::forward_iterator_tag, T>
+    {
+        typedef iht_local_iterator<T, Tag, IsConst>    self;
+        typedef ht_base_hook<Tag>*                      base_ptr;
+
+        typedef T                                                       value_type;
+        typedef typename std::conditional<IsConst, const T*, T*>::type  pointer;
+        typedef typename std::conditional<IsConst, const T&, T&>::type  reference;
+
+        base_ptr node;
+
+        iht_local_iterator(base_ptr n = nullptr) :node(n)
+        {}
+
+        template <bool C, typename std::enable_if<IsConst && !C, int>::type = 0>
+        iht_local_iterator(const iht_local_iterator<T, Tag, C>& rhs) :node(rhs.node)
+        {}
+
+        reference operator*() const
+        { return static_cast<reference>(*node); }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node != nullptr);
+            node = node->next;
+            return *this;
+        }
+
+        self operator++(int)
+        {
+            self tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& other) const
+        { return node == other.node; }
+
+        bool operator!=(const self& other) const
+        { return node != other.node; }
+    };
+
+    //=============intrusive_hashtable=====================================================
+    // first parameter: element type, derived from ht_base_hook<Tag>
+    // second parameter: hash function of the key
+    // third parameter: key's comparison function
+    // fourth parameter: gets the key of an element
+    // fifth parameter: selects the hook
+    template <class T, class Hash, class KeyEqual,
+              class KeyOfValue = tinystl::identity<T>, class Tag = void>
+    class intrusive_hashtable
+    {
+        friend struct tinystl::iht_iterator<T, Hash, KeyEqual, KeyOfValue, Tag, false>;
+        friend struct tinystl::iht_iterator<T, Hash, KeyEqual, KeyOfValue, Tag, true>;
+
+    public:
+        typedef ht_base_hook<Tag>   hook_type;
+        typedef hook_type*          base_ptr;
+
+        typedef typename std::decay<decltype(
+            std::declval<const KeyOfValue&>()(std::declval<const T&>()))>::type key_type;
+        // what KeyOfValue returns: a reference into the element, or the key by value
+        typedef typename std::conditional<std::is_lvalue_reference<decltype(
+            std::declval<const KeyOfValue&>()(std::declval<const T&>()))>::value,
+            const key_type&, key_type>::type key_result;
+        typedef T                   value_type;
+        typedef Hash                hasher;
+        typedef KeyEqual            key_equal;
+
+        typedef tinystl::vector<base_ptr>   bucket_type;
+
+        typedef T*                  pointer;
+        typedef const T*            const_pointer;
+        typedef T&                  reference;
+        typedef const T&            const_reference;
+        typedef size_t              size_type;
+        typedef ptrdiff_t           difference_type;
+
+        typedef iht_iterator<T, Hash, KeyEqual, KeyOfValue, Tag, false>  iterator;
+        typedef iht_iterator<T, Hash, KeyEqual, KeyOfValue, Tag, true>   const_iterator;
+        typedef iht_local_iterator<T, Tag, false>                        local_iterator;
+        typedef iht_local_iterator<T, Tag, true>                         const_local_iterator;
+
+    private:
+        bucket_type buckets_;
+        size_type   bucket_size_;
+        size_type   size_;
+        float       mlf_;
+        hasher      hash_;
+        key_equal   equal_;
+        KeyOfValue  get_key_;
+
+    public:
+        // constructor
+        explicit intrusive_hashtable(size_type bucket_count = 100, const Hash& hash = Hash(),
+                                     const KeyEqual& equal = KeyEqual(),
+                                     const KeyOfValue& get_key = KeyOfValue())
+            :size_(0), mlf_(1.0f), hash_(hash), equal_(equal), get_key_(get_key)
+        {
+            buckets_.assign(ht_next_prime(bucket_count), nullptr);
+            bucket_size_ = buckets_.size();
+        }
+
+        intrusive_hashtable(const intrusive_hashtable&) = delete;
+        intrusive_hashtable& operator=(const intrusive_hashtable&) = delete;
+
+        // the bucket array moves with its hooks, the moved-from table is empty
+        intrusive_hashtable(intrusive_hashtable&& rhs) noexcept
+            :buckets_(tinystl::move(rhs.buckets_)), bucket_size_(rhs.bucket_size_),
+             size_(rhs.size_), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_),
+             get_key_(rhs.get_key_)
+        {
+            rhs.bucket_size_ = 0;
+            rhs.size_ = 0;
+        }
+
+        intrusive_hashtable& operator=(intrusive_hashtable&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                clear();
+                intrusive_hashtable tmp(tinystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~intrusive_hashtable()
+        { clear(); }
+
+        // iterator related operations-----------------------------------------------------
+        iterator begin() noexcept
+        { return iterator(first_node(), this); }
+
+        const_iterator begin() const noexcept
+        { return const_iterator(first_node(), this); }
+
+        iterator end() noexcept
+        { return iterator(nullptr, this); }
+
+        const_iterator end() const noexcept
+        { return const_iterator(nullptr, this); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // the iterator of an element that is linked into this table, O(1)
+        iterator iterator_to(reference value) noexcept
+        {
+            TINYSTL_DEBUG(as_hook(value)->is_linked());
+            return iterator(as_hook(value), this);
+        }
+
+        const_iterator iterator_to(const_reference value) const noexcept
+        {
+            TINYSTL_DEBUG(as_hook(const_cast<reference>(value))->is_linked());
+            return const_iterator(as_hook(const_cast<reference>(value)), this);
+        }
+
+        // container related operations----------------------------------------------------
+        bool empty() const noexcept
+        { return size_ == 0; }
+
+        size_type size() const noexcept
+        { return size_; }
+
+        size_type max_size() const noexcept
+        { return static_cast<size_type>(-1); }
+
+        // insert : link value into the table, value must not be linked by this hook
+        // the key values are not allowed to be repeated
+        pair<iterator, bool> insert_unique(reference value);
+
+        // the key values are allowed to be repeated, equal keys are kept next to each other
+        iterator insert_multi(reference value);
+
+        // erase : unlink the elements, they are not destroyed
+        void erase(const_iterator position) noexcept
+        {
+            TINYSTL_DEBUG(position.node != nullptr);
+            unlink_node(position.node);
+        }
+
+        void erase(const_iterator first, const_iterator last) noexcept
+        {
+            while (first != last)
+                erase(first++);
+        }
+
+        // unlink value from this table in O(1)
+        void erase(reference value) noexcept
+        {
+            TINYSTL_DEBUG(as_hook(value)->is_linked());
+            unlink_node(as_hook(value));
+        }
+
+        size_type erase_multi(const key_type& key);
+        size_type erase_unique(const key_type& key);
+
+        void clear() noexcept;
+        void swap(intrusive_hashtable& rhs) noexcept;
+
+        // find
+        size_type count(const key_type& key) const;
+
+        iterator find(const key_type& key)
+        { return iterator(find_node(key), this); }
+
+        const_iterator find(const key_type& key) const
+        { return const_iterator(find_node(key), this); }
+
+        pair<iterator, iterator> equal_range_multi(const key_type& key);
+        pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const;
+
+        pair<iterator, iterator> equal_range_unique(const key_type& key);
+        pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
+
+        // bucket interface
+        local_iterator begin(size_type n) noexcept
+        {
+            TINYSTL_DEBUG(n < bucket_size_);
+            return buckets_[n];
+        }
+        const_local_iterator begin(size_type n) const noexcept
+        {
+            TINYSTL_DEBUG(n < bucket_size_);
+            return buckets_[n];
+        }
+        const_local_iterator cbegin(size_type n) const noexcept
+        { return begin(n); }
+
+        local_iterator end(size_type n) noexcept
+        {
+            TINYSTL_DEBUG(n < bucket_size_);
+            return nullptr;
+        }
+        const_local_iterator end(size_type n) const noexcept
+        {
+            TINYSTL_DEBUG(n < bucket_size_);
+            return nullptr;
+        }
+        const_local_iterator cend(size_type n) const noexcept
+        { return end(n); }
+
+        size_type bucket_count() const noexcept
+        { return bucket_size_; }
+
+        size_type max_bucket_count() const noexcept
+        { return ht_prime_list[PRIME_NUM - 1]; }
+
+        size_type bucket_size(size_type n) const noexcept;
+
+        size_type bucket(const key_type& key) const
+        { return hash_(key) % bucket_size_; }
+
+        // hash policy
+        float load_factor() const noexcept
+        { return bucket_size_ != 0 ? (float)size_ / bucket_size_ : 0.0f; }
+
+        float max_load_factor() const noexcept
+        { return mlf_; }
+
+        void max_load_factor(float ml)
+        {
+            THROW_OUT_OF_RANGE_IF(ml != ml || ml < 0, "invalid hash load factor");
+            mlf_ = ml;
+        }
+
+        void rehash(size_type count);
+
+        void reserve(size_type count)
+        { rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); }
+
+        hasher    hash_fcn() const { return hash_; }
+        key_equal key_eq()   const { return equal_; }
+
+    private:
+        // helper functions
+        static base_ptr as_hook(reference value) noexcept
+        { return static_cast<base_ptr>(tinystl::address_of(value)); }
+
+        key_result key_of(base_ptr p) const
+        { return get_key_(static_cast<const_reference>(*p)); }
+
+        base_ptr first_node() const noexcept
+        {
+            for (size_type n = 0; n < bucket_size_; ++n)
+            {
+                if (buckets_[n])
+                    return buckets_[n];
+            }
+            return nullptr;
+        }
+
+        // link n in front of the hook *pp points to
+        static void link_node(base_ptr* pp, base_ptr n) noexcept
+        {
+            n->next = *pp;
+            if (n->next)
+                n->next->pprev = &n->next;
+            *pp = n;
+            n->pprev = pp;
+        }
+
+        void unlink_node(base_ptr n) noexcept
+        {
+            *n->pprev = n->next;
+            if (n->next)
+                n->next->pprev = n->pprev;
+            n->next = nullptr;
+            n->pprev = nullptr;
+            --size_;
+        }
+
+        base_ptr find_node(const key_type& key) const;
+        void rehash_if_need(size_type n);
+        void replace_bucket(size_type bucket_count);
+    };
+
+    //========implement====================================================================
+
+    // Link a new element, the key value does not allow duplicates
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    pair<typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::iterator, bool>
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::insert_unique(reference value)
+    {
+        auto np = as_hook(value);
+        TINYSTL_DEBUG(!np->is_linked());
+        const auto& key = get_key_(value);
+        const size_t h = hash_(key);
+        if (bucket_size_ != 0)
+        {
+            for (auto cur = buckets_[h % bucket_size_]; cur; cur = cur->next)
+            {
+                if (cur->hash == h && equal_(key_of(cur), key))
+                    return tinystl::make_pair(iterator(cur, this), false);
+            }
+        }
+        rehash_if_need(1);
+        np->hash = h;
+        link_node(&buckets_[h % bucket_size_], np);
+        ++size_;
+        return tinystl::make_pair(iterator(np, this), true);
+    }
+
+    // Link a new element, key values allow duplicates
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::iterator
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::insert_multi(reference value)
+    {
+        auto np = as_hook(value);
+        TINYSTL_DEBUG(!np->is_linked());
+        rehash_if_need(1);
+        const auto& key = get_key_(value);
+        const size_t h = hash_(key);
+        np->hash = h;
+        auto pp = &buckets_[h % bucket_size_];
+        for (auto cur = *pp; cur; cur = cur->next)
+        {
+            if (cur->hash == h && equal_(key_of(cur), key))
+            {
+                // link it right after the equal element
+                pp = &cur->next;
+                break;
+            }
+        }
+        link_node(pp, np);
+        ++size_;
+        return iterator(np, this);
+    }
+
+    // Unlink all the elements whose key is key
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::size_type
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::erase_multi(const key_type& key)
+    {
+        auto p = equal_range_multi(key);
+        size_type n = 0;
+        while (p.first != p.second)
+        {
+            erase(p.first++);
+            ++n;
+        }
+        return n;
+    }
+
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::size_type
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::erase_unique(const key_type& key)
+    {
+        auto np = find_node(key);
+        if (np == nullptr)
+            return 0;
+        unlink_node(np);
+        return 1;
+    }
+
+    // Unlink every element
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    void intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::clear() noexcept
+    {
+        for (size_type i = 0; i < bucket_size_; ++i)
+        {
+            auto cur = buckets_[i];
+            while (cur != nullptr)
+            {
+                auto next = cur->next;
+                cur->next = nullptr;
+                cur->pprev = nullptr;
+                cur = next;
+            }
+            buckets_[i] = nullptr;
+        }
+        size_ = 0;
+    }
+
+    // Swap the tables, the hooks keep pointing into their bucket arrays
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    void intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::
+    swap(intrusive_hashtable& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            buckets_.swap(rhs.buckets_);
+            tinystl::swap(bucket_size_, rhs.bucket_size_);
+            tinystl::swap(size_, rhs.size_);
+            tinystl::swap(mlf_, rhs.mlf_);
+            tinystl::swap(hash_, rhs.hash_);
+            tinystl::swap(equal_, rhs.equal_);
+            tinystl::swap(get_key_, rhs.get_key_);
+        }
+    }
+
+    // Find the number of occurrences of the key value key
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::size_type
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::count(const key_type& key) const
+    {
+        size_type result = 0;
+        auto cur = find_node(key);
+        for (; cur && equal_(key_of(cur), key); cur = cur->next)
+            ++result;
+        return result;
+    }
+
+    // Find the first element whose key value is key
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::base_ptr
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::find_node(const key_type& key) const
+    {
+        if (size_ == 0)
+            return nullptr;
+        const size_t h = hash_(key);
+        auto cur = buckets_[h % bucket_size_];
+        for (; cur && !(cur->hash == h && equal_(key_of(cur), key)); cur = cur->next) {}
+        return cur;
+    }
+
+    // Find the range of elements whose key value is key
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    pair<typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::iterator,
+         typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::iterator>
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::equal_range_multi(const key_type& key)
+    {
+        auto first = find_node(key);
+        if (first == nullptr)
+            return tinystl::make_pair(end(), end());
+        auto last = iterator(first, this);
+        for (++last; last.node && equal_(key_of(last.node), key); ++last) {}
+        return tinystl::make_pair(iterator(first, this), last);
+    }
+
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    pair<typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::const_iterator,
+         typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::const_iterator>
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::
+    equal_range_multi(const key_type& key) const
+    {
+        auto first = find_node(key);
+        if (first == nullptr)
+            return tinystl::make_pair(end(), end());
+        auto last = const_iterator(first, this);
+        for (++last; last.node && equal_(key_of(last.node), key); ++last) {}
+        return tinystl::make_pair(const_iterator(first, this), last);
+    }
+
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    pair<typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::iterator,
+         typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::iterator>
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::equal_range_unique(const key_type& key)
+    {
+        auto first = find_node(key);
+        if (first == nullptr)
+            return tinystl::make_pair(end(), end());
+        auto last = iterator(first, this);
+        return tinystl::make_pair(iterator(first, this), ++last);
+    }
+
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    pair<typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::const_iterator,
+         typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::const_iterator>
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::
+    equal_range_unique(const key_type& key) const
+    {
+        auto first = find_node(key);
+        if (first == nullptr)
+            return tinystl::make_pair(end(), end());
+        auto last = const_iterator(first, this);
+        return tinystl::make_pair(const_iterator(first, this), ++last);
+    }
+
+    // Number of elements in bucket n
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    typename intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::size_type
+    intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::bucket_size(size_type n) const noexcept
+    {
+        size_type result = 0;
+        for (auto cur = buckets_[n]; cur; cur = cur->next)
+            ++result;
+        return result;
+    }
+
+    // Rebuild the buckets, same rule as hashtable::rehash
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    void intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::rehash(size_type count)
+    {
+        auto n = ht_next_prime(count);
+        if (n > bucket_size_)
+        {
+            replace_bucket(n);
+        }
+        else
+        {
+            if ((float)size_ / (float)n < max_load_factor() - 0.25f &&
+                (float)n < (float)bucket_size_ * 0.75)  // worth rehash
+            {
+                replace_bucket(n);
+            }
+        }
+    }
+
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    void intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::rehash_if_need(size_type n)
+    {
+        if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
+            rehash(size_ + n);
+    }
+
+    // Move every hook to the new bucket array, using the hash kept in the hook.
+    // A run of equal keys is moved one after another to the same bucket, so it stays together
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    void intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>::replace_bucket(size_type bucket_count)
+    {
+        bucket_type bucket(bucket_count, nullptr);
+        for (size_type i = 0; i < bucket_size_; ++i)
+        {
+            auto cur = buckets_[i];
+            while (cur != nullptr)
+            {
+                auto next = cur->next;
+                link_node(&bucket[cur->hash % bucket_count], cur);
+                cur = next;
+            }
+        }
+        buckets_.swap(bucket);
+        bucket_size_ = buckets_.size();
+    }
+
+    // overload tinystl's swap
+    template <class T, class Hash, class KeyEqual, class KeyOfValue, class Tag>
+    void swap(intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>& lhs,
+              intrusive_hashtable<T, Hash, KeyEqual, KeyOfValue, Tag>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+}
+#endif
@@ -0,0 +1,629 @@
+#ifndef _INTRUSIVE_LIST_H_
+#define _INTRUSIVE_LIST_H_
+
+// intrusive_list : circular doubly linked list whose links live inside the elements
+
+// notes:
+// An element type derives from list_base_hook<Tag> to be put into an intrusive_list<T, Tag>,
+// use different Tags to put the same object into several lists at once:
+//
+//     struct conn : tinystl::list_base_hook<>, tinystl::list_base_hook<lru_tag> { ... };
+//     tinystl::intrusive_list<conn> active;
+//     tinystl::intrusive_list<conn, lru_tag> lru;
+//
+// The list never allocates, never copies and never destroys the elements,
+// it only links and unlinks them, so the owner keeps them alive while they are linked.
+// erase(obj) unlinks an element in O(1) without searching it.
+//
+// The sentinel is a member of the list, so a list object holds its elements by address:
+// moving a list relinks the first and last elements to the new sentinel.
+//
+// All operations are noexcept except sort / merge / remove_if / unique, which call the
+// user's functors. If those throw, every element stays linked.
+
+#include "iterator.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "list.h"
+
+namespace tinystl
+{
+
+    // list_base_hook
+    // Tag allows one object to have several hooks
+    template <class Tag = void>
+    struct list_base_hook
+    {
+        list_base_hook* prev;
+        list_base_hook* next;
+
+        list_base_hook() noexcept :prev(nullptr), next(nullptr)
+        {}
+
+        // A copied object is not in any list
+        list_base_hook(const list_base_hook&) noexcept :prev(nullptr), next(nullptr)
+        {}
+
+        list_base_hook& operator=(const list_base_hook&) noexcept
+        { return *this; }
+
+        ~list_base_hook()
+        {
+            // the element must be erased from its list before it dies
+            TINYSTL_DEBUG(!is_linked());
+        }
+
+        bool is_linked() const noexcept
+        { return next != nullptr; }
+    };
+
+    // intrusive_list iterator------------------------------------------------------------
+    template <class T, class Tag>
+    struct intrusive_list_iterator : public tinystl::iterator<tinystl::bidirectional_iterator_tag, T>
+    {
+        typedef T                               value_type;
+        typedef T*                              pointer;
+        typedef T&                              reference;
+        typedef intrusive_list_iterator<T, Tag> self;
+
+        typedef list_base_hook<Tag>*            base_ptr;
+
+        base_ptr node_;
+
+        intrusive_list_iterator() = default;
+        intrusive_list_iterator(base_ptr x) :node_(x)
+        {}
+
+        reference operator*() const
+        { return static_cast<reference>(*node_); }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node_ != nullptr);
+            node_ = node_->next;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--()
+        {
+            TINYSTL_DEBUG(node_ != nullptr);
+            node_ = node_->prev;
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return node_ == rhs.node_; }
+
+        bool operator!=(const self& rhs) const
+        { return node_ != rhs.node_; }
+    };
+
+    template <class T, class Tag>
+    struct intrusive_list_const_iterator
+        : public tinystl::iterator<tinystl::bidirectional_iterator_tag, T>
+    {
+        typedef T                                       value_type;
+        typedef const T*                                pointer;
+        typedef const T&                                reference;
+        typedef intrusive_list_const_iterator<T, Tag>   self;
+
+        typedef list_base_hook<Tag>*                    base_ptr;
+
+        base_ptr node_;
+
+        intrusive_list_const_iterator() = default;
+        intrusive_list_const_iterator(base_ptr x) :node_(x)
+        {}
+
+        intrusive_list_const_iterator(const intrusive_list_iterator<T, Tag>& rhs) :node_(rhs.node_)
+        {}
+
+        reference operator*() const
+        { return static_cast<reference>(*node_); }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node_ != nullptr);
+            node_ = node_->next;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--()
+        {
+            TINYSTL_DEBUG(node_ != nullptr);
+            node_ = node_->prev;
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return node_ == rhs.node_; }
+
+        bool operator!=(const self& rhs) const
+        { return node_ != rhs.node_; }
+    };
+
+    //=================== intrusive_list template ============================================
+    template <class T, class Tag = void>
+    class intrusive_list
+    {
+    public:
+        typedef list_base_hook<Tag>     hook_type;
+
+        typedef T                       value_type;
+        typedef T*                      pointer;
+        typedef const T*                const_pointer;
+        typedef T&                      reference;
+        typedef const T&                const_reference;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+
+        typedef intrusive_list_iterator<T, Tag>             iterator;
+        typedef intrusive_list_const_iterator<T, Tag>       const_iterator;
+        typedef tinystl::reverse_iterator<iterator>         reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+        typedef hook_type*  base_ptr;
+
+    private:
+        mutable hook_type node_;  // sentinel, node_.next is the first element
+        size_type         size_;
+
+    public:
+        // constructor
+        intrusive_list() noexcept :size_(0)
+        { node_.prev = node_.next = &node_; }
+
+        intrusive_list(const intrusive_list&) = delete;
+        intrusive_list& operator=(const intrusive_list&) = delete;
+
+        intrusive_list(intrusive_list&& rhs) noexcept :size_(0)
+        {
+            node_.prev = node_.next = &node_;
+            splice(end(), rhs);
+        }
+
+        intrusive_list& operator=(intrusive_list&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                clear();
+                splice(end(), rhs);
+            }
+            return *this;
+        }
+
+        ~intrusive_list()
+        {
+            clear();
+            node_.prev = node_.next = nullptr;
+        }
+
+    public:
+        // iterator operation----------------------------------------------------------------
+        iterator begin() noexcept
+        { return iterator(node_.next); }
+
+        const_iterator begin() const noexcept
+        { return const_iterator(node_.next); }
+
+        iterator end() noexcept
+        { return iterator(&node_); }
+
+        const_iterator end() const noexcept
+        { return const_iterator(&node_); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // the iterator of an element that is linked into this list, O(1)
+        iterator iterator_to(reference value) noexcept
+        {
+            TINYSTL_DEBUG(as_hook(value)->is_linked());
+            return iterator(as_hook(value));
+        }
+
+        const_iterator iterator_to(const_reference value) const noexcept
+        {
+            TINYSTL_DEBUG(as_hook(const_cast<reference>(value))->is_linked());
+            return const_iterator(as_hook(const_cast<reference>(value)));
+        }
+
+        // container operation---------------------------------------------------------------
+        bool empty() const noexcept
+        { return node_.next == &node_; }
+
+        size_type size() const noexcept
+        { return size_; }
+
+        size_type max_size() const noexcept
+        { return static_cast<size_type>(-1); }
+
+        // visit element---------------------------------------------------------------------
+        reference front() noexcept
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        const_reference front() const noexcept
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        reference back() noexcept
+        {
+            TINYSTL_DEBUG(!empty());
+            return *(--end());
+        }
+
+        const_reference back() const noexcept
+        {
+            TINYSTL_DEBUG(!empty());
+            return *(--end());
+        }
+
+        // adjust container operation--------------------------------------------------------
+        // insert : link value before pos, value must not be linked by this hook
+        iterator insert(const_iterator pos, reference value) noexcept
+        {
+            auto p = as_hook(value);
+            TINYSTL_DEBUG(!p->is_linked());
+            link_nodes(pos.node_, p, p);
+            ++size_;
+            return iterator(p);
+        }
+
+        void push_front(reference value) noexcept
+        { insert(begin(), value); }
+
+        void push_back(reference value) noexcept
+        { insert(end(), value); }
+
+        void pop_front() noexcept
+        {
+            TINYSTL_DEBUG(!empty());
+            erase(begin());
+        }
+
+        void pop_back() noexcept
+        {
+            TINYSTL_DEBUG(!empty());
+            erase(--end());
+        }
+
+        // erase : unlink the elements, they are not destroyed
+        iterator erase(const_iterator pos) noexcept;
+        iterator erase(const_iterator first, const_iterator last) noexcept;
+
+        // unlink value from this list in O(1)
+        void erase(reference value) noexcept
+        { erase(iterator_to(value)); }
+
+        void clear() noexcept
+        { erase(begin(), end()); }
+
+        void swap(intrusive_list& rhs) noexcept
+        {
+            intrusive_list tmp;
+            tmp.splice(tmp.end(), *this);
+            splice(end(), rhs);
+            rhs.splice(rhs.end(), tmp);
+        }
+
+        // list related operations---------------------------------------------------------
+        void splice(const_iterator pos, intrusive_list& other) noexcept;
+
+        void splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept;
+
+        void splice(const_iterator pos, intrusive_list& other,
+                    const_iterator first, const_iterator last) noexcept;
+
+        template <class UnaryPredicate>
+        void remove_if(UnaryPredicate pred);
+
+        void remove(const value_type& value)
+        { remove_if([&](const value_type& v) {return v == value; }); }
+
+        void unique()
+        { unique(tinystl::equal_to<T>()); }
+
+        template <class BinaryPredicate>
+        void unique(BinaryPredicate pred);
+
+        void merge(intrusive_list& x)
+        { merge(x, tinystl::less<T>()); }
+
+        template <class Compare>
+        void merge(intrusive_list& x, Compare comp);
+
+        // sort : stable, bottom-up merge sort on the links, see list_chain_sort
+        void sort()
+        { sort(tinystl::less<T>()); }
+
+        template <class Compared>
+        void sort(Compared comp);
+
+        void reverse() noexcept;
+
+    private:
+        // helper functions----------------------------------------------------------------
+        static base_ptr as_hook(reference value) noexcept
+        { return static_cast<base_ptr>(tinystl::address_of(value)); }
+
+        static reference as_value(base_ptr p) noexcept
+        { return static_cast<reference>(*p); }
+
+        // link [first, last] before p
+        static void link_nodes(base_ptr p, base_ptr first, base_ptr last) noexcept
+        {
+            p->prev->next = first;
+            first->prev = p->prev;
+            p->prev = last;
+            last->next = p;
+        }
+
+        // unlink [first, last]
+        static void unlink_nodes(base_ptr first, base_ptr last) noexcept
+        {
+            first->prev->next = last->next;
+            last->next->prev = first->prev;
+        }
+
+        void relink_chain(base_ptr first) noexcept;
+    };
+
+    //============= implement ===============================================================
+    // Unlink the element at pos
+    template <class T, class Tag>
+    typename intrusive_list<T, Tag>::iterator
+    intrusive_list<T, Tag>::erase(const_iterator pos) noexcept
+    {
+        TINYSTL_DEBUG(pos != cend());
+        auto n = pos.node_;
+        auto next = n->next;
+        unlink_nodes(n, n);
+        n->prev = n->next = nullptr;
+        --size_;
+        return iterator(next);
+    }
+
+    // Unlink the elements in [first, last)
+    template <class T, class Tag>
+    typename intrusive_list<T, Tag>::iterator
+    intrusive_list<T, Tag>::erase(const_iterator first, const_iterator last) noexcept
+    {
+        while (first != last)
+            first = erase(first);
+        return iterator(last.node_);
+    }
+
+    // Move all the elements of x before pos
+    template <class T, class Tag>
+    void intrusive_list<T, Tag>::splice(const_iterator pos, intrusive_list& x) noexcept
+    {
+        TINYSTL_DEBUG(this != &x);
+        if (!x.empty())
+        {
+            auto f = x.node_.next;
+            auto l = x.node_.prev;
+            x.unlink_nodes(f, l);
+            link_nodes(pos.node_, f, l);
+            size_ += x.size_;
+            x.size_ = 0;
+        }
+    }
+
+    // Move the element at it before pos
+    template <class T, class Tag>
+    void intrusive_list<T, Tag>::splice(const_iterator pos, intrusive_list& x,
+                                        const_iterator it) noexcept
+    {
+        if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
+        {
+            auto f = it.node_;
+            x.unlink_nodes(f, f);
+            link_nodes(pos.node_, f, f);
+            ++size_;
+            --x.size_;
+        }
+    }
+
+    // Move the elements in [first, last) before pos
+    template <class T, class Tag>
+    void intrusive_list<T, Tag>::splice(const_iterator pos, intrusive_list& x,
+                                        const_iterator first, const_iterator last) noexcept
+    {
+        if (first != last && this != &x)
+        {
+            size_type n = tinystl::distance(first, last);
+            auto f = first.node_;
+            auto l = last.node_->prev;
+            x.unlink_nodes(f, l);
+            link_nodes(pos.node_, f, l);
+            size_ += n;
+            x.size_ -= n;
+        }
+        else if (first != last)
+        {
+            auto f = first.node_;
+            auto l = last.node_->prev;
+            unlink_nodes(f, l);
+            link_nodes(pos.node_, f, l);
+        }
+    }
+
+    // Unlink all the elements for which pred is true
+    template <class T, class Tag>
+    template <class UnaryPredicate>
+    void intrusive_list<T, Tag>::remove_if(UnaryPredicate pred)
+    {
+        auto f = begin();
+        auto l = end();
+        while (f != l)
+        {
+            if (pred(*f))
+                f = erase(f);
+            else
+                ++f;
+        }
+    }
+
+    // Unlink the consecutive elements equal to the one before them
+    template <class T, class Tag>
+    template <class BinaryPredicate>
+    void intrusive_list<T, Tag>::unique(BinaryPredicate pred)
+    {
+        if (size_ < 2)
+            return;
+        auto i = begin();
+        auto j = i;
+        for (++j; j != end(); )
+        {
+            if (pred(*i, *j))
+            {
+                j = erase(j);
+            }
+            else
+            {
+                i = j;
+                ++j;
+            }
+        }
+    }
+
+    // Rebuild the prev links of a null-terminated chain and close it into the ring
+    template <class T, class Tag>
+    void intrusive_list<T, Tag>::relink_chain(base_ptr first) noexcept
+    {
+        base_ptr prev = &node_;
+        for (base_ptr cur = first; cur != nullptr; cur = cur->next)
+        {
+            cur->prev = prev;
+            prev->next = cur;
+            prev = cur;
+        }
+        prev->next = &node_;
+        node_.prev = prev;
+    }
+
+    // Merge with another sorted list, stable: on equal elements the ones of *this come first
+    template <class T, class Tag>
+    template <class Compare>
+    void intrusive_list<T, Tag>::merge(intrusive_list& x, Compare comp)
+    {
+        if (this == &x || x.empty())
+            return;
+        auto node_comp = [&comp](base_ptr a, base_ptr b)
+        { return comp(as_value(a), as_value(b)); };
+
+        // open both rings into chains
+        base_ptr a = empty() ? nullptr : node_.next;
+        if (a != nullptr)
+            node_.prev->next = nullptr;
+        base_ptr b = x.node_.next;
+        x.node_.prev->next = nullptr;
+        x.node_.prev = x.node_.next = &x.node_;
+        size_ += x.size_;
+        x.size_ = 0;
+        try
+        {
+            tinystl::list_chain_merge(a, b, node_comp);
+        }
+        catch (...)
+        {
+            relink_chain(a);
+            throw;
+        }
+        relink_chain(a);
+    }
+
+    // Sort the list
+    template <class T, class Tag>
+    template <class Compared>
+    void intrusive_list<T, Tag>::sort(Compared comp)
+    {
+        if (size_ < 2)
+            return;
+        auto node_comp = [&comp](base_ptr a, base_ptr b)
+        { return comp(as_value(a), as_value(b)); };
+
+        base_ptr first = node_.next;
+        node_.prev->next = nullptr;
+        try
+        {
+            tinystl::list_chain_sort(first, node_comp);
+        }
+        catch (...)
+        {
+            relink_chain(first);
+            throw;
+        }
+        relink_chain(first);
+    }
+
+    // Reverse the list
+    template <class T, class Tag>
+    void intrusive_list<T, Tag>::reverse() noexcept
+    {
+        base_ptr cur = &node_;
+        do
+        {
+            tinystl::swap(cur->prev, cur->next);
+            cur = cur->prev;  // the old next
+        } while (cur != &node_);
+    }
+
+    // overload tinystl's swap
+    template <class T, class Tag>
+    void swap(intrusive_list<T, Tag>& lhs, intrusive_list<T, Tag>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+}
+#endif
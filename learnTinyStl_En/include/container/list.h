@@ -227,6 +227,121 @@ namespace tinystl
         { return node_ != rhs.node_; }
     };
 
+    //=================== chain merge / sort ===============================================
+    // These work on null-terminated chains linked by next only, so they are shared by
+    // list (the ring is opened first), forward_list and intrusive_list.
+    // node_comp compares two node pointers, the container adapts its value comparison.
+
+    // list_chain_merge
+    // Stable merge of the sorted chain b into the sorted chain a, a holds the earlier elements.
+    // If comp throws, a still holds every node of both chains
+    template <class BasePtr, class NodeCompare>
+    void list_chain_merge(BasePtr& a, BasePtr b, NodeCompare& node_comp)
+    {
+        BasePtr head = nullptr;
+        BasePtr* link = &head;  // the next field to fill
+        try
+        {
+            while (a != nullptr && b != nullptr)
+            {
+                if (node_comp(b, a))
+                {
+                    *link = b;
+                    b = b->next;
+                }
+                else
+                {
+                    *link = a;
+                    a = a->next;
+                }
+                link = &(*link)->next;
+            }
+        }
+        catch (...)
+        {
+            // keep every node on one chain before leaving
+            *link = a;
+            while (*link != nullptr)
+                link = &(*link)->next;
+            *link = b;
+            a = head;
+            throw;
+        }
+        *link = a != nullptr ? a : b;
+        a = head;
+    }
+
+    // list_chain_sort
+    // Bottom-up merge sort: every node is taken in turn and merged into bins[i],
+    // which holds a sorted run of 2^i nodes (or is empty), like the carries of a binary counter.
+    // No node is walked to find a midpoint, each level touches the nodes once.
+    // Stable. If comp throws, first still holds every node, in some order
+    template <class BasePtr, class NodeCompare>
+    void list_chain_sort(BasePtr& first, NodeCompare& node_comp)
+    {
+        BasePtr bins[64] = {};  // 2^64 nodes is more than enough
+        size_t fill = 0;        // number of bins in use
+        BasePtr rest = first;
+        BasePtr carry = nullptr;
+        BasePtr result = nullptr;
+        try
+        {
+            while (rest != nullptr)
+            {
+                carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+                size_t i = 0;
+                for (; i < fill && bins[i] != nullptr; ++i)
+                {
+                    auto later = carry;
+                    carry = nullptr;
+                    tinystl::list_chain_merge(bins[i], later, node_comp);
+                    carry = bins[i];
+                    bins[i] = nullptr;
+                }
+                bins[i] = carry;
+                carry = nullptr;
+                if (i == fill)
+                    ++fill;
+            }
+            // higher bins hold earlier nodes
+            for (size_t i = 0; i < fill; ++i)
+            {
+                if (bins[i] != nullptr)
+                {
+                    auto later = result;
+                    result = nullptr;
+                    tinystl::list_chain_merge(bins[i], later, node_comp);
+                    result = bins[i];
+                    bins[i] = nullptr;
+                }
+            }
+            first = result;
+        }
+        catch (...)
+        {
+            // join whatever is left into one chain, unsorted
+            BasePtr head = rest;
+            auto join = [&head](BasePtr chain)
+            {
+                if (chain == nullptr)
+                    return;
+                BasePtr tail = chain;
+                while (tail->next != nullptr)
+                    tail = tail->next;
+                tail->next = head;
+                head = chain;
+            };
+            join(carry);
+            join(result);
+            for (size_t i = 0; i < fill; ++i)
+                join(bins[i]);
+            first = head;
+            throw;
+        }
+    }
+
     //=================== list template ======================================================
     template <class T>
     class list
@@ -564,12 +679,22 @@ namespace tinystl
         template <class Compare>
         void merge(list& x, Compare comp);
 
+        // sort : stable, bottom-up merge sort on the links
         void sort()
-        { list_sort(begin(), end(), size(), tinystl::less<T>()); }
+        { bin_sort(tinystl::less<T>()); }
 
         template <class Compared>
         void sort(Compared comp)
-        { list_sort(begin(), end(), size(), comp); }
+        { bin_sort(comp); }
+
+        // sort_gather : stable, sorts an array of node pointers then relinks the nodes,
+        // faster when the nodes are scattered in memory, needs 2 * size() pointers
+        void sort_gather()
+        { gather_sort(tinystl::less<T>()); }
+
+        template <class Compared>
+        void sort_gather(Compared comp)
+        { gather_sort(comp); }
 
         void reverse();
 
@@ -607,8 +732,13 @@ namespace tinystl
         iterator copy_insert(const_iterator pos, size_type n, Iter first);
 
         // sort
+        void relink_chain(base_ptr first);
+
         template <class Compared>
-        iterator list_sort(iterator first, iterator last, size_type n, Compared comp);
+        void bin_sort(Compared comp);
+
+        template <class Compared>
+        void gather_sort(Compared comp);
 
     };
 
@@ -1089,82 +1219,120 @@ namespace tinystl
         }
     }
 
-    // Merge sort the list 
-    // and return an iterator pointing to the position of the smallest element in the range
+    // Rebuild the prev links of a null-terminated chain and close it into the ring at node_
     template <class T>
-    template <class Compared>
-    typename list<T>::iterator  list<T>::list_sort(iterator f1, iterator l2, size_type n, 
-                                                   Compared comp)
+    void list<T>::relink_chain(base_ptr first)
     {
-        if (n < 2)
-            return f1;
-
-        if (n == 2)
+        base_ptr prev = node_;
+        for (base_ptr cur = first; cur != nullptr; cur = cur->next)
         {
-            if (comp(*--l2, *f1))
-            {
-                auto ln = l2.node_;
-                unlink_nodes(ln, ln);
-                link_nodes(f1.node_, ln, ln);
-                return l2;
-            }
-            return f1;
+            cur->prev = prev;
+            prev->next = cur;
+            prev = cur;
         }
+        prev->next = node_;
+        node_->prev = prev;
+    }
 
-        auto n2 = n / 2;
-        auto l1 = f1;
-        tinystl::advance(l1, n2);
-        auto result = f1 = list_sort(f1, l1, n2, comp);  // Minimum position in the first half
-        auto f2 = l1 = list_sort(l1, l2, n - n2, comp);  // Minimum position in the last half
+    // Bottom-up merge sort
+    // The ring is opened into a chain on next, sorted by list_chain_sort,
+    // then the prev links are rebuilt once
+    template <class T>
+    template <class Compared>
+    void list<T>::bin_sort(Compared comp)
+    {
+        if (size_ < 2)
+            return;
 
-        // Move a smaller range to the front (I think we might just use the below part)
-        if (comp(*f2, *f1))
+        auto node_comp = [&comp](base_ptr a, base_ptr b)
+        { return comp(a->as_node()->value, b->as_node()->value); };
+        base_ptr first = node_->next;
+        node_->prev->next = nullptr;
+        try
         {
-            auto m = f2;
-            ++m;
-            for (; m != l2 && comp(*m, *f1); ++m)
-            ;
-            auto f = f2.node_;
-            auto l = m.node_->prev;
-            result = f2;
-            l1 = f2 = m;
-            unlink_nodes(f, l);
-            m = f1;
-            ++m;
-            link_nodes(f1.node_, f, l);
-            f1 = m;
+            tinystl::list_chain_sort(first, node_comp);
         }
-        else
+        catch (...)
         {
-            ++f1;
+            relink_chain(first);
+            throw;
         }
+        relink_chain(first);
+    }
+
+    // Sort by gathering the node pointers into a contiguous buffer:
+    // the comparisons run over an array instead of chasing next pointers,
+    // then the nodes are relinked in order once.
+    // Stable, the list is left untouched if comp throws or the buffer can not be allocated
+    template <class T>
+    template <class Compared>
+    void list<T>::gather_sort(Compared comp)
+    {
+        if (size_ < 2)
+            return;
 
-        // Merge two sorted ranges
-        while (f1 != l1 && f2 != l2)
+        typedef tinystl::allocator<base_ptr> ptr_allocator;
+        const size_type n = size_;
+        base_ptr* buf = ptr_allocator::allocate(2 * n);
+        base_ptr* tmp = buf + n;
+        try
         {
-            if (comp(*f2, *f1))
+            size_type k = 0;
+            for (base_ptr cur = node_->next; cur != node_; cur = cur->next)
+                buf[k++] = cur;
+
+            auto less = [&comp](base_ptr a, base_ptr b)
+            { return comp(a->as_node()->value, b->as_node()->value); };
+
+            // insertion sort on small runs
+            const size_type run = 16;
+            for (size_type lo = 0; lo < n; lo += run)
             {
-                auto m = f2;
-                ++m;
-                for (; m != l2 && comp(*m, *f1); ++m)
-                    ;
-                auto f = f2.node_;
-                auto l = m.node_->prev;
-                if (l1 == f2)
-                    l1 = m;
-                f2 = m;
-                unlink_nodes(f, l);
-                m = f1;
-                ++m;
-                link_nodes(f1.node_, f, l);
-                f1 = m;
+                const size_type hi = tinystl::min(lo + run, n);
+                for (size_type i = lo + 1; i < hi; ++i)
+                {
+                    auto value = buf[i];
+                    auto j = i;
+                    for (; j > lo && less(value, buf[j - 1]); --j)
+                        buf[j] = buf[j - 1];
+                    buf[j] = value;
+                }
             }
-            else
+
+            // bottom-up merge, between buf and tmp
+            for (size_type width = run; width < n; width *= 2)
             {
-                ++f1;
+                for (size_type lo = 0; lo < n; lo += 2 * width)
+                {
+                    const size_type mid = tinystl::min(lo + width, n);
+                    const size_type hi = tinystl::min(lo + 2 * width, n);
+                    size_type i = lo, j = mid, o = lo;
+                    while (i < mid && j < hi)
+                        tmp[o++] = less(buf[j], buf[i]) ? buf[j++] : buf[i++];
+                    while (i < mid)
+                        tmp[o++] = buf[i++];
+                    while (j < hi)
+                        tmp[o++] = buf[j++];
+                }
+                tinystl::swap(buf, tmp);
             }
         }
-        return result;
+        catch (...)
+        {
+            ptr_allocator::deallocate(buf < tmp ? buf : tmp, 2 * n);
+            throw;
+        }
+
+        base_ptr prev = node_;
+        for (size_type i = 0; i < n; ++i)
+        {
+            buf[i]->prev = prev;
+            prev->next = buf[i];
+            prev = buf[i];
+        }
+        prev->next = node_;
+        node_->prev = prev;
+        ptr_allocator::deallocate(buf < tmp ? buf : tmp, 2 * n);
     }
 
     // reverse list
@@ -0,0 +1,486 @@
+#ifndef _LRU_CACHE_H_
+#define _LRU_CACHE_H_
+
+// lru_cache         : a key -> value cache of bounded weight that evicts the least recently used entry
+// sharded_lru_cache : lru_cache split into shards, each behind its own mutex, for many threads
+
+// notes:
+// The usual way to write an LRU cache is unordered_map<K, list<pair<K, V>>::iterator> + list::splice,
+// which costs two allocations per entry (the hash node and the list node) and a second lookup
+// to go from one to the other.
+// Here an entry is one node that is linked into an intrusive_hashtable (by key) and
+// an intrusive_list (by recency, front = most recently used) at the same time:
+//   * one allocation per entry, nothing else is allocated except the bucket array
+//   * get:   find in the table, splice the node to the front of the list, O(1)
+//   * put:   find or create the node, link it at the front, then evict from the back, O(1)
+//   * evict: the back of the list is unlinked from both and destroyed, O(1)
+//
+// The capacity is a weight, Weigher(key, value) gives the weight of an entry.
+// The default weigher gives 1 to every entry, so the capacity is a number of entries;
+// a weigher that returns bytes makes it a capacity in bytes.
+// An entry heavier than the whole capacity is not kept (put returns false), nothing is evicted for it.
+//
+// get returns a pointer to the value (nullptr on a miss), valid until the entry is evicted or erased.
+// sharded_lru_cache can not give out such pointers, because another thread may evict the entry
+// as soon as the shard is unlocked, so its get copies the value out under the lock.
+
+#include <mutex>
+
+#include "functional.h"
+#include "util.h"
+#include "memory.h"
+#include "exceptdef.h"
+#include "intrusive_list.h"
+#include "intrusive_hashtable.h"
+
+namespace tinystl
+{
+
+    // every entry weighs 1, the capacity counts entries
+    struct lru_unit_weigher
+    {
+        template <class Key, class T>
+        size_t operator()(const Key&, const T&) const noexcept
+        { return 1; }
+    };
+
+    // the node of an entry, in the table by its ht_base_hook and in the recency list by its list_base_hook
+    template <class Key, class T>
+    struct lru_cache_node : public ht_base_hook<>, public list_base_hook<>
+    {
+        tinystl::pair<const Key, T> value;
+        size_t                      weight;
+
+        template <class V>
+        lru_cache_node(const Key& key, V&& v)
+            :value(key, tinystl::forward<V>(v)), weight(0)
+        {}
+    };
+
+    template <class Key, class T>
+    struct lru_cache_key
+    {
+        const Key& operator()(const lru_cache_node<Key, T>& node) const noexcept
+        { return node.value.first; }
+    };
+
+    //=================== lru_cache ==========================================================
+    template <class Key, class T, class Hash = tinystl::hash<Key>,
+              class KeyEqual = tinystl::equal_to<Key>, class Weigher = lru_unit_weigher>
+    class lru_cache
+    {
+    public:
+        typedef Key                         key_type;
+        typedef T                           mapped_type;
+        typedef tinystl::pair<const Key, T> value_type;
+        typedef Hash                        hasher;
+        typedef KeyEqual                    key_equal;
+        typedef Weigher                     weigher_type;
+        typedef size_t                      size_type;
+
+    private:
+        typedef lru_cache_node<Key, T>                                              node_type;
+        typedef tinystl::allocator<node_type>                                       node_allocator;
+        typedef intrusive_hashtable<node_type, Hash, KeyEqual, lru_cache_key<Key, T>> table_type;
+        typedef intrusive_list<node_type>                                           list_type;
+
+        table_type   table_;
+        list_type    order_;     // front: most recently used, back: the next to evict
+        size_type    capacity_;  // the largest total weight
+        size_type    weight_;    // the total weight of the entries
+        weigher_type weigher_;
+
+        // statistics
+        size_type    hits_;
+        size_type    misses_;
+        size_type    evictions_;
+
+    public:
+        // constructor
+        explicit lru_cache(size_type capacity, const Weigher& weigher = Weigher(),
+                           const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            :table_(100, hash, equal), order_(), capacity_(capacity), weight_(0), weigher_(weigher),
+             hits_(0), misses_(0), evictions_(0)
+        {}
+
+        lru_cache(const lru_cache&) = delete;
+        lru_cache& operator=(const lru_cache&) = delete;
+
+        lru_cache(lru_cache&& rhs) noexcept
+            :table_(tinystl::move(rhs.table_)), order_(tinystl::move(rhs.order_)),
+             capacity_(rhs.capacity_), weight_(rhs.weight_), weigher_(rhs.weigher_),
+             hits_(rhs.hits_), misses_(rhs.misses_), evictions_(rhs.evictions_)
+        {
+            rhs.weight_ = 0;
+        }
+
+        lru_cache& operator=(lru_cache&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                clear();
+                swap(rhs);
+            }
+            return *this;
+        }
+
+        ~lru_cache()
+        { clear(); }
+
+    public:
+        // lookup
+        // the value of key, which becomes the most recently used entry, nullptr if it is not cached
+        mapped_type* get(const key_type& key)
+        {
+            auto it = table_.find(key);
+            if (it == table_.end())
+            {
+                ++misses_;
+                return nullptr;
+            }
+            ++hits_;
+            touch(*it);
+            return &it->value.second;
+        }
+
+        // like get, but neither the recency nor the statistics change
+        const mapped_type* peek(const key_type& key) const
+        {
+            auto it = table_.find(key);
+            return it == table_.end() ? nullptr : &it->value.second;
+        }
+
+        bool contains(const key_type& key) const
+        { return table_.find(key) != table_.end(); }
+
+        // modify
+        // insert or assign key -> value as the most recently used entry, then evict down to capacity(),
+        // returns whether the entry is in the cache afterwards
+        bool put(const key_type& key, const mapped_type& value)
+        { return put_aux(key, value); }
+
+        bool put(const key_type& key, mapped_type&& value)
+        { return put_aux(key, tinystl::move(value)); }
+
+        // remove key, returns whether it was cached
+        bool erase(const key_type& key)
+        {
+            auto it = table_.find(key);
+            if (it == table_.end())
+                return false;
+            remove_node(&*it);
+            return true;
+        }
+
+        void clear() noexcept
+        {
+            table_.clear();
+            while (!order_.empty())
+            {
+                node_type& n = order_.back();
+                order_.pop_back();
+                destroy_node(&n);
+            }
+            weight_ = 0;
+        }
+
+        // capacity
+        bool      empty()    const noexcept { return order_.empty(); }
+        size_type size()     const noexcept { return order_.size(); }
+        size_type weight()   const noexcept { return weight_; }
+        size_type capacity() const noexcept { return capacity_; }
+
+        // change the capacity, evicting the least recently used entries that no longer fit
+        void set_capacity(size_type capacity)
+        {
+            capacity_ = capacity;
+            evict_to(capacity_);
+        }
+
+        void reserve(size_type count)
+        { table_.reserve(count); }
+
+        // statistics
+        size_type hits()      const noexcept { return hits_; }
+        size_type misses()    const noexcept { return misses_; }
+        size_type evictions() const noexcept { return evictions_; }
+
+        double hit_rate() const noexcept
+        { return hits_ + misses_ == 0 ? 0.0 : (double)hits_ / (double)(hits_ + misses_); }
+
+        void reset_stats() noexcept
+        { hits_ = misses_ = evictions_ = 0; }
+
+        hasher       hash_fcn() const { return table_.hash_fcn(); }
+        key_equal    key_eq()   const { return table_.key_eq(); }
+        weigher_type weigher()  const { return weigher_; }
+
+        void swap(lru_cache& rhs) noexcept
+        {
+            table_.swap(rhs.table_);
+            order_.swap(rhs.order_);
+            tinystl::swap(capacity_, rhs.capacity_);
+            tinystl::swap(weight_, rhs.weight_);
+            tinystl::swap(weigher_, rhs.weigher_);
+            tinystl::swap(hits_, rhs.hits_);
+            tinystl::swap(misses_, rhs.misses_);
+            tinystl::swap(evictions_, rhs.evictions_);
+        }
+
+    private:
+        template <class V>
+        bool put_aux(const key_type& key, V&& value);
+
+        // make n the most recently used entry
+        void touch(node_type& n) noexcept
+        { order_.splice(order_.begin(), order_, order_.iterator_to(n)); }
+
+        // evict from the back until the total weight is at most w
+        void evict_to(size_type w) noexcept
+        {
+            while (weight_ > w && !order_.empty())
+            {
+                remove_node(&order_.back());
+                ++evictions_;
+            }
+        }
+
+        void remove_node(node_type* np) noexcept
+        {
+            table_.erase(*np);
+            order_.erase(*np);
+            weight_ -= np->weight;
+            destroy_node(np);
+        }
+
+        template <class V>
+        node_type* create_node(const key_type& key, V&& value)
+        {
+            node_type* np = node_allocator::allocate(1);
+            try
+            {
+                tinystl::construct(np, key, tinystl::forward<V>(value));
+            }
+            catch (...)
+            {
+                node_allocator::deallocate(np, 1);
+                throw;
+            }
+            return np;
+        }
+
+        static void destroy_node(node_type* np) noexcept
+        {
+            tinystl::destroy(np);
+            node_allocator::deallocate(np, 1);
+        }
+    };
+
+    /*****************************************************************************************/
+
+    // put_aux
+    template <class Key, class T, class Hash, class KeyEqual, class Weigher>
+    template <class V>
+    bool lru_cache<Key, T, Hash, KeyEqual, Weigher>::put_aux(const key_type& key, V&& value)
+    {
+        // the weight is taken before the value may be moved from
+        const size_type w = weigher_(key, value);
+        auto it = table_.find(key);
+        if (w > capacity_)
+        {
+            // too heavy to be kept even alone: the other entries stay, an old value goes
+            if (it != table_.end())
+                remove_node(&*it);
+            return false;
+        }
+        if (it != table_.end())
+        {
+            node_type* np = &*it;
+            np->value.second = tinystl::forward<V>(value);
+            weight_ = weight_ - np->weight + w;
+            np->weight = w;
+            touch(*np);
+        }
+        else
+        {
+            node_type* np = create_node(key, tinystl::forward<V>(value));
+            try
+            {
+                table_.insert_unique(*np);
+            }
+            catch (...)
+            {
+                destroy_node(np);
+                throw;
+            }
+            np->weight = w;
+            order_.push_front(*np);
+            weight_ += w;
+        }
+        // the new entry is at the front and fits alone, so it is never the one evicted
+        evict_to(capacity_);
+        return true;
+    }
+
+    // overloaded swap
+    template <class Key, class T, class Hash, class KeyEqual, class Weigher>
+    void swap(lru_cache<Key, T, Hash, KeyEqual, Weigher>& lhs,
+              lru_cache<Key, T, Hash, KeyEqual, Weigher>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    //=================== sharded_lru_cache ==================================================
+    // The key's hash picks a shard, every shard is an lru_cache with its own mutex,
+    // so threads that touch different shards do not wait for each other.
+    // Recency is per shard: the evicted entry is the least recently used one of its shard.
+    template <class Key, class T, class Hash = tinystl::hash<Key>,
+              class KeyEqual = tinystl::equal_to<Key>, class Weigher = lru_unit_weigher>
+    class sharded_lru_cache
+    {
+    public:
+        typedef lru_cache<Key, T, Hash, KeyEqual, Weigher> cache_type;
+
+        typedef Key         key_type;
+        typedef T           mapped_type;
+        typedef Hash        hasher;
+        typedef KeyEqual    key_equal;
+        typedef Weigher     weigher_type;
+        typedef size_t      size_type;
+
+    private:
+        struct shard
+        {
+            std::mutex mtx;
+            cache_type cache;
+            char       pad[64];  // keeps the mutexes of neighbouring shards off one cache line
+
+            shard() :cache(0) {}
+        };
+
+        tinystl::unique_ptr<shard[]> shards_;
+        size_type                    shard_mask_;  // shard count - 1, the count is a power of two
+        hasher                       hash_;
+
+    public:
+        // capacity is the total weight, split evenly between the shards
+        explicit sharded_lru_cache(size_type capacity, size_type shard_count = 16,
+                                   const Weigher& weigher = Weigher(), const Hash& hash = Hash(),
+                                   const KeyEqual& equal = KeyEqual())
+            :shards_(), shard_mask_(0), hash_(hash)
+        {
+            THROW_OUT_OF_RANGE_IF(shard_count == 0, "sharded_lru_cache<Key, T>'s shard count is 0");
+            size_type n = 1;
+            while (n < shard_count)
+                n <<= 1;
+            shards_ = tinystl::make_unique<shard[]>(n);
+            shard_mask_ = n - 1;
+            const size_type per_shard = (capacity + n - 1) / n;
+            for (size_type i = 0; i < n; ++i)
+                shards_[i].cache = cache_type(per_shard, weigher, hash, equal);
+        }
+
+        sharded_lru_cache(const sharded_lru_cache&) = delete;
+        sharded_lru_cache& operator=(const sharded_lru_cache&) = delete;
+
+    public:
+        // copy the value of key to out and make it the most recently used entry of its shard
+        bool get(const key_type& key, mapped_type& out)
+        {
+            shard& s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            const mapped_type* p = s.cache.get(key);
+            if (p == nullptr)
+                return false;
+            out = *p;
+            return true;
+        }
+
+        bool contains(const key_type& key)
+        {
+            shard& s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            return s.cache.contains(key);
+        }
+
+        bool put(const key_type& key, const mapped_type& value)
+        {
+            shard& s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            return s.cache.put(key, value);
+        }
+
+        bool put(const key_type& key, mapped_type&& value)
+        {
+            shard& s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            return s.cache.put(key, tinystl::move(value));
+        }
+
+        bool erase(const key_type& key)
+        {
+            shard& s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            return s.cache.erase(key);
+        }
+
+        void clear()
+        {
+            for (size_type i = 0; i <= shard_mask_; ++i)
+            {
+                std::lock_guard<std::mutex> lock(shards_[i].mtx);
+                shards_[i].cache.clear();
+            }
+        }
+
+        // the totals are summed shard by shard, one lock at a time,
+        // so under concurrent writes they are not a snapshot of one moment
+        size_type size()
+        { return sum([](const cache_type& c) { return c.size(); }); }
+        size_type weight()
+        { return sum([](const cache_type& c) { return c.weight(); }); }
+        size_type capacity()
+        { return sum([](const cache_type& c) { return c.capacity(); }); }
+        size_type hits()
+        { return sum([](const cache_type& c) { return c.hits(); }); }
+        size_type misses()
+        { return sum([](const cache_type& c) { return c.misses(); }); }
+        size_type evictions()
+        { return sum([](const cache_type& c) { return c.evictions(); }); }
+
+        double hit_rate()
+        {
+            const size_type h = hits(), m = misses();
+            return h + m == 0 ? 0.0 : (double)h / (double)(h + m);
+        }
+
+        size_type shard_count() const noexcept
+        { return shard_mask_ + 1; }
+
+    private:
+        // the low bits of hash functions such as the identity hash of integers are poor,
+        // so they are mixed before the shard is picked
+        shard& shard_of(const key_type& key)
+        {
+            size_t h = hash_(key);
+            h ^= h >> 16;
+            h *= static_cast<size_t>(0x9E3779B97F4A7C15ull);
+            h ^= h >> 15;
+            return shards_[h & shard_mask_];
+        }
+
+        template <class Get>
+        size_type sum(Get get)
+        {
+            size_type total = 0;
+            for (size_type i = 0; i <= shard_mask_; ++i)
+            {
+                std::lock_guard<std::mutex> lock(shards_[i].mtx);
+                total += get(shards_[i].cache);
+            }
+            return total;
+        }
+    };
+
+} // namespace tinystl
+#endif // !_LRU_CACHE_H_
@@ -24,7 +24,10 @@ namespace tinystl
     // first parameter: key type
     // second parameter: value type
     // third parameter: key comparison method, default: tinystl::less
-    template <class Key, class T, class Compare = tinystl::less<Key>>
+    // fourth parameter: augmentation of the rb_tree, default: none
+    //   (rb_tree_size_augment adds find_by_order / order_of_key / rank in O(log n))
+    template <class Key, class T, class Compare = tinystl::less<Key>,
+              class Augment = rb_tree_no_augment>
     class map
     {
     public:
@@ -36,7 +39,7 @@ namespace tinystl
         // functor，used to compare the element
         class value_compare : public binary_function <value_type, value_type, bool>
         {
-            friend class map<Key, T, Compare>;
+            friend class map<Key, T, Compare, Augment>;
         private:
             Compare comp;
             value_compare(Compare c) : comp(c) {}
@@ -49,7 +52,7 @@ namespace tinystl
 
     private:
         // rb_tree
-        typedef tinystl::rb_tree<value_type, key_compare>  base_type;
+        typedef tinystl::rb_tree<value_type, key_compare, Augment>  base_type;
         base_type tree_;
 
     public:
@@ -279,6 +282,51 @@ namespace tinystl
         pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
         { return tree_.equal_range_unique(key); }
 
+        // *result++ = lower_bound(key) for every key in [first, last), see rb_tree
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result)
+        { return tree_.lower_bound_batch(first, last, result); }
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return tree_.lower_bound_batch(first, last, result); }
+
+        // join / split, see rb_tree.h---------------------------------------------------
+        // move every element of right to the end (its keys must not be less than ours)
+        void join(map& right)
+        { tree_.join(right.tree_); }
+
+        // move the elements whose key is not less than key to right
+        void split(const key_type& key, map& right)
+        { tree_.split(key, right.tree_); }
+
+        // set operations in O(m log(n / m + 1)), the nodes of other are moved or destroyed
+        // and other becomes empty, on equal keys our element is kept
+        void union_with(map& other, bool parallel = false)
+        { tree_.union_with(other.tree_, parallel); }
+
+        void intersect_with(map& other, bool parallel = false)
+        { tree_.intersect_with(other.tree_, parallel); }
+
+        void difference_with(map& other, bool parallel = false)
+        { tree_.difference_with(other.tree_, parallel); }
+
+        // order statistic, only with Augment = rb_tree_size_augment----------------------
+        iterator find_by_order(size_type k)
+        { return tree_.find_by_order(k); }
+
+        const_iterator find_by_order(size_type k) const
+        { return tree_.find_by_order(k); }
+
+        size_type order_of_key(const key_type& key) const
+        { return tree_.order_of_key(key); }
+
+        size_type rank(const_iterator it) const
+        { return tree_.rank(it); }
+
+        difference_type distance(const_iterator first, const_iterator last) const
+        { return tree_.distance(first, last); }
+
         void swap(map& rhs) noexcept
         { tree_.swap(rhs.tree_); }
 
@@ -290,45 +338,45 @@ namespace tinystl
         { return lhs.tree_ <  rhs.tree_; }
     };
 
-    template <class Key, class T, class Compare>
-    bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator==(const map<Key, T, Compare, Augment>& lhs, const map<Key, T, Compare, Augment>& rhs)
     {
         return lhs == rhs;
     }
 
-    template <class Key, class T, class Compare>
-    bool operator<(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator<(const map<Key, T, Compare, Augment>& lhs, const map<Key, T, Compare, Augment>& rhs)
     {
         return lhs < rhs;
     }
 
-    template <class Key, class T, class Compare>
-    bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator!=(const map<Key, T, Compare, Augment>& lhs, const map<Key, T, Compare, Augment>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class Key, class T, class Compare>
-    bool operator>(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator>(const map<Key, T, Compare, Augment>& lhs, const map<Key, T, Compare, Augment>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class Key, class T, class Compare>
-    bool operator<=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator<=(const map<Key, T, Compare, Augment>& lhs, const map<Key, T, Compare, Augment>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class Key, class T, class Compare>
-    bool operator>=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator>=(const map<Key, T, Compare, Augment>& lhs, const map<Key, T, Compare, Augment>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // swap
-    template <class Key, class T, class Compare>
-    void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
+    template <class Key, class T, class Compare, class Augment>
+    void swap(map<Key, T, Compare, Augment>& lhs, map<Key, T, Compare, Augment>& rhs) noexcept
     {
         lhs.swap(rhs);
     }
@@ -337,7 +385,9 @@ namespace tinystl
     // first parameter: key type
     // second parameter: value type
     // third parameter: comparison method, default: tinystl::less
-    template <class Key, class T, class Compare = tinystl::less<Key>>
+    // fourth parameter: augmentation of the rb_tree, default: none
+    template <class Key, class T, class Compare = tinystl::less<Key>,
+              class Augment = rb_tree_no_augment>
     class multimap
     {
     public:
@@ -348,7 +398,7 @@ namespace tinystl
 
         class value_compare : public binary_function <value_type, value_type, bool>
         {
-            friend class multimap<Key, T, Compare>;
+            friend class multimap<Key, T, Compare, Augment>;
         private:
             Compare comp;
             value_compare(Compare c) : comp(c) {}
@@ -361,7 +411,7 @@ namespace tinystl
 
     private:
         // rb_tree
-        typedef tinystl::rb_tree<value_type, key_compare>  base_type;
+        typedef tinystl::rb_tree<value_type, key_compare, Augment>  base_type;
         base_type tree_;
 
     public:
@@ -554,6 +604,40 @@ namespace tinystl
         pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
         { return tree_.equal_range_multi(key); }
 
+        // *result++ = lower_bound(key) for every key in [first, last), see rb_tree
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result)
+        { return tree_.lower_bound_batch(first, last, result); }
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return tree_.lower_bound_batch(first, last, result); }
+
+        // join / split, see rb_tree.h---------------------------------------------------
+        // move every element of right to the end (its keys must not be less than ours)
+        void join(multimap& right)
+        { tree_.join(right.tree_); }
+
+        // move the elements whose key is not less than key to right
+        void split(const key_type& key, multimap& right)
+        { tree_.split(key, right.tree_); }
+
+        // order statistic, only with Augment = rb_tree_size_augment----------------------
+        iterator find_by_order(size_type k)
+        { return tree_.find_by_order(k); }
+
+        const_iterator find_by_order(size_type k) const
+        { return tree_.find_by_order(k); }
+
+        size_type order_of_key(const key_type& key) const
+        { return tree_.order_of_key(key); }
+
+        size_type rank(const_iterator it) const
+        { return tree_.rank(it); }
+
+        difference_type distance(const_iterator first, const_iterator last) const
+        { return tree_.distance(first, last); }
+
         void swap(multimap& rhs) noexcept
         { tree_.swap(rhs.tree_); }
 
@@ -565,45 +649,45 @@ namespace tinystl
         { return lhs.tree_ <  rhs.tree_; }
     };
 
-    template <class Key, class T, class Compare>
-    bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator==(const multimap<Key, T, Compare, Augment>& lhs, const multimap<Key, T, Compare, Augment>& rhs)
     {
         return lhs == rhs;
     }
 
-    template <class Key, class T, class Compare>
-    bool operator<(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator<(const multimap<Key, T, Compare, Augment>& lhs, const multimap<Key, T, Compare, Augment>& rhs)
     {
         return lhs < rhs;
     }
 
-    template <class Key, class T, class Compare>
-    bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator!=(const multimap<Key, T, Compare, Augment>& lhs, const multimap<Key, T, Compare, Augment>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class Key, class T, class Compare>
-    bool operator>(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator>(const multimap<Key, T, Compare, Augment>& lhs, const multimap<Key, T, Compare, Augment>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class Key, class T, class Compare>
-    bool operator<=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator<=(const multimap<Key, T, Compare, Augment>& lhs, const multimap<Key, T, Compare, Augment>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class Key, class T, class Compare>
-    bool operator>=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    bool operator>=(const multimap<Key, T, Compare, Augment>& lhs, const multimap<Key, T, Compare, Augment>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // swap
-    template <class Key, class T, class Compare>
-    void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept
+    template <class Key, class T, class Compare, class Augment>
+    void swap(multimap<Key, T, Compare, Augment>& lhs, multimap<Key, T, Compare, Augment>& rhs) noexcept
     {
         lhs.swap(rhs);
     }
@@ -0,0 +1,594 @@
+#ifndef _PMAP_H_
+#define _PMAP_H_
+
+// pmap : persistent (immutable) sorted map with unique keys
+
+// notes:
+// A pmap is never modified. set / insert / erase return a new pmap and leave the old one alone,
+// both share every node that the update did not touch (structural sharing):
+// the tree is an AVL tree, an update copies the O(log n) nodes on the path from the root
+// to the changed node (path copying), and the rest of the tree is shared.
+// Copying a pmap is O(1), it only adds a reference to the root,
+// so a snapshot can be kept or passed to another thread for free.
+//
+// Every node has a reference count (Policy, see atomic_count_policy in memory.h),
+// the count is the number of parents (or pmap roots) that point to the node.
+// A node is freed when the last pmap that reaches it is destroyed.
+//
+// transient() returns a transient_type, an editable copy for batch updates:
+// a node that is reached only through the transient (count == 1 all the way from the root)
+// is modified in place, a shared node is copied the first time it is touched.
+// So n updates on a transient copy each shared node at most once instead of n times.
+// persistent() returns the current content as a pmap in O(1),
+// the transient can go on, it copies again what that pmap now shares.
+//
+// With atomic_count_policy the pmap objects themselves are not synchronized (like shared_ptr),
+// but different pmap / transient objects that share nodes can be used from different threads.
+//
+// The iterators are read only, they walk a version and stay valid while a pmap holding that
+// version lives. A transient has no iterators.
+
+// Exception guarantees:
+// tinystl::pmap<Key, T> set / insert / erase satisfy the strong exception safety guarantee
+// (the new pmap is built beside the old one),
+// transient_type satisfies the basic exception guarantee
+
+#include <initializer_list>
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "allocator.h"
+
+namespace tinystl
+{
+    // an AVL tree of n nodes is at most 1.44 * log2(n + 2) high, 48 is enough for n < 2^32
+    constexpr size_t pmap_max_height = 48;
+
+    template <class Value, class Policy>
+    struct pmap_node
+    {
+        typedef typename Policy::count_type count_type;
+
+        count_type  count;   // number of parents / roots that point to this node
+        pmap_node*  left;
+        pmap_node*  right;
+        int         height;  // a leaf is 1
+        Value       value;
+    };
+
+    // in-order iterator, keeps the nodes still to be visited on a stack
+    // (the tree has no parent pointers, a node can have many parents)
+    template <class Value, class Policy>
+    struct pmap_const_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, Value>
+    {
+        typedef pmap_node<Value, Policy>*              node_ptr;
+        typedef pmap_const_iterator<Value, Policy>     self;
+
+        typedef Value                value_type;
+        typedef const Value*         pointer;
+        typedef const Value&         reference;
+        typedef ptrdiff_t            difference_type;
+        typedef forward_iterator_tag iterator_category;
+
+        node_ptr stack_[pmap_max_height];
+        size_t   depth_;  // the top of the stack is the current node
+
+        pmap_const_iterator() :depth_(0) {}
+
+        void push(node_ptr x)
+        {
+            TINYSTL_DEBUG(depth_ < pmap_max_height);
+            stack_[depth_++] = x;
+        }
+
+        // the current node becomes the smallest node of x
+        void push_left(node_ptr x)
+        {
+            for (; x != nullptr; x = x->left)
+                push(x);
+        }
+
+        reference operator*()  const { return stack_[depth_ - 1]->value; }
+        pointer   operator->() const { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(depth_ != 0);
+            node_ptr x = stack_[--depth_];
+            push_left(x->right);
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        {
+            return depth_ == rhs.depth_ && (depth_ == 0 || stack_[depth_ - 1] == rhs.stack_[depth_ - 1]);
+        }
+        bool operator!=(const self& rhs) const { return !(*this == rhs); }
+    };
+
+    //=========== pmap ==============================================================
+    template <class Key, class T, class Compare = tinystl::less<Key>,
+              class Policy = atomic_count_policy>
+    class pmap
+    {
+    public:
+        typedef Key                                 key_type;
+        typedef T                                   mapped_type;
+        typedef tinystl::pair<const Key, T>         value_type;
+        typedef Compare                             key_compare;
+
+        typedef const value_type*                   pointer;
+        typedef const value_type*                   const_pointer;
+        typedef const value_type&                   reference;
+        typedef const value_type&                   const_reference;
+        typedef size_t                              size_type;
+        typedef ptrdiff_t                           difference_type;
+
+        typedef pmap_const_iterator<value_type, Policy> const_iterator;
+        typedef const_iterator                          iterator;
+
+        class transient_type;
+
+    private:
+        typedef pmap_node<value_type, Policy>       node_type;
+        typedef node_type*                          node_ptr;
+        typedef tinystl::allocator<node_type>       node_allocator;
+        typedef typename Policy::count_type         count_type;
+
+        node_ptr    root_;
+        size_type   size_;
+        key_compare comp_;
+
+    public:
+        // constructor, copy and move
+        pmap() :root_(nullptr), size_(0), comp_() {}
+
+        explicit pmap(const key_compare& comp) :root_(nullptr), size_(0), comp_(comp) {}
+
+        template <class InputIterator>
+        pmap(InputIterator first, InputIterator last)
+            :root_(nullptr), size_(0), comp_()
+        {
+            for (; first != last; ++first)
+                insert_unique(*first);
+        }
+
+        pmap(std::initializer_list<value_type> ilist)
+            :root_(nullptr), size_(0), comp_()
+        {
+            for (auto& value : ilist)
+                insert_unique(value);
+        }
+
+        // O(1), the two maps share every node
+        pmap(const pmap& rhs)
+            :root_(rhs.root_), size_(rhs.size_), comp_(rhs.comp_)
+        {
+            retain(root_);
+        }
+
+        pmap(pmap&& rhs) noexcept
+            :root_(rhs.root_), size_(rhs.size_), comp_(rhs.comp_)
+        {
+            rhs.root_ = nullptr;
+            rhs.size_ = 0;
+        }
+
+        pmap& operator=(const pmap& rhs)
+        {
+            pmap tmp(rhs);
+            swap(tmp);
+            return *this;
+        }
+
+        pmap& operator=(pmap&& rhs) noexcept
+        {
+            pmap tmp(tinystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ~pmap() { release(root_); }
+
+    public:
+        // iterator
+        const_iterator begin()  const noexcept
+        {
+            const_iterator it;
+            it.push_left(root_);
+            return it;
+        }
+        const_iterator end()    const noexcept { return const_iterator(); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend()   const noexcept { return end(); }
+
+        // capacity
+        bool      empty()    const noexcept { return size_ == 0; }
+        size_type size()     const noexcept { return size_; }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(node_type); }
+
+        key_compare key_comp() const { return comp_; }
+
+        // lookup
+        const_iterator find(const key_type& key) const
+        {
+            // the stack holds the nodes where the search went left: they come after the found one
+            const_iterator it;
+            node_ptr x = root_;
+            while (x != nullptr)
+            {
+                if (comp_(key, x->value.first))
+                {
+                    it.push(x);
+                    x = x->left;
+                }
+                else if (comp_(x->value.first, key))
+                {
+                    x = x->right;
+                }
+                else
+                {
+                    it.push(x);
+                    return it;
+                }
+            }
+            return end();
+        }
+
+        size_type count(const key_type& key)    const { return find_node(key) != nullptr ? 1 : 0; }
+        bool      contains(const key_type& key) const { return find_node(key) != nullptr; }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            node_ptr x = find_node(key);
+            THROW_OUT_OF_RANGE_IF(x == nullptr, "pmap<Key, T> no such element exists");
+            return x->value.second;
+        }
+
+        // updates, each returns the new version
+
+        // key maps to value, whether it was there or not
+        template <class M>
+        pmap set(const key_type& key, M&& value) const
+        {
+            pmap tmp(*this);
+            tmp.assign_at(tmp.root_, key, tinystl::forward<M>(value));
+            return tmp;
+        }
+
+        // adds value if its key is not there yet
+        pmap insert(const value_type& value) const
+        {
+            pmap tmp(*this);
+            tmp.insert_unique(value);
+            return tmp;
+        }
+
+        pmap erase(const key_type& key) const
+        {
+            pmap tmp(*this);
+            tmp.erase_unique(key);
+            return tmp;
+        }
+
+        transient_type transient() const { return transient_type(*this); }
+
+        void swap(pmap& rhs) noexcept
+        {
+            tinystl::swap(root_, rhs.root_);
+            tinystl::swap(size_, rhs.size_);
+            tinystl::swap(comp_, rhs.comp_);
+        }
+
+    private:
+        // helper functions
+
+        // node
+        template <class ...Args>
+        static node_ptr create_node(Args&& ...args)
+        {
+            node_ptr x = node_allocator::allocate(1);
+            try
+            {
+                tinystl::construct(tinystl::address_of(x->value), tinystl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                node_allocator::deallocate(x);
+                throw;
+            }
+            ::new (static_cast<void*>(tinystl::address_of(x->count))) count_type(1);
+            x->left = nullptr;
+            x->right = nullptr;
+            x->height = 1;
+            return x;
+        }
+
+        static void retain(node_ptr x) noexcept
+        {
+            if (x != nullptr)
+                Policy::increment(x->count);
+        }
+
+        // drop one reference, free the node (and its references to the children) on the last one
+        static void release(node_ptr x) noexcept
+        {
+            if (x != nullptr && Policy::decrement(x->count) == 0)
+            {
+                release(x->left);
+                release(x->right);
+                tinystl::destroy(tinystl::address_of(x->value));
+                x->count.~count_type();
+                node_allocator::deallocate(x);
+            }
+        }
+
+        // x is held by a slot that belongs to us, return a node that we may modify:
+        // x itself if nobody else points to it, otherwise a copy that shares x's children
+        static node_ptr make_mutable(node_ptr x)
+        {
+            if (Policy::unique(x->count))
+                return x;
+            node_ptr c = create_node(x->value);
+            c->left = x->left;
+            c->right = x->right;
+            c->height = x->height;
+            retain(c->left);
+            retain(c->right);
+            release(x);
+            return c;
+        }
+
+        node_ptr find_node(const key_type& key) const
+        {
+            node_ptr x = root_;
+            while (x != nullptr)
+            {
+                if (comp_(key, x->value.first))
+                    x = x->left;
+                else if (comp_(x->value.first, key))
+                    x = x->right;
+                else
+                    return x;
+            }
+            return nullptr;
+        }
+
+        // AVL balance, x and the children that get rotated must be mutable
+        static int height(node_ptr x) noexcept { return x == nullptr ? 0 : x->height; }
+
+        static void fix_height(node_ptr x) noexcept
+        {
+            int hl = height(x->left), hr = height(x->right);
+            x->height = (hl > hr ? hl : hr) + 1;
+        }
+
+        static node_ptr rotate_right(node_ptr x) noexcept
+        {
+            node_ptr l = x->left;
+            x->left = l->right;
+            l->right = x;
+            fix_height(x);
+            fix_height(l);
+            return l;
+        }
+
+        static node_ptr rotate_left(node_ptr x) noexcept
+        {
+            node_ptr r = x->right;
+            x->right = r->left;
+            r->left = x;
+            fix_height(x);
+            fix_height(r);
+            return r;
+        }
+
+        static node_ptr balance(node_ptr x)
+        {
+            fix_height(x);
+            const int diff = height(x->left) - height(x->right);
+            if (diff > 1)
+            {
+                x->left = make_mutable(x->left);
+                if (height(x->left->left) < height(x->left->right))
+                {
+                    x->left->right = make_mutable(x->left->right);
+                    x->left = rotate_left(x->left);
+                }
+                return rotate_right(x);
+            }
+            if (diff < -1)
+            {
+                x->right = make_mutable(x->right);
+                if (height(x->right->right) < height(x->right->left))
+                {
+                    x->right->left = make_mutable(x->right->left);
+                    x->right = rotate_right(x->right);
+                }
+                return rotate_left(x);
+            }
+            return x;
+        }
+
+        // in-place updates, slot is the parent's pointer (or the root) and belongs to us,
+        // it is replaced by its mutable copy before going down, so a throw leaves a valid tree
+        template <class M>
+        void assign_at(node_ptr& slot, const key_type& key, M&& value)
+        {
+            if (slot == nullptr)
+            {
+                slot = create_node(key, tinystl::forward<M>(value));
+                ++size_;
+                return;
+            }
+            slot = make_mutable(slot);
+            if (comp_(key, slot->value.first))
+                assign_at(slot->left, key, tinystl::forward<M>(value));
+            else if (comp_(slot->value.first, key))
+                assign_at(slot->right, key, tinystl::forward<M>(value));
+            else
+            {
+                slot->value.second = tinystl::forward<M>(value);
+                return;
+            }
+            slot = balance(slot);
+        }
+
+        // key must not be in the tree
+        void insert_at(node_ptr& slot, const value_type& value)
+        {
+            if (slot == nullptr)
+            {
+                slot = create_node(value);
+                ++size_;
+                return;
+            }
+            slot = make_mutable(slot);
+            if (comp_(value.first, slot->value.first))
+                insert_at(slot->left, value);
+            else
+                insert_at(slot->right, value);
+            slot = balance(slot);
+        }
+
+        // detach the smallest node of slot and return it (mutable, no children)
+        node_ptr remove_min(node_ptr& slot)
+        {
+            slot = make_mutable(slot);
+            if (slot->left == nullptr)
+            {
+                node_ptr m = slot;
+                slot = m->right;
+                m->right = nullptr;
+                return m;
+            }
+            node_ptr m = remove_min(slot->left);
+            slot = balance(slot);
+            return m;
+        }
+
+        // key must be in the tree
+        void erase_at(node_ptr& slot, const key_type& key)
+        {
+            slot = make_mutable(slot);
+            if (comp_(key, slot->value.first))
+            {
+                erase_at(slot->left, key);
+            }
+            else if (comp_(slot->value.first, key))
+            {
+                erase_at(slot->right, key);
+            }
+            else
+            {
+                node_ptr old = slot;
+                if (old->left == nullptr || old->right == nullptr)
+                {
+                    // the child may be shared, it is balanced already, do not touch it
+                    slot = old->left != nullptr ? old->left : old->right;
+                    old->left = old->right = nullptr;
+                    release(old);
+                    --size_;
+                    return;
+                }
+                // replace it with its successor
+                node_ptr m = remove_min(old->right);
+                m->left = old->left;
+                m->right = old->right;
+                old->left = old->right = nullptr;
+                slot = m;
+                release(old);
+                --size_;
+            }
+            slot = balance(slot);
+        }
+
+        bool insert_unique(const value_type& value)
+        {
+            if (find_node(value.first) != nullptr)
+                return false;
+            insert_at(root_, value);
+            return true;
+        }
+
+        size_type erase_unique(const key_type& key)
+        {
+            // nothing to erase: do not copy the path
+            if (find_node(key) == nullptr)
+                return 0;
+            erase_at(root_, key);
+            return 1;
+        }
+    };
+
+    //=========== transient ==========================================================
+    // batch editing of a pmap, the updates are made in place where the nodes are not shared
+    template <class Key, class T, class Compare, class Policy>
+    class pmap<Key, T, Compare, Policy>::transient_type
+    {
+    private:
+        pmap map_;
+
+    public:
+        transient_type() = default;
+        explicit transient_type(const pmap& m) :map_(m) {}
+
+        bool      empty() const noexcept { return map_.empty(); }
+        size_type size()  const noexcept { return map_.size(); }
+
+        size_type count(const key_type& key)    const { return map_.count(key); }
+        bool      contains(const key_type& key) const { return map_.contains(key); }
+        const mapped_type& at(const key_type& key) const { return map_.at(key); }
+
+        template <class M>
+        void set(const key_type& key, M&& value)
+        {
+            map_.assign_at(map_.root_, key, tinystl::forward<M>(value));
+        }
+
+        // false if the key was there
+        bool insert(const value_type& value)
+        {
+            return map_.insert_unique(value);
+        }
+
+        size_type erase(const key_type& key)
+        {
+            return map_.erase_unique(key);
+        }
+
+        // O(1) snapshot of the current content
+        pmap persistent() const { return map_; }
+    };
+
+    // overloaded operators
+    template <class Key, class T, class Compare, class Policy>
+    bool operator==(const pmap<Key, T, Compare, Policy>& lhs, const pmap<Key, T, Compare, Policy>& rhs)
+    {
+        return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class Key, class T, class Compare, class Policy>
+    bool operator!=(const pmap<Key, T, Compare, Policy>& lhs, const pmap<Key, T, Compare, Policy>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // overloaded swap
+    template <class Key, class T, class Compare, class Policy>
+    void swap(pmap<Key, T, Compare, Policy>& lhs, pmap<Key, T, Compare, Policy>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_PMAP_H_
@@ -0,0 +1,700 @@
+#ifndef _PVECTOR_H_
+#define _PVECTOR_H_
+
+// pvector : persistent (immutable) vector
+
+// notes:
+// A pvector is never modified. push_back / pop_back / set return a new pvector,
+// the old one is still valid and both share most of their memory (structural sharing).
+//
+// The elements are kept in a 32-way radix-balanced trie plus a tail block:
+//   * leaf: a block of 32 elements, inner node: 32 child pointers
+//   * the element i of the trie is found by the digits of i in base 32,
+//     (i >> shift) & 31 at the root, ..., (i >> 5) & 31 at the last inner node, i & 31 in the leaf,
+//     so operator[] is O(log32 n), at most 7 steps for 2^32 elements
+//   * the trie only holds full leaves, the last 1..32 elements are in the tail block,
+//     push_back / pop_back usually only touch the tail, a full tail is moved into the trie
+//   * set(i, v) copies the leaf of i and the inner nodes above it (path copying), O(32 log32 n)
+// Copying a pvector is O(1), it only adds references to the root and the tail.
+//
+// Every node has a reference count (Policy, see atomic_count_policy in memory.h),
+// a node is freed when the last pvector that reaches it is destroyed.
+//
+// transient() returns a transient_type, an editable copy for batch updates:
+// a node that is reached only through the transient (count == 1 all the way from the root)
+// is modified in place, a shared node is copied the first time it is touched,
+// so n push_back on a transient cost O(n) instead of copying the tail n times.
+// persistent() returns the current content as a pvector in O(1),
+// the transient can go on, it copies again what that pvector now shares.
+//
+// The iterators are read only random access iterators, they remember the current block
+// so a scan only walks the trie once every 32 elements.
+
+// Exception guarantees:
+// tinystl::pvector<T> push_back / pop_back / set satisfy the strong exception safety guarantee
+// (the new pvector is built beside the old one),
+// transient_type satisfies the basic exception guarantee
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "allocator.h"
+
+namespace tinystl
+{
+    constexpr size_t pvector_bits  = 5;
+    constexpr size_t pvector_width = static_cast<size_t>(1) << pvector_bits;  // 32
+    constexpr size_t pvector_mask  = pvector_width - 1;
+
+    template <class Policy>
+    struct pvector_node_base
+    {
+        typename Policy::count_type count;  // number of parents / pvectors that point to this node
+    };
+
+    // a block of elements: a leaf of the trie or the tail
+    template <class T, class Policy>
+    struct pvector_leaf : public pvector_node_base<Policy>
+    {
+        size_t size;  // constructed elements, always pvector_width in the trie
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[pvector_width];
+
+        T*       data()       noexcept { return reinterpret_cast<T*>(buf); }
+        const T* data() const noexcept { return reinterpret_cast<const T*>(buf); }
+    };
+
+    // the children are inner nodes, or leaves on the last level
+    template <class Policy>
+    struct pvector_inner : public pvector_node_base<Policy>
+    {
+        pvector_node_base<Policy>* child[pvector_width];
+    };
+
+    template <class T, class Policy> class pvector;
+
+    // random access iterator, caches the block of the current element
+    template <class T, class Policy>
+    struct pvector_const_iterator : public tinystl::iterator<tinystl::random_access_iterator_tag, T>
+    {
+        typedef pvector<T, Policy>                vector_type;
+        typedef pvector_const_iterator<T, Policy> self;
+
+        typedef T                                 value_type;
+        typedef const T*                          pointer;
+        typedef const T&                          reference;
+        typedef ptrdiff_t                         difference_type;
+        typedef random_access_iterator_tag        iterator_category;
+
+        const vector_type*  vec_;
+        size_t              index_;
+        mutable const T*    block_;       // the elements [block_base_, block_base_ + 32)
+        mutable size_t      block_base_;
+
+        pvector_const_iterator() :vec_(nullptr), index_(0), block_(nullptr), block_base_(0) {}
+        pvector_const_iterator(const vector_type* v, size_t i)
+            :vec_(v), index_(i), block_(nullptr), block_base_(0) {}
+
+        reference operator*() const
+        {
+            if (block_ == nullptr || index_ - block_base_ >= pvector_width)
+            {
+                block_base_ = index_ & ~pvector_mask;
+                block_ = vec_->block_of(index_);
+            }
+            return block_[index_ - block_base_];
+        }
+        pointer operator->() const { return &(operator*()); }
+
+        self& operator++()    { ++index_; return *this; }
+        self  operator++(int) { self tmp = *this; ++index_; return tmp; }
+        self& operator--()    { --index_; return *this; }
+        self  operator--(int) { self tmp = *this; --index_; return tmp; }
+
+        self& operator+=(difference_type n) { index_ += n; return *this; }
+        self& operator-=(difference_type n) { index_ -= n; return *this; }
+        self  operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+        self  operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+        difference_type operator-(const self& rhs) const
+        { return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_); }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const self& rhs) const { return index_ == rhs.index_; }
+        bool operator!=(const self& rhs) const { return index_ != rhs.index_; }
+        bool operator<(const self& rhs)  const { return index_ < rhs.index_; }
+        bool operator>(const self& rhs)  const { return rhs < *this; }
+        bool operator<=(const self& rhs) const { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const { return !(*this < rhs); }
+    };
+
+    //=========== pvector ===========================================================
+    template <class T, class Policy = atomic_count_policy>
+    class pvector
+    {
+        friend struct pvector_const_iterator<T, Policy>;
+
+    public:
+        typedef T                                       value_type;
+        typedef const T*                                pointer;
+        typedef const T*                                const_pointer;
+        typedef const T&                                reference;
+        typedef const T&                                const_reference;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+
+        typedef pvector_const_iterator<T, Policy>       const_iterator;
+        typedef const_iterator                          iterator;
+
+        class transient_type;
+
+    private:
+        typedef pvector_node_base<Policy>               base_type;
+        typedef pvector_leaf<T, Policy>                 leaf_type;
+        typedef pvector_inner<Policy>                   inner_type;
+        typedef tinystl::allocator<leaf_type>           leaf_allocator;
+        typedef tinystl::allocator<inner_type>          inner_allocator;
+        typedef typename Policy::count_type             count_type;
+
+        inner_type* root_;   // the trie, nullptr when it has no leaf
+        leaf_type*  tail_;   // the last 1..32 elements, nullptr when empty
+        size_type   size_;
+        size_type   shift_;  // the root digit is (i >> shift_) & 31, the leaves are shift_ / 5 levels down
+
+    public:
+        // constructor, copy and move
+        pvector() noexcept :root_(nullptr), tail_(nullptr), size_(0), shift_(pvector_bits) {}
+
+        pvector(size_type n, const value_type& value)
+            :root_(nullptr), tail_(nullptr), size_(0), shift_(pvector_bits)
+        {
+            for (; n > 0; --n)
+                emplace_back_unique(value);
+        }
+
+        template <class InputIterator, typename std::enable_if<
+            tinystl::is_input_iterator<InputIterator>::value, int>::type = 0>
+        pvector(InputIterator first, InputIterator last)
+            :root_(nullptr), tail_(nullptr), size_(0), shift_(pvector_bits)
+        {
+            for (; first != last; ++first)
+                emplace_back_unique(*first);
+        }
+
+        pvector(std::initializer_list<value_type> ilist)
+            :root_(nullptr), tail_(nullptr), size_(0), shift_(pvector_bits)
+        {
+            for (auto& value : ilist)
+                emplace_back_unique(value);
+        }
+
+        // O(1), the two vectors share every node
+        pvector(const pvector& rhs) noexcept
+            :root_(rhs.root_), tail_(rhs.tail_), size_(rhs.size_), shift_(rhs.shift_)
+        {
+            retain(root_);
+            retain(tail_);
+        }
+
+        pvector(pvector&& rhs) noexcept
+            :root_(rhs.root_), tail_(rhs.tail_), size_(rhs.size_), shift_(rhs.shift_)
+        {
+            rhs.root_ = nullptr;
+            rhs.tail_ = nullptr;
+            rhs.size_ = 0;
+            rhs.shift_ = pvector_bits;
+        }
+
+        pvector& operator=(const pvector& rhs) noexcept
+        {
+            pvector tmp(rhs);
+            swap(tmp);
+            return *this;
+        }
+
+        pvector& operator=(pvector&& rhs) noexcept
+        {
+            pvector tmp(tinystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ~pvector()
+        {
+            release(root_, shift_);
+            release(tail_, 0);
+        }
+
+    public:
+        // iterator
+        const_iterator begin()  const noexcept { return const_iterator(this, 0); }
+        const_iterator end()    const noexcept { return const_iterator(this, size_); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend()   const noexcept { return end(); }
+
+        // capacity
+        bool      empty()    const noexcept { return size_ == 0; }
+        size_type size()     const noexcept { return size_; }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+        // access elements
+        const_reference operator[](size_type n) const
+        {
+            TINYSTL_DEBUG(n < size_);
+            return block_of(n)[n & pvector_mask];
+        }
+
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "pvector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference front() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return (*this)[0];
+        }
+
+        const_reference back() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return tail_->data()[tail_->size - 1];
+        }
+
+        // updates, each returns the new version
+        pvector push_back(const value_type& value) const
+        {
+            pvector tmp(*this);
+            tmp.emplace_back_unique(value);
+            return tmp;
+        }
+
+        pvector push_back(value_type&& value) const
+        {
+            pvector tmp(*this);
+            tmp.emplace_back_unique(tinystl::move(value));
+            return tmp;
+        }
+
+        pvector pop_back() const
+        {
+            TINYSTL_DEBUG(!empty());
+            pvector tmp(*this);
+            tmp.pop_back_unique();
+            return tmp;
+        }
+
+        // the element n becomes value
+        template <class U>
+        pvector set(size_type n, U&& value) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "pvector<T>::set() subscript out of range");
+            pvector tmp(*this);
+            tmp.set_unique(n, tinystl::forward<U>(value));
+            return tmp;
+        }
+
+        transient_type transient() const { return transient_type(*this); }
+
+        void swap(pvector& rhs) noexcept
+        {
+            tinystl::swap(root_, rhs.root_);
+            tinystl::swap(tail_, rhs.tail_);
+            tinystl::swap(size_, rhs.size_);
+            tinystl::swap(shift_, rhs.shift_);
+        }
+
+    private:
+        // helper functions
+
+        // node
+        static leaf_type* create_leaf()
+        {
+            leaf_type* x = leaf_allocator::allocate(1);
+            ::new (static_cast<void*>(tinystl::address_of(x->count))) count_type(1);
+            x->size = 0;
+            return x;
+        }
+
+        static inner_type* create_inner()
+        {
+            inner_type* x = inner_allocator::allocate(1);
+            ::new (static_cast<void*>(tinystl::address_of(x->count))) count_type(1);
+            for (size_type i = 0; i < pvector_width; ++i)
+                x->child[i] = nullptr;
+            return x;
+        }
+
+        static void free_leaf(leaf_type* x) noexcept
+        {
+            tinystl::destroy(x->data(), x->data() + x->size);
+            x->count.~count_type();
+            leaf_allocator::deallocate(x);
+        }
+
+        static void free_inner(inner_type* x) noexcept
+        {
+            x->count.~count_type();
+            inner_allocator::deallocate(x);
+        }
+
+        static void retain(base_type* x) noexcept
+        {
+            if (x != nullptr)
+                Policy::increment(x->count);
+        }
+
+        // drop one reference to x, a node of the given level (0 is a leaf)
+        static void release(base_type* x, size_type level) noexcept
+        {
+            if (x == nullptr || Policy::decrement(x->count) != 0)
+                return;
+            if (level == 0)
+            {
+                free_leaf(static_cast<leaf_type*>(x));
+                return;
+            }
+            inner_type* node = static_cast<inner_type*>(x);
+            for (size_type i = 0; i < pvector_width && node->child[i] != nullptr; ++i)
+                release(node->child[i], level - pvector_bits);
+            free_inner(node);
+        }
+
+        // x is held by a slot that belongs to us, return a node that we may modify:
+        // x itself if nobody else points to it, otherwise a copy
+        static leaf_type* mutable_leaf(leaf_type* x)
+        {
+            if (Policy::unique(x->count))
+                return x;
+            leaf_type* c = create_leaf();
+            try
+            {
+                tinystl::uninitialized_copy(x->data(), x->data() + x->size, c->data());
+            }
+            catch (...)
+            {
+                free_leaf(c);
+                throw;
+            }
+            c->size = x->size;
+            release(x, 0);
+            return c;
+        }
+
+        static inner_type* mutable_inner(inner_type* x, size_type level)
+        {
+            if (Policy::unique(x->count))
+                return x;
+            inner_type* c = create_inner();
+            for (size_type i = 0; i < pvector_width && x->child[i] != nullptr; ++i)
+            {
+                c->child[i] = x->child[i];
+                retain(c->child[i]);
+            }
+            release(x, level);
+            return c;
+        }
+
+        // the first element index held by the tail, a multiple of 32
+        size_type tail_offset() const noexcept
+        {
+            return tail_ == nullptr ? 0 : size_ - tail_->size;
+        }
+
+        // the leaf of the trie that holds the element n (n < tail_offset())
+        leaf_type* trie_leaf(size_type n) const noexcept
+        {
+            base_type* x = root_;
+            for (size_type level = shift_; level > 0; level -= pvector_bits)
+                x = static_cast<inner_type*>(x)->child[(n >> level) & pvector_mask];
+            return static_cast<leaf_type*>(x);
+        }
+
+        // the elements of the block that holds the element n
+        const T* block_of(size_type n) const noexcept
+        {
+            return n >= tail_offset() ? tail_->data() : trie_leaf(n)->data();
+        }
+
+        // a chain of inner nodes from the given level down to the leaf
+        static base_type* new_path(size_type level, leaf_type* leaf)
+        {
+            base_type* x = leaf;
+            try
+            {
+                for (size_type l = pvector_bits; l <= level; l += pvector_bits)
+                {
+                    inner_type* node = create_inner();
+                    node->child[0] = x;
+                    x = node;
+                }
+            }
+            catch (...)
+            {
+                while (x != leaf)
+                {
+                    inner_type* node = static_cast<inner_type*>(x);
+                    x = node->child[0];
+                    free_inner(node);
+                }
+                throw;
+            }
+            return x;
+        }
+
+        // the full tail becomes the leaf number leaf_index of the trie, x is mutable
+        void push_tail_at(inner_type* x, size_type level, size_type leaf_index)
+        {
+            const size_type sub = (leaf_index >> (level - pvector_bits)) & pvector_mask;
+            if (level == pvector_bits)
+            {
+                x->child[sub] = tail_;
+                return;
+            }
+            base_type*& c = x->child[sub];
+            if (c == nullptr)
+            {
+                c = new_path(level - pvector_bits, tail_);
+            }
+            else
+            {
+                c = mutable_inner(static_cast<inner_type*>(c), level - pvector_bits);
+                push_tail_at(static_cast<inner_type*>(c), level - pvector_bits, leaf_index);
+            }
+        }
+
+        // move the (full) tail into the trie, the caller replaces tail_ afterwards
+        void push_tail()
+        {
+            const size_type leaf_index = tail_offset() >> pvector_bits;
+            if (root_ == nullptr)
+            {
+                root_ = create_inner();
+                root_->child[0] = tail_;
+                shift_ = pvector_bits;
+            }
+            else if (leaf_index == (static_cast<size_type>(1) << shift_))
+            {
+                // the trie is full: add a level above the root
+                inner_type* r = create_inner();
+                try
+                {
+                    r->child[1] = new_path(shift_, tail_);
+                }
+                catch (...)
+                {
+                    free_inner(r);
+                    throw;
+                }
+                r->child[0] = root_;
+                root_ = r;
+                shift_ += pvector_bits;
+            }
+            else
+            {
+                root_ = mutable_inner(root_, shift_);
+                push_tail_at(root_, shift_, leaf_index);
+            }
+        }
+
+        // remove the leaf number leaf_index (the last one) from the trie below x, x is mutable
+        void pop_tail_at(inner_type* x, size_type level, size_type leaf_index)
+        {
+            const size_type sub = (leaf_index >> (level - pvector_bits)) & pvector_mask;
+            if (level == pvector_bits)
+            {
+                release(x->child[sub], 0);
+                x->child[sub] = nullptr;
+                return;
+            }
+            inner_type* c = mutable_inner(static_cast<inner_type*>(x->child[sub]), level - pvector_bits);
+            x->child[sub] = c;
+            pop_tail_at(c, level - pvector_bits, leaf_index);
+            // the leaves are filled from the left, a node without a first child is empty
+            if (c->child[0] == nullptr)
+            {
+                release(c, level - pvector_bits);
+                x->child[sub] = nullptr;
+            }
+        }
+
+        void pop_tail(size_type leaf_index)
+        {
+            root_ = mutable_inner(root_, shift_);
+            pop_tail_at(root_, shift_, leaf_index);
+            if (root_->child[0] == nullptr)
+            {
+                release(root_, shift_);
+                root_ = nullptr;
+                shift_ = pvector_bits;
+            }
+            else if (shift_ > pvector_bits && root_->child[1] == nullptr)
+            {
+                // only one child left: it becomes the root
+                inner_type* c = static_cast<inner_type*>(root_->child[0]);
+                root_->child[0] = nullptr;
+                release(root_, shift_);
+                root_ = c;
+                shift_ -= pvector_bits;
+            }
+        }
+
+        // in-place updates, the nodes that are not shared are modified, the others are copied
+        template <class ...Args>
+        void emplace_back_unique(Args&& ...args)
+        {
+            if (tail_ != nullptr && tail_->size < pvector_width)
+            {
+                tail_ = mutable_leaf(tail_);
+                tinystl::construct(tail_->data() + tail_->size, tinystl::forward<Args>(args)...);
+                ++tail_->size;
+                ++size_;
+                return;
+            }
+            // a new tail, the full one goes into the trie
+            leaf_type* t = create_leaf();
+            try
+            {
+                tinystl::construct(t->data(), tinystl::forward<Args>(args)...);
+                t->size = 1;
+                if (tail_ != nullptr)
+                    push_tail();
+            }
+            catch (...)
+            {
+                free_leaf(t);
+                throw;
+            }
+            tail_ = t;
+            ++size_;
+        }
+
+        void pop_back_unique()
+        {
+            if (size_ == 1)
+            {
+                release(tail_, 0);
+                tail_ = nullptr;
+                size_ = 0;
+                return;
+            }
+            if (tail_->size > 1)
+            {
+                tail_ = mutable_leaf(tail_);
+                --tail_->size;
+                tinystl::destroy(tail_->data() + tail_->size);
+                --size_;
+                return;
+            }
+            // the tail becomes empty: the last leaf of the trie is the new tail
+            const size_type leaf_index = (tail_offset() >> pvector_bits) - 1;
+            leaf_type* t = trie_leaf(leaf_index << pvector_bits);
+            retain(t);
+            try
+            {
+                pop_tail(leaf_index);
+            }
+            catch (...)
+            {
+                release(t, 0);
+                throw;
+            }
+            release(tail_, 0);
+            tail_ = t;
+            --size_;
+        }
+
+        template <class U>
+        void set_unique(size_type n, U&& value)
+        {
+            if (n >= tail_offset())
+            {
+                tail_ = mutable_leaf(tail_);
+                tail_->data()[n & pvector_mask] = tinystl::forward<U>(value);
+                return;
+            }
+            root_ = mutable_inner(root_, shift_);
+            inner_type* x = root_;
+            for (size_type level = shift_; level > pvector_bits; level -= pvector_bits)
+            {
+                base_type*& c = x->child[(n >> level) & pvector_mask];
+                c = mutable_inner(static_cast<inner_type*>(c), level - pvector_bits);
+                x = static_cast<inner_type*>(c);
+            }
+            base_type*& leaf = x->child[(n >> pvector_bits) & pvector_mask];
+            leaf = mutable_leaf(static_cast<leaf_type*>(leaf));
+            static_cast<leaf_type*>(leaf)->data()[n & pvector_mask] = tinystl::forward<U>(value);
+        }
+    };
+
+    //=========== transient ==========================================================
+    // batch editing of a pvector, the updates are made in place where the nodes are not shared
+    template <class T, class Policy>
+    class pvector<T, Policy>::transient_type
+    {
+    private:
+        pvector vec_;
+
+    public:
+        transient_type() = default;
+        explicit transient_type(const pvector& v) :vec_(v) {}
+
+        bool      empty() const noexcept { return vec_.empty(); }
+        size_type size()  const noexcept { return vec_.size(); }
+
+        const_reference operator[](size_type n) const { return vec_[n]; }
+        const_reference at(size_type n)         const { return vec_.at(n); }
+        const_reference back()                  const { return vec_.back(); }
+
+        void push_back(const value_type& value) { vec_.emplace_back_unique(value); }
+        void push_back(value_type&& value)      { vec_.emplace_back_unique(tinystl::move(value)); }
+
+        template <class ...Args>
+        void emplace_back(Args&& ...args)
+        {
+            vec_.emplace_back_unique(tinystl::forward<Args>(args)...);
+        }
+
+        void pop_back()
+        {
+            TINYSTL_DEBUG(!empty());
+            vec_.pop_back_unique();
+        }
+
+        template <class U>
+        void set(size_type n, U&& value)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < vec_.size()), "pvector<T>::set() subscript out of range");
+            vec_.set_unique(n, tinystl::forward<U>(value));
+        }
+
+        // O(1) snapshot of the current content
+        pvector persistent() const { return vec_; }
+    };
+
+    // overloaded operators
+    template <class T, class Policy>
+    bool operator==(const pvector<T, Policy>& lhs, const pvector<T, Policy>& rhs)
+    {
+        return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class Policy>
+    bool operator!=(const pvector<T, Policy>& lhs, const pvector<T, Policy>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // overloaded swap
+    template <class T, class Policy>
+    void swap(pvector<T, Policy>& lhs, pvector<T, Policy>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_PVECTOR_H_
@@ -4,6 +4,7 @@
 // rb_tree : red-black tree
 #include <initializer_list>
 #include <cassert>
+#include <cstdint>
 
 #include "functional.h"
 #include "iterator.h"
@@ -11,6 +12,24 @@
 #include "type_traits.h"
 #include "exceptdef.h"
 #include "allocator.h"
+#include "algo.h"
+
+// join based set operations (union_with / intersect_with / difference_with)
+// 1: with parallel = true, the two halves of a large recursion run on two threads (std::async)
+// 0: always serial, no thread library is needed
+#ifndef RB_TREE_PARALLEL_SET_OPS
+#define RB_TREE_PARALLEL_SET_OPS 0
+#endif
+
+// subtrees with a smaller black height (about 2^h .. 4^h nodes) are never forked
+#ifndef RB_TREE_PARALLEL_MIN_HEIGHT
+#define RB_TREE_PARALLEL_MIN_HEIGHT 10
+#endif
+
+#if RB_TREE_PARALLEL_SET_OPS
+#include <future>
+#include <thread>
+#endif
 
 namespace tinystl
 {
@@ -22,6 +41,9 @@ namespace tinystl
     static constexpr rb_tree_color_type rb_tree_red   = false;
     static constexpr rb_tree_color_type rb_tree_black = true;
 
+    // keys that lower_bound_batch walks down the tree together
+    constexpr size_t rb_tree_batch_size = 16;
+
     // advance declaration
     template <class T> 
     struct rb_tree_node_base;
@@ -122,7 +144,18 @@ namespace tinystl
         typedef rb_tree_node<T>*        node_ptr;
     };
 
+    // node layout
+    // 1: compact, the color is the lowest bit of the parent pointer
+    //    (nodes are at least pointer aligned, so that bit is always 0 in a real address),
+    //    the links take 3 pointers (24 bytes on 64-bit) instead of 4 with padding (32 bytes)
+    // 0: classic, a separate color field
+    #ifndef RB_TREE_COMPACT_NODE
+    #define RB_TREE_COMPACT_NODE 1
+    #endif
+
     // rb tree node design
+    // the links are read and written through get_parent / set_parent / get_color / set_color,
+    // so the tree algorithms do not depend on the layout
     template <class T>
     struct rb_tree_node_base
     {
@@ -131,11 +164,75 @@ namespace tinystl
         typedef rb_tree_node_base<T>*   base_ptr;
         typedef rb_tree_node<T>*        node_ptr;
 
+    #if RB_TREE_COMPACT_NODE
+    private:
+        static constexpr uintptr_t color_mask = 1;
+
+        // parent node | color (red: 0, black: 1),
+        // kept as a pointer so the header's root link can be used as a base_ptr&
+        base_ptr   parent_color_;
+
+        uintptr_t word() const noexcept
+        { return reinterpret_cast<uintptr_t>(parent_color_); }
+
+        static base_ptr make(uintptr_t w) noexcept
+        { return reinterpret_cast<base_ptr>(w); }
+
+    public:
+        base_ptr   left;    // left child node
+        base_ptr   right;   // right child node
+
+        base_ptr get_parent() const noexcept
+        { return make(word() & ~color_mask); }
+
+        void set_parent(base_ptr p) noexcept
+        { parent_color_ = make(reinterpret_cast<uintptr_t>(p) | (word() & color_mask)); }
+
+        color_type get_color() const noexcept
+        { return (word() & color_mask) != 0; }
+
+        void set_color(color_type c) noexcept
+        { parent_color_ = make((word() & ~color_mask) | static_cast<uintptr_t>(c)); }
+
+        // for a node whose memory is not initialized yet
+        void set_parent_color(base_ptr p, color_type c) noexcept
+        { parent_color_ = make(reinterpret_cast<uintptr_t>(p) | static_cast<uintptr_t>(c)); }
+
+        // the header keeps the root in its parent link and is always red (bit 0),
+        // so the link is the plain root pointer and rb_tree can hand out a reference to it
+        base_ptr& root_ref() noexcept
+        {
+            TINYSTL_DEBUG(get_color() == rb_tree_red);
+            return parent_color_;
+        }
+    #else
         base_ptr   parent;  // parent node
         base_ptr   left;    // left child node
         base_ptr   right;   // right child node
         color_type color;   // node's color
 
+        base_ptr get_parent() const noexcept
+        { return parent; }
+
+        void set_parent(base_ptr p) noexcept
+        { parent = p; }
+
+        color_type get_color() const noexcept
+        { return color; }
+
+        void set_color(color_type c) noexcept
+        { color = c; }
+
+        void set_parent_color(base_ptr p, color_type c) noexcept
+        {
+            parent = p;
+            color = c;
+        }
+
+        base_ptr& root_ref() noexcept
+        { return parent; }
+    #endif
+
         base_ptr get_base_ptr()
         {
             return &*this;
@@ -175,6 +272,109 @@ namespace tinystl
         }
     };
 
+    //=========== augmentation ============================================================
+    // An augmented rb_tree keeps extra data in every node which is computed from
+    // the node's value and its two children (like the size of the subtree).
+    // The data is recomputed bottom-up whenever the children of a node change:
+    // on the path of an inserted / erased node, and for the two nodes of every rotation.
+    //
+    // An augmentation policy provides:
+    //   typedef ... data_type;
+    //   template <class T>
+    //   static void update(data_type& self, const T& value,
+    //                      const data_type* left, const data_type* right);
+    //   (left / right are nullptr for a missing child)
+
+    // A user policy is passed as the last template argument of rb_tree / set / map,
+    // the node data is read back with rb_tree::augment_of(node).
+    // rb_tree_interval_augment in interval_map.h is an example.
+
+    // no augmentation: plain rb_tree_node, the hooks do nothing
+    struct rb_tree_no_augment
+    {};
+
+    // order statistic: every node keeps the number of nodes in its subtree,
+    // so the k-th element and the rank of a key are found in O(log n)
+    struct rb_tree_size_augment
+    {
+        typedef size_t data_type;
+
+        template <class T>
+        static void update(data_type& self, const T&,
+                           const data_type* left, const data_type* right) noexcept
+        {
+            self = 1 + (left != nullptr ? *left : 0) + (right != nullptr ? *right : 0);
+        }
+
+        static size_t size(const data_type& d) noexcept
+        { return d; }
+    };
+
+    // augmented node: the policy's data after the value,
+    // so rb_tree_node<T>::value is at the same place and the iterators do not change
+    template <class T, class Data>
+    struct rb_tree_aug_node :public rb_tree_node<T>
+    {
+        Data aug;
+    };
+
+    // the hook called by the tree algorithms when a node's children changed
+    struct rb_tree_no_update
+    {
+        template <class NodePtr>
+        void operator()(NodePtr) const noexcept
+        {}
+    };
+
+    template <class T, class Augment>
+    struct rb_tree_aug_update
+    {
+        typedef rb_tree_aug_node<T, typename Augment::data_type>  node_type;
+
+        static const typename Augment::data_type* data_of(rb_tree_node_base<T>* x) noexcept
+        {
+            return x == nullptr ? nullptr : &static_cast<node_type*>(x)->aug;
+        }
+
+        void operator()(rb_tree_node_base<T>* x) const
+        {
+            auto node = static_cast<node_type*>(x);
+            Augment::update(node->aug, node->value, data_of(x->left), data_of(x->right));
+        }
+    };
+
+    // does the policy count the nodes of a subtree (has a static size(data))
+    template <class Augment>
+    struct rb_tree_has_size
+    {
+    private:
+        template <class U>
+        static char test(decltype(&U::size));
+        template <class U>
+        static long test(...);
+    public:
+        static constexpr bool value = sizeof(test<Augment>(nullptr)) == sizeof(char);
+    };
+
+    // node type and hook of a policy
+    template <class T, class Augment>
+    struct rb_tree_augment_traits
+    {
+        typedef rb_tree_aug_node<T, typename Augment::data_type>  node_type;
+        typedef rb_tree_aug_update<T, Augment>                    update_type;
+        static constexpr bool enabled  = true;
+        static constexpr bool has_size = rb_tree_has_size<Augment>::value;
+    };
+
+    template <class T>
+    struct rb_tree_augment_traits<T, rb_tree_no_augment>
+    {
+        typedef rb_tree_node<T>     node_type;
+        typedef rb_tree_no_update   update_type;
+        static constexpr bool enabled  = false;
+        static constexpr bool has_size = false;
+    };
+
     // rb tree traits
     template <class T>
     struct rb_tree_traits
@@ -218,11 +418,11 @@ namespace tinystl
             else // if there is no right node
             { 
                 // if there is no next node, return the header node
-                auto y = node->parent;
+                auto y = node->get_parent();
                 while (y->right == node)
                 {
                     node = y;
-                    y = y->parent;
+                    y = y->get_parent();
                 }
                 // Deal with the special case of "looking for the next node of the root node, 
                 // but the root node has no right child node"
@@ -235,7 +435,7 @@ namespace tinystl
         void dec()
         {
             // if the node is header
-            if (node->parent->parent == node && rb_tree_is_red(node))
+            if (node->get_parent()->get_parent() == node && rb_tree_is_red(node))
             { 
                 node = node->right;  // point ro the max node in the tree
             }
@@ -246,11 +446,11 @@ namespace tinystl
             else
             {  
                 // non-header and no left node
-                auto y = node->parent;
+                auto y = node->get_parent();
                 while (node == y->left)
                 {
                     node = y;
-                    y = y->parent;
+                    y = y->get_parent();
                 }
                 node = y;
             }
@@ -296,6 +496,12 @@ namespace tinystl
         rb_tree_iterator(const const_iterator& rhs) 
         { node = rhs.node; }
 
+        self& operator=(const iterator& rhs)
+        {
+            node = rhs.node;
+            return *this;
+        }
+
         // overload operator
         reference operator*()  const 
         { return node->get_node_ptr()->value; }
@@ -360,6 +566,12 @@ namespace tinystl
         rb_tree_const_iterator(const const_iterator& rhs) 
         { node = rhs.node; }
 
+        self& operator=(const const_iterator& rhs)
+        {
+            node = rhs.node;
+            return *this;
+        }
+
         // overload operator
         reference operator*()  const 
         { return node->get_node_ptr()->value; }
@@ -412,25 +624,25 @@ namespace tinystl
     template <class NodePtr>
     bool rb_tree_is_lchild(NodePtr node) noexcept
     {
-        return node == node->parent->left;
+        return node == node->get_parent()->left;
     }
 
     template <class NodePtr>
     bool rb_tree_is_red(NodePtr node) noexcept
     {
-        return node->color == rb_tree_red;
+        return node->get_color() == rb_tree_red;
     }
 
     template <class NodePtr>
-    void rb_tree_set_black(NodePtr& node) noexcept
+    void rb_tree_set_black(NodePtr node) noexcept
     {
-        node->color = rb_tree_black;
+        node->set_color(rb_tree_black);
     }
 
     template <class NodePtr>
-    void rb_tree_set_red(NodePtr& node) noexcept
+    void rb_tree_set_red(NodePtr node) noexcept
     {
-        node->color = rb_tree_red;
+        node->set_color(rb_tree_red);
     }
 
     template <class NodePtr>
@@ -440,8 +652,8 @@ namespace tinystl
             return rb_tree_min(node->right);
 
         while (!rb_tree_is_lchild(node))
-            node = node->parent;
-        return node->parent;
+            node = node->get_parent();
+        return node->get_parent();
     }
 
     //=========== rotate ==================================================================
@@ -456,15 +668,16 @@ namespace tinystl
     \*---------------------------------------*/
     // the first parameter: left rotated point
     // the second parameter: root node
-    template <class NodePtr>
-    void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept
+    // the third parameter: augmentation hook, x and y are the only nodes whose subtree changed
+    template <class NodePtr, class Update = rb_tree_no_update>
+    void rb_tree_rotate_left(NodePtr x, NodePtr& root, Update update = Update())
     {
         auto y = x->right;  // y is the left child node of x
         x->right = y->left;
         if (y->left != nullptr)
-            y->left->parent = x;
+            y->left->set_parent(x);
 
-        y->parent = x->parent;
+        y->set_parent(x->get_parent());
 
         if (x == root)
         { 
@@ -473,16 +686,19 @@ namespace tinystl
         }
         else if (rb_tree_is_lchild(x))
         { 
-            x->parent->left = y;
+            x->get_parent()->left = y;
         }
         else
         { 
             // if x is right child node
-            x->parent->right = y;
+            x->get_parent()->right = y;
         }
         // adjust the relationship of x and y
         y->left = x;  
-        x->parent = y;
+        x->set_parent(y);
+        // x is the child now, so update it first
+        update(x);
+        update(y);
     }
 
     /*----------------------------------------*\
@@ -496,15 +712,16 @@ namespace tinystl
     \*----------------------------------------*/
     // the first parameter: left rotated point
     // the second parameter: root node
-    template <class NodePtr>
-    void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept
+    // the third parameter: augmentation hook
+    template <class NodePtr, class Update = rb_tree_no_update>
+    void rb_tree_rotate_right(NodePtr x, NodePtr& root, Update update = Update())
     {
         auto y = x->left;
         x->left = y->right;
         if (y->right)
-            y->right->parent = x;
+            y->right->set_parent(x);
 
-        y->parent = x->parent;
+        y->set_parent(x->get_parent());
 
         if (x == root)
         { 
@@ -512,16 +729,34 @@ namespace tinystl
         }
         else if (rb_tree_is_lchild(x))
         { 
-            x->parent->left = y;
+            x->get_parent()->left = y;
         }
         else
         { 
-            x->parent->right = y;
+            x->get_parent()->right = y;
         }
         y->right = x;                      
-        x->parent = y;
+        x->set_parent(y);
+        update(x);
+        update(y);
+    }
+
+    // recompute the augmented data from x up to the root
+    template <class NodePtr, class Update>
+    void rb_tree_update_to_root(NodePtr x, NodePtr root, Update update)
+    {
+        if (root == nullptr)
+            return;
+        auto header = root->get_parent();
+        for (; x != header; x = x->get_parent())
+            update(x);
     }
 
+    // nothing to recompute without augmentation
+    template <class NodePtr>
+    void rb_tree_update_to_root(NodePtr, NodePtr, rb_tree_no_update) noexcept
+    {}
+
     //========================= insert ====================================================
     // Rebalance the rb tree after inserting nodes, 
     // the first parameter is the new node, and the second parameter is the root node
@@ -544,21 +779,27 @@ namespace tinystl
     //
     // blogs: http://blog.csdn.net/v_JULY_v/article/details/6105630
     //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-    template <class NodePtr>
-    void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
+    //
+    // The augmented data of the path from x to the root must be up to date,
+    // the rotations keep it that way
+    //
+    // Return true if the black height of the tree grew by one
+    // (the root ended red and was painted black), the join below needs it
+    template <class NodePtr, class Update = rb_tree_no_update>
+    bool rb_tree_insert_rebalance(NodePtr x, NodePtr& root, Update update = Update())
     {
         rb_tree_set_red(x);  // add new node which is red
-        while (x != root && rb_tree_is_red(x->parent))
+        while (x != root && rb_tree_is_red(x->get_parent()))
         {
-            if (rb_tree_is_lchild(x->parent))
+            if (rb_tree_is_lchild(x->get_parent()))
             { 
-                auto uncle = x->parent->parent->right;
+                auto uncle = x->get_parent()->get_parent()->right;
                 if (uncle != nullptr && rb_tree_is_red(uncle))
                 { 
                     // case 3
-                    rb_tree_set_black(x->parent);
+                    rb_tree_set_black(x->get_parent());
                     rb_tree_set_black(uncle);
-                    x = x->parent->parent;
+                    x = x->get_parent()->get_parent();
                     rb_tree_set_red(x);
                 }
                 else
@@ -567,25 +808,25 @@ namespace tinystl
                     if (!rb_tree_is_lchild(x))
                     { 
                         // case 4
-                        x = x->parent;
-                        rb_tree_rotate_left(x, root);
+                        x = x->get_parent();
+                        rb_tree_rotate_left(x, root, update);
                     }
                     // case 5
-                    rb_tree_set_black(x->parent);
-                    rb_tree_set_red(x->parent->parent);
-                    rb_tree_rotate_right(x->parent->parent, root);
+                    rb_tree_set_black(x->get_parent());
+                    rb_tree_set_red(x->get_parent()->get_parent());
+                    rb_tree_rotate_right(x->get_parent()->get_parent(), root, update);
                     break;
                 }
             }
             else
             { 
-                auto uncle = x->parent->parent->left;
+                auto uncle = x->get_parent()->get_parent()->left;
                 if (uncle != nullptr && rb_tree_is_red(uncle))
                 { 
                     // case 3
-                    rb_tree_set_black(x->parent);
+                    rb_tree_set_black(x->get_parent());
                     rb_tree_set_black(uncle);
-                    x = x->parent->parent;
+                    x = x->get_parent()->get_parent();
                     rb_tree_set_red(x);
                 }
                 else
@@ -594,18 +835,20 @@ namespace tinystl
                     if (rb_tree_is_lchild(x))
                     { 
                         // case 4
-                        x = x->parent;
-                        rb_tree_rotate_right(x, root);
+                        x = x->get_parent();
+                        rb_tree_rotate_right(x, root, update);
                     }
                     // case 5
-                    rb_tree_set_black(x->parent);
-                    rb_tree_set_red(x->parent->parent);
-                    rb_tree_rotate_left(x->parent->parent, root);
+                    rb_tree_set_black(x->get_parent());
+                    rb_tree_set_red(x->get_parent()->get_parent());
+                    rb_tree_rotate_left(x->get_parent()->get_parent(), root, update);
                     break;
                 }
             }
         }
+        bool grew = rb_tree_is_red(root);
         rb_tree_set_black(root);
+        return grew;
     }
 
     //========== erase ===================================================================
@@ -614,11 +857,13 @@ namespace tinystl
     // second parameter: root node
     // third parameter:  minmum node
     // fourth parameter: maximum node
+    // fifth parameter:  augmentation hook
     // blogs: http://blog.csdn.net/v_JULY_v/article/details/6105630
     //        http://blog.csdn.net/v_JULY_v/article/details/6109153
-    template <class NodePtr>
+    template <class NodePtr, class Update = rb_tree_no_update>
     NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, 
-                                    NodePtr& leftmost, NodePtr& rightmost)
+                                    NodePtr& leftmost, NodePtr& rightmost,
+                                    Update update = Update())
     {
         // y is the possible replacement node, pointing to the node to be removed eventually
         auto y = (z->left == nullptr || z->right == nullptr) ? z : rb_tree_next(z);
@@ -635,20 +880,20 @@ namespace tinystl
         // Replace z's position with y, replace y's position with x, and finally point y to z
         if (y != z)
         {
-            z->left->parent = y;
+            z->left->set_parent(y);
             y->left = z->left;
 
             // If y is not the right child of z, then the right child of z must have a left child
             if (y != z->right)
             { 
                 // where x replaces y
-                xp = y->parent;
+                xp = y->get_parent();
                 if (x != nullptr)
-                    x->parent = y->parent;
+                    x->set_parent(y->get_parent());
 
-                y->parent->left = x;
+                y->get_parent()->left = x;
                 y->right = z->right;
-                z->right->parent = y;
+                z->right->set_parent(y);
             }
             else
             {
@@ -659,27 +904,29 @@ namespace tinystl
             if (root == z)
                 root = y;
             else if (rb_tree_is_lchild(z))
-                z->parent->left = y;
+                z->get_parent()->left = y;
             else
-                z->parent->right = y;
+                z->get_parent()->right = y;
 
-            y->parent = z->parent;
-            tinystl::swap(y->color, z->color);
+            y->set_parent(z->get_parent());
+            auto color = y->get_color();
+            y->set_color(z->get_color());
+            z->set_color(color);
             y = z;
         }
         else // "y == z" notes that z has at most one child
         { 
-            xp = y->parent;
+            xp = y->get_parent();
             if (x)  
-                x->parent = y->parent;
+                x->set_parent(y->get_parent());
 
             // connect x to z's parent node
             if (root == z)
                 root = x;
             else if (rb_tree_is_lchild(z))
-                z->parent->left = x;
+                z->get_parent()->left = x;
             else
-                z->parent->right = x;
+                z->get_parent()->right = x;
 
             // At this time z may be the leftmost node or the rightmost node, update the data
             if (leftmost == z)
@@ -688,6 +935,11 @@ namespace tinystl
                 rightmost = x == nullptr ? xp : rb_tree_max(x);
         }
 
+        // the subtrees on the path from xp to the root lost a node
+        // (y, which replaced z, is on that path too), 
+        // fix them before the rotations below use them
+        rb_tree_update_to_root(xp, root, update);
+
         // At this point, y points to the node to be deleted, 
         // x is the replacement node, and the adjustment starts from the x node.
         // If the deleted node is red, the nature of the tree has not been destroyed, 
@@ -721,7 +973,7 @@ namespace tinystl
                     { // case 1
                         rb_tree_set_black(brother);
                         rb_tree_set_red(xp);
-                        rb_tree_rotate_left(xp, root);
+                        rb_tree_rotate_left(xp, root, update);
                         brother = xp->right;
                     }
                     // case 1 transfers into one of case 2、3、4 
@@ -731,7 +983,7 @@ namespace tinystl
                         // case 2
                         rb_tree_set_red(brother);
                         x = xp;
-                        xp = xp->parent;
+                        xp = xp->get_parent();
                     }
                     else
                     { 
@@ -741,15 +993,15 @@ namespace tinystl
                             if (brother->left != nullptr)
                             rb_tree_set_black(brother->left);
                             rb_tree_set_red(brother);
-                            rb_tree_rotate_right(brother, root);
+                            rb_tree_rotate_right(brother, root, update);
                             brother = xp->right;
                         }
                         // case 4
-                        brother->color = xp->color;
+                        brother->set_color(xp->get_color());
                         rb_tree_set_black(xp);
                         if (brother->right != nullptr)  
                             rb_tree_set_black(brother->right);
-                        rb_tree_rotate_left(xp, root);
+                        rb_tree_rotate_left(xp, root, update);
                         break;
                     }
                 }
@@ -760,7 +1012,7 @@ namespace tinystl
                     { // case 1
                         rb_tree_set_black(brother);
                         rb_tree_set_red(xp);
-                        rb_tree_rotate_right(xp, root);
+                        rb_tree_rotate_right(xp, root, update);
                         brother = xp->left;
                     }
                     if ((brother->left == nullptr || !rb_tree_is_red(brother->left)) &&
@@ -769,7 +1021,7 @@ namespace tinystl
                         // case 2
                         rb_tree_set_red(brother);
                         x = xp;
-                        xp = xp->parent;
+                        xp = xp->get_parent();
                     }
                     else
                     {
@@ -780,15 +1032,15 @@ namespace tinystl
                             rb_tree_set_black(brother->right);
 
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_left(brother, root);
+                        rb_tree_rotate_left(brother, root, update);
                         brother = xp->left;
                     }
                     // case 4
-                    brother->color = xp->color;
+                    brother->set_color(xp->get_color());
                     rb_tree_set_black(xp);
                     if (brother->left != nullptr)  
                         rb_tree_set_black(brother->left);
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right(xp, root, update);
                     break;
                     }
                 }
@@ -799,20 +1051,43 @@ namespace tinystl
         return y;
     }
 
+    // run f1 and f2, f1 on another thread when fork is true
+    template <class F1, class F2>
+    void rb_tree_fork(F1 f1, F2 f2, bool fork)
+    {
+    #if RB_TREE_PARALLEL_SET_OPS
+        if (fork)
+        {
+            auto left = std::async(std::launch::async, f1);
+            f2();
+            left.get();
+            return;
+        }
+    #else
+        (void)fork;
+    #endif
+        f1();
+        f2();
+    }
+
     // rb_tree=============================================================================
     // first parameter:  value type
     // second parameter: Key-value comparison type
-    template <class T, class Compare>
+    // third parameter:  augmentation policy (rb_tree_no_augment / rb_tree_size_augment / ...)
+    template <class T, class Compare, class Augment = rb_tree_no_augment>
     class rb_tree
     {
     public:
-        typedef rb_tree_traits<T>           tree_traits;
-        typedef rb_tree_value_traits<T>     value_traits;
+        typedef rb_tree_traits<T>                   tree_traits;
+        typedef rb_tree_value_traits<T>             value_traits;
+        typedef rb_tree_augment_traits<T, Augment>  augment_traits;
+        typedef Augment                             augment_type;
 
         typedef typename tree_traits::base_type     base_type;
         typedef typename tree_traits::base_ptr      base_ptr;
-        typedef typename tree_traits::node_type     node_type;
-        typedef typename tree_traits::node_ptr      node_ptr;
+        typedef typename augment_traits::node_type  node_type;
+        typedef node_type*                          node_ptr;
+        typedef typename augment_traits::update_type update_type;
         typedef typename tree_traits::key_type      key_type;
         typedef typename tree_traits::mapped_type   mapped_type;
         typedef typename tree_traits::value_type    value_type;
@@ -854,7 +1129,7 @@ namespace tinystl
     private:
         // root node, min node and max node
         base_ptr& root() const 
-        { return header_->parent; }
+        { return header_->root_ref(); }
 
         base_ptr& leftmost() const 
         { return header_->left; }
@@ -1009,7 +1284,8 @@ namespace tinystl
         size_type count_multi(const key_type& key) const
         {
             auto p = equal_range_multi(key);
-            return static_cast<size_type>(tinystl::distance(p.first, p.second));
+            return static_cast<size_type>(distance_dispatch(p.first, p.second,
+                m_bool_constant<augment_traits::has_size>()));
         }
         size_type count_unique(const key_type& key) const
         {
@@ -1048,9 +1324,113 @@ namespace tinystl
             return it == end() ? tinystl::make_pair(it, it) : tinystl::make_pair(it, ++next);
         }
 
+        // batch lookup: *result++ = lower_bound(key) for every key in [first, last),
+        // returns the end of the output. The keys must be key_type lvalues.
+        // One lower_bound is a chain of dependent cache misses, one per level.
+        // Here rb_tree_batch_size keys go down together, one level per round,
+        // and the next node of each key is prefetched, so their misses overlap.
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result);
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result) const;
+
         void swap(rb_tree& rhs) noexcept;
 
+        // order statistic, needs a policy with size() (rb_tree_size_augment)------------
+        // the k-th (from 0) element, end() if k >= size()
+        iterator       find_by_order(size_type k);
+        const_iterator find_by_order(size_type k) const;
+
+        // the number of elements whose key is less than key
+        size_type order_of_key(const key_type& key) const;
+
+        // the position of it (from 0), size() for end()
+        size_type rank(const_iterator it) const;
+
+        // distance in O(log n), tinystl::distance walks the iterators in O(n)
+        difference_type distance(const_iterator first, const_iterator last) const
+        {
+            return static_cast<difference_type>(rank(last)) - 
+                   static_cast<difference_type>(rank(first));
+        }
+
+        // join / split-------------------------------------------------------------------
+        // move every element of right to the end of this, right becomes empty
+        // (every key of right must not be less than the keys of this), O(log n)
+        void join(rb_tree& right);
+
+        // move the elements whose key is not less than key to right (right is cleared first),
+        // O(log n) for the tree, plus O(size of right) to count the elements
+        // unless the tree has rb_tree_size_augment
+        void split(const key_type& key, rb_tree& right);
+
+        // set operations for unique keys (set / map), O(m log(n / m + 1)) for sizes m <= n,
+        // nodes are moved between the trees instead of copied, other becomes empty.
+        // On equal keys, the element of this is kept and the one of other is destroyed.
+        // With RB_TREE_PARALLEL_SET_OPS and parallel = true the large subproblems run on
+        // std::async threads. The comparison must not throw.
+        void union_with(rb_tree& other, bool parallel = false);
+        void intersect_with(rb_tree& other, bool parallel = false);
+        void difference_with(rb_tree& other, bool parallel = false);
+
+        // augmentation hooks----------------------------------------------------------
+        // a search can walk the tree from root_node() through left / right
+        // and skip a whole subtree by looking at its augmented data (see interval_map.h)
+        base_ptr root_node() const noexcept
+        { return root(); }
+
+        template <class A = Augment>
+        static const typename A::data_type& augment_of(base_ptr x) noexcept
+        { return to_node(x)->aug; }
+
     private:
+        // batch lookup
+        template <class ForwardIter>
+        ForwardIter gather_batch(ForwardIter first, ForwardIter last,
+                                 const key_type** keys, size_type& n) const;
+        void lower_bound_lanes(const key_type* const* keys, base_ptr* found, size_type n) const;
+
+    private:
+        static node_ptr to_node(base_ptr x) noexcept
+        { return static_cast<node_ptr>(x); }
+
+        // the size of the subtree x
+        static size_type subtree_size(base_ptr x) noexcept
+        {
+            static_assert(augment_traits::has_size, 
+                          "rb_tree order statistic needs an augmentation with size()");
+            return x == nullptr ? 0 : Augment::size(to_node(x)->aug);
+        }
+
+        difference_type distance_dispatch(const_iterator first, const_iterator last, 
+                                          m_true_type) const
+        { return distance(first, last); }
+
+        difference_type distance_dispatch(const_iterator first, const_iterator last, 
+                                          m_false_type) const
+        { return tinystl::distance(first, last); }
+
+        // the augmented data is a member of the node, constructed with the value
+        // (its real value is computed when the node is linked into the tree)
+        static void construct_aug(node_ptr p, m_true_type)
+        { tinystl::construct(tinystl::address_of(p->aug)); }
+
+        static void construct_aug(node_ptr, m_false_type) noexcept
+        {}
+
+        static void destroy_aug(node_ptr p, m_true_type)
+        { tinystl::destroy(tinystl::address_of(p->aug)); }
+
+        static void destroy_aug(node_ptr, m_false_type) noexcept
+        {}
+
+        // copy the augmented data of a cloned node
+        static void copy_aug(node_ptr dst, base_ptr src, m_true_type)
+        { dst->aug = to_node(src)->aug; }
+
+        static void copy_aug(node_ptr, base_ptr, m_false_type) noexcept
+        {}
+
 
         // node related
         template <class ...Args>
@@ -1079,11 +1459,44 @@ namespace tinystl
         // copy tree / erase tree
         base_ptr copy_from(base_ptr x, base_ptr p);
         void     erase_since(base_ptr x);
+
+        // join / split on detached trees:
+        // the root of a detached tree is black and has no parent, 
+        // h is its black height (black nodes on a path from the root, 0 for an empty tree)
+        base_ptr take_root() noexcept;
+        void     set_root(base_ptr t, size_type count) noexcept;
+
+        static size_type black_height(base_ptr x) noexcept;
+        static base_ptr  detach(base_ptr x, size_type parent_h, size_type& h) noexcept;
+
+        base_ptr join_node(base_ptr l, size_type hl, base_ptr k, 
+                           base_ptr r, size_type hr, size_type& h);
+        base_ptr join2(base_ptr l, size_type hl, base_ptr r, size_type hr, size_type& h);
+        base_ptr split_last(base_ptr t, size_type ht, base_ptr& rest, size_type& hrest);
+        void     split_less(base_ptr t, size_type ht, const key_type& key,
+                            base_ptr& l, size_type& hl, base_ptr& r, size_type& hr);
+        void     split3(base_ptr t, size_type ht, const key_type& key, base_ptr& l, size_type& hl,
+                        base_ptr& m, base_ptr& r, size_type& hr);
+
+        size_type count_nodes(base_ptr x, m_true_type) const noexcept
+        { return subtree_size(x); }
+        size_type count_nodes(base_ptr x, m_false_type) const noexcept
+        { return x == nullptr ? 0 : 1 + count_nodes(x->left, m_false_type()) + 
+                                        count_nodes(x->right, m_false_type()); }
+
+        static int parallel_depth(bool parallel) noexcept;
+
+        base_ptr union_since(base_ptr t1, size_type h1, base_ptr t2, size_type h2, 
+                             size_type& h, size_type& dups, int depth);
+        base_ptr intersect_since(base_ptr t1, size_type h1, base_ptr t2, size_type h2, 
+                                 size_type& h, size_type& kept, int depth);
+        base_ptr difference_since(base_ptr t1, size_type h1, base_ptr t2, size_type h2, 
+                                  size_type& h, size_type& removed, int depth);
     };
 
     //==========implement==================================================================
-    template <class T, class Compare>
-    rb_tree<T, Compare>::rb_tree(const rb_tree& rhs)
+    template <class T, class Compare, class Augment>
+    rb_tree<T, Compare, Augment>::rb_tree(const rb_tree& rhs)
     {
         rb_tree_init();
         if (rhs.node_count_ != 0)
@@ -1097,8 +1510,8 @@ namespace tinystl
     }
 
     // move constructor
-    template <class T, class Compare>
-    rb_tree<T, Compare>::rb_tree(rb_tree&& rhs) noexcept
+    template <class T, class Compare, class Augment>
+    rb_tree<T, Compare, Augment>::rb_tree(rb_tree&& rhs) noexcept
         :header_(tinystl::move(rhs.header_)),
         node_count_(rhs.node_count_),
         key_comp_(rhs.key_comp_)
@@ -1107,8 +1520,8 @@ namespace tinystl
     }
 
     // copy assignment
-    template <class T, class Compare>
-    rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(const rb_tree& rhs)
+    template <class T, class Compare, class Augment>
+    rb_tree<T, Compare, Augment>& rb_tree<T, Compare, Augment>::operator=(const rb_tree& rhs)
     {
         if (this != &rhs)
         {
@@ -1128,8 +1541,8 @@ namespace tinystl
     }
 
     // move assignment
-    template <class T, class Compare>
-    rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(rb_tree&& rhs)
+    template <class T, class Compare, class Augment>
+    rb_tree<T, Compare, Augment>& rb_tree<T, Compare, Augment>::operator=(rb_tree&& rhs)
     {
         clear();
         header_ = tinystl::move(rhs.header_);
@@ -1140,9 +1553,9 @@ namespace tinystl
     }
 
     // Insert elements in place, key values allow duplicates
-    template <class T, class Compare>
+    template <class T, class Compare, class Augment>
     template <class ...Args>
-    typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::emplace_multi(Args&& ...args)
+    typename rb_tree<T, Compare, Augment>::iterator rb_tree<T, Compare, Augment>::emplace_multi(Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(tinystl::forward<Args>(args)...);
@@ -1151,10 +1564,10 @@ namespace tinystl
     }
 
     // Insert elements in place, key values don't allow duplicates
-    template <class T, class Compare>
+    template <class T, class Compare, class Augment>
     template <class ...Args>
-    tinystl::pair<typename rb_tree<T, Compare>::iterator, bool> 
-    rb_tree<T, Compare>::emplace_unique(Args&& ...args)
+    tinystl::pair<typename rb_tree<T, Compare, Augment>::iterator, bool> 
+    rb_tree<T, Compare, Augment>::emplace_unique(Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(tinystl::forward<Args>(args)...);
@@ -1171,10 +1584,10 @@ namespace tinystl
     // Insert elements in place, and the key value is allowed to be repeated. 
     // When the hint position is close to the insertion position, 
     // the time complexity of the insertion operation can be reduced
-    template <class T, class Compare>
+    template <class T, class Compare, class Augment>
     template <class ...Args>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::emplace_multi_use_hint(iterator hint, Args&& ...args)
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::emplace_multi_use_hint(iterator hint, Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(tinystl::forward<Args>(args)...);
@@ -1213,10 +1626,10 @@ namespace tinystl
     // Insert elements in place, and the key value is not allowed to be repeated. 
     // When the hint position is close to the insertion position, 
     // the time complexity of the insertion operation can be reduced
-    template<class T, class Compare>
+    template <class T, class Compare, class Augment>
     template<class ...Args>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::emplace_unique_use_hint(iterator hint, Args&& ...args)
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::emplace_unique_use_hint(iterator hint, Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(tinystl::forward<Args>(args)...);
@@ -1263,9 +1676,9 @@ namespace tinystl
     }
 
     // Insert element, node key value allows duplication
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::insert_multi(const value_type& value)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::insert_multi(const value_type& value)
     {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         auto res = get_insert_multi_pos(value_traits::get_key(value));
@@ -1275,9 +1688,9 @@ namespace tinystl
     // Insert a new value, the node key value is not allowed to be repeated, return a pair, 
     // if the insertion is successful, the second parameter of the pair is true, 
     // otherwise it is false
-    template <class T, class Compare>
-    tinystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-    rb_tree<T, Compare>::insert_unique(const value_type& value)
+    template <class T, class Compare, class Augment>
+    tinystl::pair<typename rb_tree<T, Compare, Augment>::iterator, bool>
+    rb_tree<T, Compare, Augment>::insert_unique(const value_type& value)
     {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         auto res = get_insert_unique_pos(value_traits::get_key(value));
@@ -1289,34 +1702,35 @@ namespace tinystl
     }
 
     // Delete the node at the hint position
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::erase(iterator hint)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator rb_tree<T, Compare, Augment>::erase(iterator hint)
     {
-        auto node = hint.node->get_node_ptr();
+        auto node = to_node(hint.node);
         iterator next(node);
         ++next;
         
-        rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
+        rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost(), update_type());
         destroy_node(node);
         --node_count_;
         return next;
     }
 
     // Delete elements whose key value is equal to key, and return the number of deletions
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::size_type
-    rb_tree<T, Compare>::erase_multi(const key_type& key)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::size_type
+    rb_tree<T, Compare, Augment>::erase_multi(const key_type& key)
     {
         auto p = equal_range_multi(key);
-        size_type n = tinystl::distance(p.first, p.second);
+        size_type n = distance_dispatch(p.first, p.second, 
+                                        m_bool_constant<augment_traits::has_size>());
         erase(p.first, p.second);
         return n;
     }
 
     // Delete elements whose key value is equal to key, and return the number of deletions
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::size_type
-    rb_tree<T, Compare>::erase_unique(const key_type& key)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::size_type
+    rb_tree<T, Compare, Augment>::erase_unique(const key_type& key)
     {
         auto it = find(key);
         if (it != end())
@@ -1328,8 +1742,8 @@ namespace tinystl
     }
 
     // Delete elements in [first, last)
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::erase(iterator first, iterator last)
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::erase(iterator first, iterator last)
     {
         if (first == begin() && last == end())
         {
@@ -1343,8 +1757,8 @@ namespace tinystl
     }
 
     // clear rb tree
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::clear()
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::clear()
     {
         if (node_count_ != 0)
         {   
@@ -1357,9 +1771,9 @@ namespace tinystl
         }
     }
 
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::find(const key_type& key)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::find(const key_type& key)
     {
         auto y = header_;  // The last node not less than key
         auto x = root();
@@ -1378,9 +1792,9 @@ namespace tinystl
         return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
     }
 
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::const_iterator
-    rb_tree<T, Compare>::find(const key_type& key) const
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::const_iterator
+    rb_tree<T, Compare, Augment>::find(const key_type& key) const
     {
         auto y = header_;  
         auto x = root();
@@ -1400,9 +1814,9 @@ namespace tinystl
     }
 
     // The first position where the key value is not less than key
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::lower_bound(const key_type& key)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::lower_bound(const key_type& key)
     {
         auto y = header_;
         auto x = root();
@@ -1421,9 +1835,9 @@ namespace tinystl
         return iterator(y);
     }
 
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::const_iterator
-    rb_tree<T, Compare>::lower_bound(const key_type& key) const
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::const_iterator
+    rb_tree<T, Compare, Augment>::lower_bound(const key_type& key) const
     {
         auto y = header_;
         auto x = root();
@@ -1442,10 +1856,99 @@ namespace tinystl
         return const_iterator(y);
     }
 
+    // lower_bound_batch
+    template <class T, class Compare, class Augment>
+    template <class ForwardIter, class OutputIter>
+    OutputIter rb_tree<T, Compare, Augment>::
+    lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result)
+    {
+        const key_type* keys[rb_tree_batch_size];
+        base_ptr found[rb_tree_batch_size];
+        while (first != last)
+        {
+            size_type n = 0;
+            first = gather_batch(first, last, keys, n);
+            lower_bound_lanes(keys, found, n);
+            for (size_type i = 0; i < n; ++i)
+                *result++ = iterator(found[i]);
+        }
+        return result;
+    }
+
+    template <class T, class Compare, class Augment>
+    template <class ForwardIter, class OutputIter>
+    OutputIter rb_tree<T, Compare, Augment>::
+    lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+    {
+        const key_type* keys[rb_tree_batch_size];
+        base_ptr found[rb_tree_batch_size];
+        while (first != last)
+        {
+            size_type n = 0;
+            first = gather_batch(first, last, keys, n);
+            lower_bound_lanes(keys, found, n);
+            for (size_type i = 0; i < n; ++i)
+                *result++ = const_iterator(found[i]);
+        }
+        return result;
+    }
+
+    // gather_batch: the addresses of the next (at most rb_tree_batch_size) keys
+    template <class T, class Compare, class Augment>
+    template <class ForwardIter>
+    ForwardIter rb_tree<T, Compare, Augment>::
+    gather_batch(ForwardIter first, ForwardIter last, const key_type** keys, size_type& n) const
+    {
+        for (n = 0; first != last && n < rb_tree_batch_size; ++first)
+            keys[n++] = tinystl::address_of(*first);
+        return first;
+    }
+
+    // lower_bound_lanes: the lower_bound walk of n keys, interleaved level by level
+    // found[i] is the result for keys[i] (header_ for end())
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::
+    lower_bound_lanes(const key_type* const* keys, base_ptr* found, size_type n) const
+    {
+        base_ptr x[rb_tree_batch_size];
+        for (size_type i = 0; i < n; ++i)
+        {
+            x[i] = root();
+            found[i] = header_;
+        }
+        for (bool active = n > 0; active; )
+        {
+            active = false;
+            for (size_type i = 0; i < n; ++i)
+            {
+                base_ptr cur = x[i];
+                if (cur == nullptr)
+                    continue;
+                if (!key_comp_(value_traits::get_key(cur->get_node_ptr()->value), *keys[i]))
+                {
+                    // key <= cur
+                    found[i] = cur;
+                    cur = cur->left;
+                }
+                else
+                {
+                    cur = cur->right;
+                }
+                x[i] = cur;
+                if (cur != nullptr)
+                {
+                    // loaded while the other keys take their step
+                    TINYSTL_PREFETCH(cur);
+                    active = true;
+                }
+            }
+        }
+    }
+
     // The last position where the key value is not less than key
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::upper_bound(const key_type& key)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::upper_bound(const key_type& key)
     {
         auto y = header_;
         auto x = root();
@@ -1464,9 +1967,9 @@ namespace tinystl
         return iterator(y);
     }
 
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::const_iterator
-    rb_tree<T, Compare>::upper_bound(const key_type& key) const
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::const_iterator
+    rb_tree<T, Compare, Augment>::upper_bound(const key_type& key) const
     {
         auto y = header_;
         auto x = root();
@@ -1485,9 +1988,103 @@ namespace tinystl
         return const_iterator(y);
     }
 
+    // the k-th element: go left if the left subtree has more than k nodes,
+    // otherwise skip the left subtree and the node itself
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::find_by_order(size_type k)
+    {
+        auto x = root();
+        while (x != nullptr)
+        {
+            auto n = subtree_size(x->left);
+            if (k < n)
+            {
+                x = x->left;
+            }
+            else if (k == n)
+            {
+                return iterator(x);
+            }
+            else
+            {
+                k -= n + 1;
+                x = x->right;
+            }
+        }
+        return end();
+    }
+
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::const_iterator
+    rb_tree<T, Compare, Augment>::find_by_order(size_type k) const
+    {
+        auto x = root();
+        while (x != nullptr)
+        {
+            auto n = subtree_size(x->left);
+            if (k < n)
+            {
+                x = x->left;
+            }
+            else if (k == n)
+            {
+                return const_iterator(x);
+            }
+            else
+            {
+                k -= n + 1;
+                x = x->right;
+            }
+        }
+        return end();
+    }
+
+    // the same walk as lower_bound, counting the nodes left behind
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::size_type
+    rb_tree<T, Compare, Augment>::order_of_key(const key_type& key) const
+    {
+        size_type r = 0;
+        auto x = root();
+        while (x != nullptr)
+        {
+            if (key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
+            { 
+                // x < key: x and its left subtree are all before key
+                r += subtree_size(x->left) + 1;
+                x = x->right;
+            }
+            else
+            {
+                x = x->left;
+            }
+        }
+        return r;
+    }
+
+    // walk up from it, adding the left part every time we come from a right child
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::size_type
+    rb_tree<T, Compare, Augment>::rank(const_iterator it) const
+    {
+        auto x = it.node;
+        if (x == header_)
+            return node_count_;
+        size_type r = subtree_size(x->left);
+        while (x != root())
+        {
+            auto p = x->get_parent();
+            if (x == p->right)
+                r += subtree_size(p->left) + 1;
+            x = p;
+        }
+        return r;
+    }
+
     // swap rb tree
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::swap(rb_tree& rhs) noexcept
     {
         if (this != &rhs)
         {
@@ -1499,18 +2096,27 @@ namespace tinystl
 
     //=====================================================================================
     // helper function
-    template <class T, class Compare>
+    template <class T, class Compare, class Augment>
     template <class ...Args>
-    typename rb_tree<T, Compare>::node_ptr
-    rb_tree<T, Compare>::create_node(Args&&... args)
+    typename rb_tree<T, Compare, Augment>::node_ptr
+    rb_tree<T, Compare, Augment>::create_node(Args&&... args)
     {
         auto tmp = node_allocator::allocate(1);
         try
         {
             data_allocator::construct(tinystl::address_of(tmp->value), tinystl::forward<Args>(args)...);
+            try
+            {
+                construct_aug(tmp, m_bool_constant<augment_traits::enabled>());
+            }
+            catch (...)
+            {
+                data_allocator::destroy(&tmp->value);
+                throw;
+            }
             tmp->left = nullptr;
             tmp->right = nullptr;
-            tmp->parent = nullptr;
+            tmp->set_parent_color(nullptr, rb_tree_red);
         }
         catch (...)
         {
@@ -1520,46 +2126,49 @@ namespace tinystl
         return tmp;
     }
 
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::node_ptr
-    rb_tree<T, Compare>::clone_node(base_ptr x)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::node_ptr
+    rb_tree<T, Compare, Augment>::clone_node(base_ptr x)
     {
         node_ptr tmp = create_node(x->get_node_ptr()->value);
-        tmp->color = x->color;
+        tmp->set_color(x->get_color());
         tmp->left = nullptr;
         tmp->right = nullptr;
+        // the copy has the same shape, so the data stays valid
+        copy_aug(tmp, x, m_bool_constant<augment_traits::enabled>());
         return tmp;
     }
 
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::destroy_node(node_ptr p)
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::destroy_node(node_ptr p)
     {
+        destroy_aug(p, m_bool_constant<augment_traits::enabled>());
         data_allocator::destroy(&p->value);
         node_allocator::deallocate(p);
     }
 
     // constructor helper function
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::rb_tree_init()
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::rb_tree_init()
     {
         header_ = base_allocator::allocate(1);
-        header_->color = rb_tree_red;  // header_ 's color is red, different form root
-        root() = nullptr;
+        // header_ 's color is red, different form root
+        header_->set_parent_color(nullptr, rb_tree_red);
         leftmost() = header_;
         rightmost() = header_;
         node_count_ = 0;
     }
 
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::reset()
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::reset()
     {
         header_ = nullptr;
         node_count_ = 0;
     }
 
-    template <class T, class Compare>
-    tinystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-    rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key)
+    template <class T, class Compare, class Augment>
+    tinystl::pair<typename rb_tree<T, Compare, Augment>::base_ptr, bool>
+    rb_tree<T, Compare, Augment>::get_insert_multi_pos(const key_type& key)
     {
         auto x = root();
         auto y = header_;
@@ -1573,9 +2182,9 @@ namespace tinystl
         return tinystl::make_pair(y, add_to_left);
     }
 
-    template <class T, class Compare>
-    tinystl::pair<tinystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-    rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key)
+    template <class T, class Compare, class Augment>
+    tinystl::pair<tinystl::pair<typename rb_tree<T, Compare, Augment>::base_ptr, bool>, bool>
+    rb_tree<T, Compare, Augment>::get_insert_unique_pos(const key_type& key)
     { 
         auto x = root();
         auto y = header_;
@@ -1608,13 +2217,13 @@ namespace tinystl
     // first parameter:  the parent node of the insertion point, 
     // second parameter: value is the value to be inserted, 
     // third parameter:  add_to_left indicates whether to insert on the left
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::insert_value_at(base_ptr x, const value_type& value, 
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::insert_value_at(base_ptr x, const value_type& value, 
                                          bool add_to_left)
     {
         node_ptr node = create_node(value);
-        node->parent = x;
+        node->set_parent(x);
         auto base_node = node->get_base_ptr();
         if (x == header_)
         {
@@ -1634,16 +2243,18 @@ namespace tinystl
             if (rightmost() == x)
                 rightmost() = base_node;
         }
-        rb_tree_insert_rebalance(base_node, root());
+        // the new leaf and its ancestors have one more node in their subtrees
+        rb_tree_update_to_root(base_node, root(), update_type());
+        rb_tree_insert_rebalance(base_node, root(), update_type());
         ++node_count_;
         return iterator(node);
     }
     
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator
+    rb_tree<T, Compare, Augment>::insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
     {
-        node->parent = x;
+        node->set_parent(x);
         auto base_node = node->get_base_ptr();
         if (x == header_)
         {
@@ -1663,15 +2274,17 @@ namespace tinystl
             if (rightmost() == x)
                 rightmost() = base_node;
         }
-        rb_tree_insert_rebalance(base_node, root());
+        // the new leaf and its ancestors have one more node in their subtrees
+        rb_tree_update_to_root(base_node, root(), update_type());
+        rb_tree_insert_rebalance(base_node, root(), update_type());
         ++node_count_;
         return iterator(node);
     }
 
     // Insert an element, the key value is allowed to be repeated, use hint
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator 
-    rb_tree<T, Compare>::insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator 
+    rb_tree<T, Compare, Augment>::insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
     {
         // Look for insertable locations near hint
         auto np = hint.node;
@@ -1696,9 +2309,9 @@ namespace tinystl
     }
 
     // Insert elements, the key value is not allowed to be repeated, use hint
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::iterator 
-    rb_tree<T, Compare>::insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::iterator 
+    rb_tree<T, Compare, Augment>::insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
     {
         // Look for insertable locations near hint
         auto np = hint.node;
@@ -1728,12 +2341,12 @@ namespace tinystl
     }
 
     // Recursively copy a tree, the node starts from x, and p is the parent node of x
-    template <class T, class Compare>
-    typename rb_tree<T, Compare>::base_ptr
-    rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::copy_from(base_ptr x, base_ptr p)
     {
         auto top = clone_node(x);
-        top->parent = p;
+        top->set_parent(p);
         try
         {
             if (x->right)
@@ -1744,7 +2357,7 @@ namespace tinystl
             {
                 auto y = clone_node(x);
                 p->left = y;
-                y->parent = p;
+                y->set_parent(p);
                 if (x->right)
                     y->right = copy_from(x->right, y);
                 p = y;
@@ -1761,58 +2374,518 @@ namespace tinystl
 
     // erase_since
     // deleting the node and its subtrees starts at node x 
-    template <class T, class Compare>
-    void rb_tree<T, Compare>::erase_since(base_ptr x)
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::erase_since(base_ptr x)
     {
         while (x != nullptr)
         {
             erase_since(x->right);
             auto y = x->left;
-            destroy_node(x->get_node_ptr());
+            destroy_node(to_node(x));
             x = y;
         }
     }
 
+    //=========== join / split ============================================================
+    // blogs: G. Blelloch, D. Ferizovic, Y. Sun, "Just Join for Parallel Ordered Sets"
+    //
+    // join_node(l, k, r): every key of l <= k <= every key of r.
+    // Walk down the right spine of the higher tree (left spine if r is higher) to a black node c
+    // with the black height of the other tree, put k (red) in c's place with c and the other tree
+    // as its children, then fix a red parent like an insert. O(|hl - hr| + 1).
+    // split / union / ... are recursions around join_node.
+
+    // detach the whole tree from header_
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::take_root() noexcept
+    {
+        auto t = root();
+        if (t != nullptr)
+            t->set_parent(nullptr);
+        root() = nullptr;
+        leftmost() = header_;
+        rightmost() = header_;
+        node_count_ = 0;
+        return t;
+    }
+
+    // link a detached tree to header_
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::set_root(base_ptr t, size_type count) noexcept
+    {
+        root() = t;
+        if (t == nullptr)
+        {
+            leftmost() = header_;
+            rightmost() = header_;
+        }
+        else
+        {
+            t->set_parent(header_);
+            rb_tree_set_black(t);
+            leftmost() = rb_tree_min(t);
+            rightmost() = rb_tree_max(t);
+        }
+        node_count_ = count;
+    }
+
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::size_type
+    rb_tree<T, Compare, Augment>::black_height(base_ptr x) noexcept
+    {
+        size_type h = 0;
+        for (; x != nullptr; x = x->left)
+        {
+            if (!rb_tree_is_red(x))
+                ++h;
+        }
+        return h;
+    }
+
+    // cut the child x off its black parent (black height parent_h),
+    // a red child becomes a black root, so its black height is one more
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::detach(base_ptr x, size_type parent_h, size_type& h) noexcept
+    {
+        h = parent_h - 1;
+        if (x != nullptr)
+        {
+            if (rb_tree_is_red(x))
+            {
+                rb_tree_set_black(x);
+                ++h;
+            }
+            x->set_parent(nullptr);
+        }
+        return x;
+    }
+
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::join_node(base_ptr l, size_type hl, base_ptr k,
+                                            base_ptr r, size_type hr, size_type& h)
+    {
+        base_ptr t = nullptr;  // root of the result
+        base_ptr p = nullptr;  // the new parent of k
+        base_ptr c = nullptr;  // the node k replaces
+        if (hl >= hr)
+        {
+            t = l;
+            c = l;
+            for (auto hc = hl; c != nullptr && (hc != hr || rb_tree_is_red(c)); c = c->right)
+            {
+                if (!rb_tree_is_red(c))
+                    --hc;
+                p = c;
+            }
+            k->left = c;
+            k->right = r;
+            if (p == nullptr)
+                t = k;
+            else
+                p->right = k;
+            if (r != nullptr)
+                r->set_parent(k);
+        }
+        else
+        {
+            t = r;
+            c = r;
+            for (auto hc = hr; c != nullptr && (hc != hl || rb_tree_is_red(c)); c = c->left)
+            {
+                if (!rb_tree_is_red(c))
+                    --hc;
+                p = c;
+            }
+            k->left = l;
+            k->right = c;
+            p->left = k;
+            if (l != nullptr)
+                l->set_parent(k);
+        }
+        if (c != nullptr)
+            c->set_parent(k);
+        k->set_parent(p);
+        rb_tree_update_to_root(k, t, update_type());
+        auto grew = rb_tree_insert_rebalance(k, t, update_type());
+        h = (hl < hr ? hr : hl) + (grew ? 1 : 0);
+        return t;
+    }
+
+    // join without a middle node: take the last node of l as the middle
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::join2(base_ptr l, size_type hl, 
+                                        base_ptr r, size_type hr, size_type& h)
+    {
+        if (l == nullptr)
+        {
+            h = hr;
+            return r;
+        }
+        base_ptr rest = nullptr;
+        size_type hrest = 0;
+        auto k = split_last(l, hl, rest, hrest);
+        return join_node(rest, hrest, k, r, hr, h);
+    }
+
+    // cut the last node off t (not empty), the rest of the tree is in rest
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::split_last(base_ptr t, size_type ht, 
+                                             base_ptr& rest, size_type& hrest)
+    {
+        size_type h1 = 0, h2 = 0;
+        auto tl = detach(t->left, ht, h1);
+        auto tr = detach(t->right, ht, h2);
+        t->left = nullptr;
+        t->right = nullptr;
+        if (tr == nullptr)
+        {
+            rest = tl;
+            hrest = h1;
+            return t;
+        }
+        base_ptr r1 = nullptr;
+        size_type hr1 = 0;
+        auto k = split_last(tr, h2, r1, hr1);
+        rest = join_node(tl, h1, t, r1, hr1, hrest);
+        return k;
+    }
+
+    // l: the keys less than key, r: the others
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::split_less(base_ptr t, size_type ht, const key_type& key,
+                                                  base_ptr& l, size_type& hl, 
+                                                  base_ptr& r, size_type& hr)
+    {
+        if (t == nullptr)
+        {
+            l = r = nullptr;
+            hl = hr = 0;
+            return;
+        }
+        size_type h1 = 0, h2 = 0;
+        auto tl = detach(t->left, ht, h1);
+        auto tr = detach(t->right, ht, h2);
+        t->left = nullptr;
+        t->right = nullptr;
+        if (key_comp_(value_traits::get_key(t->get_node_ptr()->value), key))
+        {
+            // t < key: t and tl go left
+            base_ptr l1 = nullptr;
+            size_type hl1 = 0;
+            split_less(tr, h2, key, l1, hl1, r, hr);
+            l = join_node(tl, h1, t, l1, hl1, hl);
+        }
+        else
+        {
+            base_ptr r1 = nullptr;
+            size_type hr1 = 0;
+            split_less(tl, h1, key, l, hl, r1, hr1);
+            r = join_node(r1, hr1, t, tr, h2, hr);
+        }
+    }
+
+    // l: the keys less than key, m: the node equal to key (or nullptr), r: the keys greater
+    // (unique keys)
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::split3(base_ptr t, size_type ht, const key_type& key,
+                                              base_ptr& l, size_type& hl, base_ptr& m,
+                                              base_ptr& r, size_type& hr)
+    {
+        if (t == nullptr)
+        {
+            l = m = r = nullptr;
+            hl = hr = 0;
+            return;
+        }
+        size_type h1 = 0, h2 = 0;
+        auto tl = detach(t->left, ht, h1);
+        auto tr = detach(t->right, ht, h2);
+        t->left = nullptr;
+        t->right = nullptr;
+        const auto& tkey = value_traits::get_key(t->get_node_ptr()->value);
+        if (key_comp_(key, tkey))
+        {
+            base_ptr r1 = nullptr;
+            size_type hr1 = 0;
+            split3(tl, h1, key, l, hl, m, r1, hr1);
+            r = join_node(r1, hr1, t, tr, h2, hr);
+        }
+        else if (key_comp_(tkey, key))
+        {
+            base_ptr l1 = nullptr;
+            size_type hl1 = 0;
+            split3(tr, h2, key, l1, hl1, m, r, hr);
+            l = join_node(tl, h1, t, l1, hl1, hl);
+        }
+        else
+        {
+            l = tl;
+            hl = h1;
+            m = t;
+            r = tr;
+            hr = h2;
+        }
+    }
+
+    // how many levels of the recursion may fork
+    template <class T, class Compare, class Augment>
+    int rb_tree<T, Compare, Augment>::parallel_depth(bool parallel) noexcept
+    {
+    #if RB_TREE_PARALLEL_SET_OPS
+        if (parallel)
+        {
+            unsigned n = std::thread::hardware_concurrency();
+            int depth = 0;
+            while ((1u << depth) < n)
+                ++depth;
+            return depth;
+        }
+    #else
+        (void)parallel;
+    #endif
+        return 0;
+    }
+
+    // t1 ∪ t2, split t2 by the root of t1 and join the unions of the halves
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::union_since(base_ptr t1, size_type h1, base_ptr t2, size_type h2,
+                                              size_type& h, size_type& dups, int depth)
+    {
+        if (t1 == nullptr)
+        {
+            h = h2;
+            return t2;
+        }
+        if (t2 == nullptr)
+        {
+            h = h1;
+            return t1;
+        }
+        size_type hl1 = 0, hr1 = 0, hl2 = 0, hr2 = 0;
+        auto l1 = detach(t1->left, h1, hl1);
+        auto r1 = detach(t1->right, h1, hr1);
+        t1->left = nullptr;
+        t1->right = nullptr;
+        base_ptr l2 = nullptr, m = nullptr, r2 = nullptr;
+        split3(t2, h2, value_traits::get_key(t1->get_node_ptr()->value), l2, hl2, m, r2, hr2);
+        if (m != nullptr)
+        {
+            destroy_node(to_node(m));
+            ++dups;
+        }
+        base_ptr l = nullptr, r = nullptr;
+        size_type hl = 0, hr = 0, dups_left = 0;
+        rb_tree_fork([&]() { l = union_since(l1, hl1, l2, hl2, hl, dups_left, depth - 1); },
+                     [&]() { r = union_since(r1, hr1, r2, hr2, hr, dups, depth - 1); },
+                     depth > 0 && h1 >= RB_TREE_PARALLEL_MIN_HEIGHT);
+        dups += dups_left;
+        return join_node(l, hl, t1, r, hr, h);
+    }
+
+    // t1 ∩ t2, the nodes of t1 are kept
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::intersect_since(base_ptr t1, size_type h1, 
+                                                  base_ptr t2, size_type h2,
+                                                  size_type& h, size_type& kept, int depth)
+    {
+        if (t1 == nullptr || t2 == nullptr)
+        {
+            erase_since(t1);
+            erase_since(t2);
+            h = 0;
+            return nullptr;
+        }
+        size_type hl1 = 0, hr1 = 0, hl2 = 0, hr2 = 0;
+        auto l1 = detach(t1->left, h1, hl1);
+        auto r1 = detach(t1->right, h1, hr1);
+        t1->left = nullptr;
+        t1->right = nullptr;
+        base_ptr l2 = nullptr, m = nullptr, r2 = nullptr;
+        split3(t2, h2, value_traits::get_key(t1->get_node_ptr()->value), l2, hl2, m, r2, hr2);
+        base_ptr l = nullptr, r = nullptr;
+        size_type hl = 0, hr = 0, kept_left = 0;
+        rb_tree_fork([&]() { l = intersect_since(l1, hl1, l2, hl2, hl, kept_left, depth - 1); },
+                     [&]() { r = intersect_since(r1, hr1, r2, hr2, hr, kept, depth - 1); },
+                     depth > 0 && h1 >= RB_TREE_PARALLEL_MIN_HEIGHT);
+        kept += kept_left;
+        if (m != nullptr)
+        {
+            destroy_node(to_node(m));
+            ++kept;
+            return join_node(l, hl, t1, r, hr, h);
+        }
+        destroy_node(to_node(t1));
+        return join2(l, hl, r, hr, h);
+    }
+
+    // t1 - t2
+    template <class T, class Compare, class Augment>
+    typename rb_tree<T, Compare, Augment>::base_ptr
+    rb_tree<T, Compare, Augment>::difference_since(base_ptr t1, size_type h1, 
+                                                   base_ptr t2, size_type h2,
+                                                   size_type& h, size_type& removed, int depth)
+    {
+        if (t1 == nullptr)
+        {
+            erase_since(t2);
+            h = 0;
+            return nullptr;
+        }
+        if (t2 == nullptr)
+        {
+            h = h1;
+            return t1;
+        }
+        size_type hl1 = 0, hr1 = 0, hl2 = 0, hr2 = 0;
+        auto l1 = detach(t1->left, h1, hl1);
+        auto r1 = detach(t1->right, h1, hr1);
+        t1->left = nullptr;
+        t1->right = nullptr;
+        base_ptr l2 = nullptr, m = nullptr, r2 = nullptr;
+        split3(t2, h2, value_traits::get_key(t1->get_node_ptr()->value), l2, hl2, m, r2, hr2);
+        base_ptr l = nullptr, r = nullptr;
+        size_type hl = 0, hr = 0, removed_left = 0;
+        rb_tree_fork([&]() { l = difference_since(l1, hl1, l2, hl2, hl, removed_left, depth - 1); },
+                     [&]() { r = difference_since(r1, hr1, r2, hr2, hr, removed, depth - 1); },
+                     depth > 0 && h1 >= RB_TREE_PARALLEL_MIN_HEIGHT);
+        removed += removed_left;
+        if (m != nullptr)
+        {
+            destroy_node(to_node(m));
+            destroy_node(to_node(t1));
+            ++removed;
+            return join2(l, hl, r, hr, h);
+        }
+        return join_node(l, hl, t1, r, hr, h);
+    }
+
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::join(rb_tree& right)
+    {
+        if (this == &right || right.empty())
+            return;
+        TINYSTL_DEBUG(empty() || 
+                      !key_comp_(value_traits::get_key(*right.begin()), 
+                                 value_traits::get_key(rightmost()->get_node_ptr()->value)));
+        auto n = node_count_ + right.node_count_;
+        auto h1 = black_height(root());
+        auto h2 = black_height(right.root());
+        auto t1 = take_root();
+        auto t2 = right.take_root();
+        size_type h = 0;
+        set_root(join2(t1, h1, t2, h2, h), n);
+    }
+
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::split(const key_type& key, rb_tree& right)
+    {
+        if (this == &right)
+            return;
+        right.clear();
+        auto n = node_count_;
+        auto h = black_height(root());
+        base_ptr l = nullptr, r = nullptr;
+        size_type hl = 0, hr = 0;
+        split_less(take_root(), h, key, l, hl, r, hr);
+        auto nr = count_nodes(r, m_bool_constant<augment_traits::has_size>());
+        set_root(l, n - nr);
+        right.set_root(r, nr);
+    }
+
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::union_with(rb_tree& other, bool parallel)
+    {
+        if (this == &other)
+            return;
+        auto n = node_count_ + other.node_count_;
+        auto h1 = black_height(root());
+        auto h2 = black_height(other.root());
+        auto t1 = take_root();
+        auto t2 = other.take_root();
+        size_type h = 0, dups = 0;
+        auto t = union_since(t1, h1, t2, h2, h, dups, parallel_depth(parallel));
+        set_root(t, n - dups);
+    }
+
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::intersect_with(rb_tree& other, bool parallel)
+    {
+        if (this == &other)
+            return;
+        auto h1 = black_height(root());
+        auto h2 = black_height(other.root());
+        auto t1 = take_root();
+        auto t2 = other.take_root();
+        size_type h = 0, kept = 0;
+        auto t = intersect_since(t1, h1, t2, h2, h, kept, parallel_depth(parallel));
+        set_root(t, kept);
+    }
+
+    template <class T, class Compare, class Augment>
+    void rb_tree<T, Compare, Augment>::difference_with(rb_tree& other, bool parallel)
+    {
+        if (this == &other)
+        {
+            clear();
+            return;
+        }
+        auto n = node_count_;
+        auto h1 = black_height(root());
+        auto h2 = black_height(other.root());
+        auto t1 = take_root();
+        auto t2 = other.take_root();
+        size_type h = 0, removed = 0;
+        auto t = difference_since(t1, h1, t2, h2, h, removed, parallel_depth(parallel));
+        set_root(t, n - removed);
+    }
+
     // overload comparison operations
-    template <class T, class Compare>
-    bool operator==(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+    template <class T, class Compare, class Augment>
+    bool operator==(const rb_tree<T, Compare, Augment>& lhs, const rb_tree<T, Compare, Augment>& rhs)
     {
         return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class T, class Compare>
-    bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+    template <class T, class Compare, class Augment>
+    bool operator<(const rb_tree<T, Compare, Augment>& lhs, const rb_tree<T, Compare, Augment>& rhs)
     {
         return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template <class T, class Compare>
-    bool operator!=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+    template <class T, class Compare, class Augment>
+    bool operator!=(const rb_tree<T, Compare, Augment>& lhs, const rb_tree<T, Compare, Augment>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class T, class Compare>
-    bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+    template <class T, class Compare, class Augment>
+    bool operator>(const rb_tree<T, Compare, Augment>& lhs, const rb_tree<T, Compare, Augment>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class T, class Compare>
-    bool operator<=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+    template <class T, class Compare, class Augment>
+    bool operator<=(const rb_tree<T, Compare, Augment>& lhs, const rb_tree<T, Compare, Augment>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class T, class Compare>
-    bool operator>=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+    template <class T, class Compare, class Augment>
+    bool operator>=(const rb_tree<T, Compare, Augment>& lhs, const rb_tree<T, Compare, Augment>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // swap
-    template <class T, class Compare>
-    void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept
+    template <class T, class Compare, class Augment>
+    void swap(rb_tree<T, Compare, Augment>& lhs, rb_tree<T, Compare, Augment>& rhs) noexcept
     {
         lhs.swap(rhs);
     }
@@ -0,0 +1,664 @@
+#ifndef _RH_HASHTABLE_H_
+#define _RH_HASHTABLE_H_
+
+// rh_hashtable : open addressing hash table with Robin Hood insertion and backward-shift deletion
+
+// notes:
+// hashtable.h chains the elements of a bucket in separately allocated nodes: every lookup
+// follows pointers, erase frees nodes all over the heap, and at max_load_factor 1.0 some chains get long.
+// Here the elements live in the bucket array itself, and a key that finds its home bucket taken
+// goes on to the next ones (linear probing). The probe distance of an element is how far it is
+// from its home bucket, and is kept in the bucket next to the element.
+//
+// Robin Hood insertion: when the new element has probed further than the element in a bucket,
+// it takes that bucket ("takes from the rich"), and the displaced element goes on probing.
+// So the elements of a run are ordered by home bucket, the distances stay short and even,
+// and a lookup can stop as soon as it meets an element that is closer to home than the key would be.
+// Inserting at bucket i is done by shifting the elements of [i, first empty bucket) one bucket
+// forward, which is the same result as displacing them one by one.
+//
+// Backward-shift deletion: the elements after the erased one move one bucket back, until an empty
+// bucket or an element at its home, so no tombstone is left and the distances shrink again.
+//
+// With that the table can run at max_load_factor 0.9 (the default) with short probes,
+// probe_stats() tells how long they are.
+// The bucket count is a power of two and the home bucket comes from the high bits of
+// hash * 2^64 / golden ratio (Fibonacci hashing), because hash functions like the identity
+// hash of integers have poor low bits.
+//
+// Keys are unique. Inserting or erasing moves other elements, so it invalidates iterators,
+// pointers and references. value_type's move constructor should not throw.
+// erase(position) returns the iterator of the next element as usual, but when the run after
+// position wraps round the end of the bucket array, the element of bucket 0 moves to the last bucket
+// and a loop that erases while it iterates sees it twice; erase_if(pred) does not have that problem.
+
+#include <initializer_list>
+#include <cstdint>
+#include <type_traits>
+
+#include "functional.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "hashtable.h"
+
+namespace tinystl
+{
+
+    // a bucket: the probe distance of its element, and the element itself
+    template <class T>
+    struct rh_bucket
+    {
+        int dist;  // distance from the home bucket, -1 when the bucket is empty
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* value_ptr() noexcept
+        { return reinterpret_cast<T*>(&storage); }
+
+        const T* value_ptr() const noexcept
+        { return reinterpret_cast<const T*>(&storage); }
+
+        bool empty() const noexcept
+        { return dist < 0; }
+    };
+
+    // probe length statistics, the probe length of an element is its distance + 1:
+    // the number of buckets a successful find looks at
+    struct rh_probe_stats
+    {
+        size_t size;  // number of elements
+        size_t max;   // the longest probe
+        double mean;  // the average probe
+    };
+
+    // iterator : walks the occupied buckets
+    template <class T, bool IsConst>
+    struct rh_iterator :public tinystl::iterator<tinystl::forward_iterator_tag, T>
+    {
+        typedef rh_iterator<T, IsConst>                                 self;
+        typedef typename std::conditional<IsConst, const rh_bucket<T>*, rh_bucket<T>*>::type
+                                                                        bucket_ptr;
+
+        typedef T                                                       value_type;
+        typedef typename std::conditional<IsConst, const T*, T*>::type  pointer;
+        typedef typename std::conditional<IsConst, const T&, T&>::type  reference;
+
+        bucket_ptr cur;   // the current bucket
+        bucket_ptr last;  // the end of the bucket array
+
+        rh_iterator() = default;
+        rh_iterator(bucket_ptr c, bucket_ptr l) :cur(c), last(l)
+        {}
+
+        // iterator to const_iterator
+        template <bool C, typename std::enable_if<IsConst && !C, int>::type = 0>
+        rh_iterator(const rh_iterator<T, C>& rhs) :cur(rhs.cur), last(rhs.last)
+        {}
+
+        reference operator*() const
+        { return *cur->value_ptr(); }
+
+        pointer operator->() const
+        { return cur->value_ptr(); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(cur != last);
+            ++cur;
+            while (cur != last && cur->empty())
+                ++cur;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return cur == rhs.cur; }
+
+        bool operator!=(const self& rhs) const
+        { return cur != rhs.cur; }
+    };
+
+    //=============rh_hashtable============================================================
+    // first parameter: value type, a pair is a key -> value map (see ht_value_traits)
+    // second parameter: hash function
+    // third parameter: key's comparison function
+    template <class T, class Hash, class KeyEqual>
+    class rh_hashtable
+    {
+    public:
+        typedef ht_value_traits<T>                          value_traits;
+        typedef typename value_traits::key_type             key_type;
+        typedef typename value_traits::mapped_type          mapped_type;
+        typedef typename value_traits::value_type           value_type;
+        typedef Hash                                        hasher;
+        typedef KeyEqual                                    key_equal;
+
+        typedef rh_bucket<T>                                bucket_type;
+        typedef tinystl::allocator<bucket_type>             bucket_allocator;
+
+        typedef T*                                          pointer;
+        typedef const T*                                    const_pointer;
+        typedef T&                                          reference;
+        typedef const T&                                    const_reference;
+        typedef size_t                                      size_type;
+        typedef ptrdiff_t                                   difference_type;
+
+        typedef rh_iterator<T, false>                       iterator;
+        typedef rh_iterator<T, true>                        const_iterator;
+
+    private:
+        bucket_type* buckets_;
+        size_type    bucket_size_;  // 0 or a power of two
+        size_type    shift_;        // 64 - log2(bucket_size_)
+        size_type    size_;
+        float        mlf_;
+        hasher       hash_;
+        key_equal    equal_;
+
+    public:
+        // constructor
+        explicit rh_hashtable(size_type bucket_count = 0, const Hash& hash = Hash(),
+                              const KeyEqual& equal = KeyEqual())
+            :buckets_(nullptr), bucket_size_(0), shift_(64), size_(0), mlf_(0.9f),
+             hash_(hash), equal_(equal)
+        {
+            if (bucket_count != 0)
+                rehash(bucket_count);
+        }
+
+        template <class InputIter>
+        rh_hashtable(InputIter first, InputIter last, size_type bucket_count = 0,
+                     const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            :rh_hashtable(bucket_count, hash, equal)
+        {
+            insert_unique(first, last);
+        }
+
+        rh_hashtable(std::initializer_list<value_type> ilist)
+            :rh_hashtable(0)
+        {
+            insert_unique(ilist.begin(), ilist.end());
+        }
+
+        rh_hashtable(const rh_hashtable& rhs)
+            :rh_hashtable(0, rhs.hash_, rhs.equal_)
+        {
+            mlf_ = rhs.mlf_;
+            reserve(rhs.size_);
+            for (auto it = rhs.begin(); it != rhs.end(); ++it)
+                insert_new(*it);
+        }
+
+        rh_hashtable(rh_hashtable&& rhs) noexcept
+            :buckets_(rhs.buckets_), bucket_size_(rhs.bucket_size_), shift_(rhs.shift_),
+             size_(rhs.size_), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+        {
+            rhs.buckets_ = nullptr;
+            rhs.bucket_size_ = 0;
+            rhs.shift_ = 64;
+            rhs.size_ = 0;
+        }
+
+        rh_hashtable& operator=(const rh_hashtable& rhs)
+        {
+            if (this != &rhs)
+            {
+                rh_hashtable tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        rh_hashtable& operator=(rh_hashtable&& rhs) noexcept
+        {
+            rh_hashtable tmp(tinystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ~rh_hashtable()
+        {
+            clear();
+            bucket_allocator::deallocate(buckets_, bucket_size_);
+        }
+
+        // iterator related operations-----------------------------------------------------
+        iterator begin() noexcept
+        { return iterator(first_bucket(), buckets_ + bucket_size_); }
+
+        const_iterator begin() const noexcept
+        { return const_iterator(first_bucket(), buckets_ + bucket_size_); }
+
+        iterator end() noexcept
+        { return iterator(buckets_ + bucket_size_, buckets_ + bucket_size_); }
+
+        const_iterator end() const noexcept
+        { return const_iterator(buckets_ + bucket_size_, buckets_ + bucket_size_); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // container related operations----------------------------------------------------
+        bool empty() const noexcept
+        { return size_ == 0; }
+
+        size_type size() const noexcept
+        { return size_; }
+
+        size_type max_size() const noexcept
+        { return static_cast<size_type>(-1); }
+
+        // insert : the key values are not allowed to be repeated
+        template <class ...Args>
+        pair<iterator, bool> emplace_unique(Args&& ...args);
+
+        pair<iterator, bool> insert_unique(const value_type& value)
+        { return insert_aux(value_traits::get_key(value), value); }
+
+        pair<iterator, bool> insert_unique(value_type&& value)
+        { return insert_aux(value_traits::get_key(value), tinystl::move(value)); }
+
+        template <class InputIter>
+        void insert_unique(InputIter first, InputIter last)
+        {
+            for (; first != last; ++first)
+                insert_unique(*first);
+        }
+
+        // erase : the elements after position move back one bucket,
+        // returns the iterator following the erased element
+        iterator erase(const_iterator position);
+        size_type erase_unique(const key_type& key);
+
+        // erase every element for which pred is true, returns how many
+        template <class UnaryPredicate>
+        size_type erase_if(UnaryPredicate pred);
+
+        void clear() noexcept;
+        void swap(rh_hashtable& rhs) noexcept;
+
+        // find
+        size_type count(const key_type& key) const
+        { return find_bucket(key) != nullptr ? 1 : 0; }
+
+        bool contains(const key_type& key) const
+        { return find_bucket(key) != nullptr; }
+
+        iterator find(const key_type& key)
+        {
+            auto b = find_bucket(key);
+            return b ? iterator(b, buckets_ + bucket_size_) : end();
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            auto b = find_bucket(key);
+            return b ? const_iterator(b, buckets_ + bucket_size_) : end();
+        }
+
+        // bucket interface
+        size_type bucket_count() const noexcept
+        { return bucket_size_; }
+
+        // the home bucket of key
+        size_type bucket(const key_type& key) const
+        {
+            TINYSTL_DEBUG(bucket_size_ != 0);
+            return home(hash_(key));
+        }
+
+        // hash policy
+        float load_factor() const noexcept
+        { return bucket_size_ != 0 ? (float)size_ / bucket_size_ : 0.0f; }
+
+        float max_load_factor() const noexcept
+        { return mlf_; }
+
+        // an open addressing table must keep empty buckets, ml is in (0, 0.99]
+        void max_load_factor(float ml)
+        {
+            THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0.0f || ml > 0.99f, "invalid hash load factor");
+            mlf_ = ml;
+            rehash_if_need(0);
+        }
+
+        // make room for at least count buckets, and for size() elements under max_load_factor()
+        void rehash(size_type count);
+
+        void reserve(size_type count)
+        { rehash(static_cast<size_type>((float)count / max_load_factor()) + 1); }
+
+        // probe statistics
+        // the probe length of key (0 if it is not in the table)
+        size_type probe_length(const key_type& key) const
+        {
+            auto b = find_bucket(key);
+            return b ? static_cast<size_type>(b->dist) + 1 : 0;
+        }
+
+        rh_probe_stats probe_stats() const noexcept;
+
+        hasher    hash_fcn() const { return hash_; }
+        key_equal key_eq()   const { return equal_; }
+
+    private:
+        // helper functions
+        size_type home(size_t h) const noexcept
+        {
+            // Fibonacci hashing, the top log2(bucket_size_) bits of h * 2^64 / phi
+            return shift_ >= 64 ? 0 :
+                static_cast<size_type>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> shift_);
+        }
+
+        size_type next(size_type i) const noexcept { return (i + 1) & (bucket_size_ - 1); }
+        size_type prev(size_type i) const noexcept { return (i - 1) & (bucket_size_ - 1); }
+
+        bucket_type* first_bucket() const noexcept
+        {
+            bucket_type* b = buckets_;
+            bucket_type* last = buckets_ + bucket_size_;
+            while (b != last && b->empty())
+                ++b;
+            return b;
+        }
+
+        bucket_type* find_bucket(const key_type& key) const;
+
+        template <class Ty>
+        pair<iterator, bool> insert_aux(const key_type& key, Ty&& value);
+
+        template <class Ty>
+        bucket_type* insert_new(Ty&& value);
+
+        template <class ...Args>
+        bucket_type* insert_at(size_type i, int dist, Args&& ...args);
+
+        void move_bucket(size_type from, size_type to, int dist) noexcept;
+        void rehash_if_need(size_type n);
+        void replace_bucket(size_type bucket_count);
+    };
+
+    //========implement====================================================================
+
+    // Find the bucket of key, nullptr if there is none
+    template <class T, class Hash, class KeyEqual>
+    typename rh_hashtable<T, Hash, KeyEqual>::bucket_type*
+    rh_hashtable<T, Hash, KeyEqual>::find_bucket(const key_type& key) const
+    {
+        if (size_ == 0)
+            return nullptr;
+        size_type i = home(hash_(key));
+        int d = 0;
+        // the elements further from their homes than key would be belong to earlier homes,
+        // they are passed over without comparing keys
+        while (buckets_[i].dist > d)
+        {
+            i = next(i);
+            ++d;
+        }
+        // then the run of elements from the same home as key;
+        // an empty bucket or an element closer to its home ends it, key would have taken that bucket
+        for (; buckets_[i].dist == d; i = next(i), ++d)
+        {
+            if (equal_(value_traits::get_key(*buckets_[i].value_ptr()), key))
+                return buckets_ + i;
+        }
+        return nullptr;
+    }
+
+    // Construct the value first to learn its key, then insert it by move
+    template <class T, class Hash, class KeyEqual>
+    template <class ...Args>
+    pair<typename rh_hashtable<T, Hash, KeyEqual>::iterator, bool>
+    rh_hashtable<T, Hash, KeyEqual>::emplace_unique(Args&& ...args)
+    {
+        value_type tmp(tinystl::forward<Args>(args)...);
+        return insert_aux(value_traits::get_key(tmp), tinystl::move(tmp));
+    }
+
+    // Insert value unless key is in the table
+    template <class T, class Hash, class KeyEqual>
+    template <class Ty>
+    pair<typename rh_hashtable<T, Hash, KeyEqual>::iterator, bool>
+    rh_hashtable<T, Hash, KeyEqual>::insert_aux(const key_type& key, Ty&& value)
+    {
+        auto b = find_bucket(key);
+        if (b != nullptr)
+            return tinystl::make_pair(iterator(b, buckets_ + bucket_size_), false);
+        rehash_if_need(1);
+        b = insert_new(tinystl::forward<Ty>(value));
+        return tinystl::make_pair(iterator(b, buckets_ + bucket_size_), true);
+    }
+
+    // Insert a value whose key is not in the table, there is room for it
+    template <class T, class Hash, class KeyEqual>
+    template <class Ty>
+    typename rh_hashtable<T, Hash, KeyEqual>::bucket_type*
+    rh_hashtable<T, Hash, KeyEqual>::insert_new(Ty&& value)
+    {
+        size_type i = home(hash_(value_traits::get_key(value)));
+        int d = 0;
+        // go on while the elements are at least as far from their homes as the new one would be
+        while (buckets_[i].dist >= d)
+        {
+            i = next(i);
+            ++d;
+        }
+        return insert_at(i, d, tinystl::forward<Ty>(value));
+    }
+
+    // Put a new element with distance dist at bucket i:
+    // the run of elements from i to the first empty bucket moves one bucket forward
+    template <class T, class Hash, class KeyEqual>
+    template <class ...Args>
+    typename rh_hashtable<T, Hash, KeyEqual>::bucket_type*
+    rh_hashtable<T, Hash, KeyEqual>::insert_at(size_type i, int dist, Args&& ...args)
+    {
+        size_type j = i;
+        while (!buckets_[j].empty())
+            j = next(j);
+        for (size_type k = j; k != i; k = prev(k))
+            move_bucket(prev(k), k, buckets_[prev(k)].dist + 1);
+        try
+        {
+            tinystl::construct(buckets_[i].value_ptr(), tinystl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            // move the run back
+            for (size_type k = i; k != j; k = next(k))
+                move_bucket(next(k), k, buckets_[next(k)].dist - 1);
+            throw;
+        }
+        buckets_[i].dist = dist;
+        ++size_;
+        return buckets_ + i;
+    }
+
+    // Move the element of bucket from to the empty bucket to, with distance dist
+    template <class T, class Hash, class KeyEqual>
+    void rh_hashtable<T, Hash, KeyEqual>::
+    move_bucket(size_type from, size_type to, int dist) noexcept
+    {
+        TINYSTL_DEBUG(buckets_[to].empty() && !buckets_[from].empty());
+        tinystl::construct(buckets_[to].value_ptr(), tinystl::move(*buckets_[from].value_ptr()));
+        buckets_[to].dist = dist;
+        tinystl::destroy(buckets_[from].value_ptr());
+        buckets_[from].dist = -1;
+    }
+
+    // Erase the element at position, then shift the following elements back
+    // until an empty bucket or an element that is at its home
+    template <class T, class Hash, class KeyEqual>
+    typename rh_hashtable<T, Hash, KeyEqual>::iterator
+    rh_hashtable<T, Hash, KeyEqual>::erase(const_iterator position)
+    {
+        TINYSTL_DEBUG(position.cur != buckets_ + bucket_size_);
+        const size_type i = static_cast<size_type>(position.cur - buckets_);
+        tinystl::destroy(buckets_[i].value_ptr());
+        buckets_[i].dist = -1;
+        --size_;
+        for (size_type k = next(i); buckets_[k].dist > 0; k = next(k))
+            move_bucket(k, prev(k), buckets_[k].dist - 1);
+
+        // the next element is the one that moved into bucket i, unless it came round
+        // from bucket 0, which an iteration from begin() has already passed
+        iterator it(buckets_ + i, buckets_ + bucket_size_);
+        if (i + 1 == bucket_size_ || buckets_[i].empty())
+            ++it;
+        return it;
+    }
+
+    // Erase the element whose key is key
+    template <class T, class Hash, class KeyEqual>
+    typename rh_hashtable<T, Hash, KeyEqual>::size_type
+    rh_hashtable<T, Hash, KeyEqual>::erase_unique(const key_type& key)
+    {
+        auto b = find_bucket(key);
+        if (b == nullptr)
+            return 0;
+        erase(const_iterator(b, buckets_ + bucket_size_));
+        return 1;
+    }
+
+    // Start after an empty bucket: a backward shift never moves an element across it,
+    // so one lap visits every element once (an erased bucket is looked at again)
+    template <class T, class Hash, class KeyEqual>
+    template <class UnaryPredicate>
+    typename rh_hashtable<T, Hash, KeyEqual>::size_type
+    rh_hashtable<T, Hash, KeyEqual>::erase_if(UnaryPredicate pred)
+    {
+        if (size_ == 0)
+            return 0;
+        size_type start = 0;
+        while (!buckets_[start].empty())
+            ++start;
+        const size_type old_size = size_;
+        size_type i = next(start);
+        while (i != start)
+        {
+            if (!buckets_[i].empty() && pred(*buckets_[i].value_ptr()))
+                erase(const_iterator(buckets_ + i, buckets_ + bucket_size_));
+            else
+                i = next(i);
+        }
+        return old_size - size_;
+    }
+
+    // Destroy every element, the buckets are kept
+    template <class T, class Hash, class KeyEqual>
+    void rh_hashtable<T, Hash, KeyEqual>::clear() noexcept
+    {
+        if (size_ == 0)
+            return;
+        for (size_type i = 0; i < bucket_size_; ++i)
+        {
+            if (!buckets_[i].empty())
+            {
+                tinystl::destroy(buckets_[i].value_ptr());
+                buckets_[i].dist = -1;
+            }
+        }
+        size_ = 0;
+    }
+
+    template <class T, class Hash, class KeyEqual>
+    void rh_hashtable<T, Hash, KeyEqual>::swap(rh_hashtable& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            tinystl::swap(buckets_, rhs.buckets_);
+            tinystl::swap(bucket_size_, rhs.bucket_size_);
+            tinystl::swap(shift_, rhs.shift_);
+            tinystl::swap(size_, rhs.size_);
+            tinystl::swap(mlf_, rhs.mlf_);
+            tinystl::swap(hash_, rhs.hash_);
+            tinystl::swap(equal_, rhs.equal_);
+        }
+    }
+
+    // probe_stats
+    template <class T, class Hash, class KeyEqual>
+    rh_probe_stats rh_hashtable<T, Hash, KeyEqual>::probe_stats() const noexcept
+    {
+        rh_probe_stats s = { size_, 0, 0.0 };
+        size_type total = 0;
+        for (size_type i = 0; i < bucket_size_; ++i)
+        {
+            if (!buckets_[i].empty())
+            {
+                const size_type len = static_cast<size_type>(buckets_[i].dist) + 1;
+                total += len;
+                s.max = tinystl::max(s.max, len);
+            }
+        }
+        s.mean = size_ == 0 ? 0.0 : (double)total / (double)size_;
+        return s;
+    }
+
+    // The bucket count becomes the smallest power of two that is at least count
+    // and keeps size() under max_load_factor(); it only changes when that differs
+    template <class T, class Hash, class KeyEqual>
+    void rh_hashtable<T, Hash, KeyEqual>::rehash(size_type count)
+    {
+        const size_type need = static_cast<size_type>((float)size_ / max_load_factor()) + 1;
+        if (count < need)
+            count = need;
+        size_type n = 8;
+        while (n < count)
+            n <<= 1;
+        if (n != bucket_size_)
+            replace_bucket(n);
+    }
+
+    template <class T, class Hash, class KeyEqual>
+    void rh_hashtable<T, Hash, KeyEqual>::rehash_if_need(size_type n)
+    {
+        if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
+            rehash(bucket_size_ * 2);
+    }
+
+    // Move every element to a new bucket array of bucket_count buckets
+    template <class T, class Hash, class KeyEqual>
+    void rh_hashtable<T, Hash, KeyEqual>::replace_bucket(size_type bucket_count)
+    {
+        bucket_type* old = buckets_;
+        const size_type old_size = bucket_size_;
+
+        buckets_ = bucket_allocator::allocate(bucket_count);
+        for (size_type i = 0; i < bucket_count; ++i)
+            buckets_[i].dist = -1;
+        bucket_size_ = bucket_count;
+        shift_ = 64;
+        for (size_type n = bucket_count; n > 1; n >>= 1)
+            --shift_;
+        size_ = 0;
+
+        for (size_type i = 0; i < old_size; ++i)
+        {
+            if (!old[i].empty())
+            {
+                insert_new(tinystl::move(*old[i].value_ptr()));
+                tinystl::destroy(old[i].value_ptr());
+            }
+        }
+        bucket_allocator::deallocate(old, old_size);
+    }
+
+    // overload tinystl's swap
+    template <class T, class Hash, class KeyEqual>
+    void swap(rh_hashtable<T, Hash, KeyEqual>& lhs, rh_hashtable<T, Hash, KeyEqual>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace tinystl
+#endif // !_RH_HASHTABLE_H_
@@ -25,7 +25,10 @@ namespace tinystl
     // set
     // first parameter: key type
     // second parameter: key comparison, default: tinystl::less 
-    template <class Key, class Compare = tinystl::less<Key>>
+    // third parameter: augmentation of the rb_tree, default: none
+    //   (rb_tree_size_augment adds find_by_order / order_of_key / rank in O(log n))
+    template <class Key, class Compare = tinystl::less<Key>,
+              class Augment = rb_tree_no_augment>
     class set
     {
     public:
@@ -36,7 +39,7 @@ namespace tinystl
 
     private:
         // tinystl::rb_tree
-        typedef tinystl::rb_tree<value_type, key_compare>  base_type;
+        typedef tinystl::rb_tree<value_type, key_compare, Augment>  base_type;
         base_type tree_;
 
     public:
@@ -228,6 +231,47 @@ namespace tinystl
         pair<const_iterator, const_iterator> equal_range(const key_type& key) const
         { return tree_.equal_range_unique(key); }
 
+        // *result++ = lower_bound(key) for every key in [first, last), see rb_tree
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return tree_.lower_bound_batch(first, last, result); }
+
+        // join / split, see rb_tree.h---------------------------------------------------
+        // move every element of right to the end (its keys must not be less than ours)
+        void join(set& right)
+        { tree_.join(right.tree_); }
+
+        // move the elements whose key is not less than key to right
+        void split(const key_type& key, set& right)
+        { tree_.split(key, right.tree_); }
+
+        // set operations in O(m log(n / m + 1)), the nodes of other are moved or destroyed
+        // and other becomes empty, on equal keys our element is kept
+        void union_with(set& other, bool parallel = false)
+        { tree_.union_with(other.tree_, parallel); }
+
+        void intersect_with(set& other, bool parallel = false)
+        { tree_.intersect_with(other.tree_, parallel); }
+
+        void difference_with(set& other, bool parallel = false)
+        { tree_.difference_with(other.tree_, parallel); }
+
+        // order statistic, only with Augment = rb_tree_size_augment----------------------
+        iterator find_by_order(size_type k)
+        { return tree_.find_by_order(k); }
+
+        const_iterator find_by_order(size_type k) const
+        { return tree_.find_by_order(k); }
+
+        size_type order_of_key(const key_type& key) const
+        { return tree_.order_of_key(key); }
+
+        size_type rank(const_iterator it) const
+        { return tree_.rank(it); }
+
+        difference_type distance(const_iterator first, const_iterator last) const
+        { return tree_.distance(first, last); }
+
         void swap(set& rhs) noexcept
         { tree_.swap(rhs.tree_); }
 
@@ -240,45 +284,45 @@ namespace tinystl
     };
 
     // overload comparison operations
-    template <class Key, class Compare>
-    bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator==(const set<Key, Compare, Augment>& lhs, const set<Key, Compare, Augment>& rhs)
     {
         return lhs == rhs;
     }
 
-    template <class Key, class Compare>
-    bool operator<(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator<(const set<Key, Compare, Augment>& lhs, const set<Key, Compare, Augment>& rhs)
     {
         return lhs < rhs;
     }
 
-    template <class Key, class Compare>
-    bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator!=(const set<Key, Compare, Augment>& lhs, const set<Key, Compare, Augment>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class Key, class Compare>
-    bool operator>(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator>(const set<Key, Compare, Augment>& lhs, const set<Key, Compare, Augment>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class Key, class Compare>
-    bool operator<=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator<=(const set<Key, Compare, Augment>& lhs, const set<Key, Compare, Augment>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class Key, class Compare>
-    bool operator>=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator>=(const set<Key, Compare, Augment>& lhs, const set<Key, Compare, Augment>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // swap
-    template <class Key, class Compare>
-    void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept
+    template <class Key, class Compare, class Augment>
+    void swap(set<Key, Compare, Augment>& lhs, set<Key, Compare, Augment>& rhs) noexcept
     {
     lhs.swap(rhs);
     }
@@ -287,7 +331,10 @@ namespace tinystl
     // multiset
     // first parameter: key type
     // second parameter: key comparison, default: tinystl::less
-    template <class Key, class Compare = tinystl::less<Key>>
+    // third parameter: augmentation of the rb_tree, default: none
+    //   (rb_tree_size_augment adds find_by_order / order_of_key / rank in O(log n))
+    template <class Key, class Compare = tinystl::less<Key>,
+              class Augment = rb_tree_no_augment>
     class multiset
     {
     public:
@@ -298,7 +345,7 @@ namespace tinystl
 
     private:
         // rb_tree
-        typedef tinystl::rb_tree<value_type, key_compare>  base_type;
+        typedef tinystl::rb_tree<value_type, key_compare, Augment>  base_type;
         base_type tree_; 
 
     public:
@@ -489,6 +536,36 @@ namespace tinystl
         pair<const_iterator, const_iterator> equal_range(const key_type& key) const
         { return tree_.equal_range_multi(key); }
 
+        // *result++ = lower_bound(key) for every key in [first, last), see rb_tree
+        template <class ForwardIter, class OutputIter>
+        OutputIter lower_bound_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return tree_.lower_bound_batch(first, last, result); }
+
+        // join / split, see rb_tree.h---------------------------------------------------
+        // move every element of right to the end (its keys must not be less than ours)
+        void join(multiset& right)
+        { tree_.join(right.tree_); }
+
+        // move the elements whose key is not less than key to right
+        void split(const key_type& key, multiset& right)
+        { tree_.split(key, right.tree_); }
+
+        // order statistic, only with Augment = rb_tree_size_augment----------------------
+        iterator find_by_order(size_type k)
+        { return tree_.find_by_order(k); }
+
+        const_iterator find_by_order(size_type k) const
+        { return tree_.find_by_order(k); }
+
+        size_type order_of_key(const key_type& key) const
+        { return tree_.order_of_key(key); }
+
+        size_type rank(const_iterator it) const
+        { return tree_.rank(it); }
+
+        difference_type distance(const_iterator first, const_iterator last) const
+        { return tree_.distance(first, last); }
+
         void swap(multiset& rhs) noexcept
         { tree_.swap(rhs.tree_); }
 
@@ -501,45 +578,45 @@ namespace tinystl
     };
 
     // overload comparison operations
-    template <class Key, class Compare>
-    bool operator==(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator==(const multiset<Key, Compare, Augment>& lhs, const multiset<Key, Compare, Augment>& rhs)
     {
         return lhs == rhs;
     }
 
-    template <class Key, class Compare>
-    bool operator<(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator<(const multiset<Key, Compare, Augment>& lhs, const multiset<Key, Compare, Augment>& rhs)
     {
         return lhs < rhs;
     }
 
-    template <class Key, class Compare>
-    bool operator!=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator!=(const multiset<Key, Compare, Augment>& lhs, const multiset<Key, Compare, Augment>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class Key, class Compare>
-    bool operator>(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator>(const multiset<Key, Compare, Augment>& lhs, const multiset<Key, Compare, Augment>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class Key, class Compare>
-    bool operator<=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator<=(const multiset<Key, Compare, Augment>& lhs, const multiset<Key, Compare, Augment>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class Key, class Compare>
-    bool operator>=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+    template <class Key, class Compare, class Augment>
+    bool operator>=(const multiset<Key, Compare, Augment>& lhs, const multiset<Key, Compare, Augment>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // swap
-    template <class Key, class Compare>
-    void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept
+    template <class Key, class Compare, class Augment>
+    void swap(multiset<Key, Compare, Augment>& lhs, multiset<Key, Compare, Augment>& rhs) noexcept
     {
         lhs.swap(rhs);
     }
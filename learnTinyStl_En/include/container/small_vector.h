@@ -0,0 +1,1022 @@
+#ifndef _SMALL_VECTOR_H_
+#define _SMALL_VECTOR_H_
+
+// small_vector
+// A vector which keeps up to N elements in a buffer inside the object itself,
+// the elements spill to the heap only when the size grows beyond N.
+// Most short-lived vectors hold only a few elements,
+// then push_back never touches the allocator.
+
+// notes:
+// A throwing element constructor destroys what was built and the exception reaches the caller.
+// Differences with vector:
+//   * the capacity starts from N instead of 16, then grows by vector_next_cap
+//   * moving or swapping a small_vector which is still inline moves the elements one by one,
+//     so the iterators of an inline small_vector are invalidated by swap / move
+//   * shrink_to_fit moves the elements back inline when size() <= N
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+#include "allocator.h"
+#include "vector.h"
+
+namespace tinystl
+{
+
+    // small_vector template
+    template <class T, size_t N>
+    class small_vector
+    {
+        static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in tinystl");
+        static_assert(N > 0, "small_vector<T, 0> has no inline buffer, use vector<T>");
+    public:
+        // the nested types are the same as vector
+        typedef tinystl::allocator<T>   allocator_type;
+        typedef tinystl::allocator<T>   data_allocator;
+
+        typedef typename allocator_type::value_type         value_type;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+        typedef value_type*                                 iterator;
+        typedef const value_type*                           const_iterator;
+        typedef tinystl::reverse_iterator<iterator>         reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+        allocator_type get_allocator() { return data_allocator(); }
+
+    private:
+        iterator begin_;  // Indicates the head of the currently used space
+        iterator end_;    // Indicates the end of the currently used space
+        iterator cap_;    // Indicates the end of the current storage space
+
+        // inline buffer, raw memory for N elements
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+
+    public:
+        // constructor----------------------------------------------------------------------
+        // no allocation until the size grows beyond N
+        small_vector() noexcept
+        { inline_init(); }
+
+        explicit small_vector(size_type n)
+        { fill_init(n, value_type()); }
+
+        small_vector(size_type n, const value_type& value)
+        { fill_init(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        small_vector(Iter first, Iter last)
+        {
+            TINYSTL_DEBUG(!(last < first));
+            range_init(first, last);
+        }
+
+        // copy construct
+        small_vector(const small_vector& rhs)
+        {
+            range_init(rhs.begin_, rhs.end_);
+        }
+
+        // Move Constructor
+        // steal the heap buffer, or move the inline elements one by one
+        small_vector(small_vector&& rhs)
+            noexcept(std::is_nothrow_move_constructible<value_type>::value)
+        {
+            inline_init();
+            move_from(rhs);
+        }
+
+        small_vector(std::initializer_list<value_type> ilist)
+        {
+            range_init(ilist.begin(), ilist.end());
+        }
+
+        small_vector& operator=(const small_vector& rhs)
+        {
+            if (this != &rhs)
+                copy_assign(rhs.begin_, rhs.end_, tinystl::forward_iterator_tag{});
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& rhs)
+            noexcept(std::is_nothrow_move_constructible<value_type>::value)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                move_from(rhs);
+            }
+            return *this;
+        }
+
+        small_vector& operator=(std::initializer_list<value_type> ilist)
+        {
+            copy_assign(ilist.begin(), ilist.end(), tinystl::forward_iterator_tag{});
+            return *this;
+        }
+
+        // deconstructor
+        ~small_vector()
+        {
+            data_allocator::destroy(begin_, end_);
+            release_storage();
+        }
+
+    public:
+        // operation on iterator------------------------------------------------------------
+        iterator begin() noexcept
+        { return begin_; }
+
+        const_iterator begin() const noexcept
+        { return begin_; }
+
+        iterator end() noexcept
+        { return end_; }
+
+        const_iterator end() const noexcept
+        { return end_; }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin()  const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // parameters-----------------------------------------------------------------------
+        bool empty() const noexcept
+        { return begin_ == end_; }
+
+        size_type size() const noexcept
+        { return static_cast<size_type>(end_ - begin_); }
+
+        size_type max_size() const noexcept
+        { return static_cast<size_type>(-1) / sizeof(T); }
+
+        size_type capacity() const noexcept
+        { return static_cast<size_type>(cap_ - begin_); }
+
+        // whether the elements are still in the inline buffer
+        bool is_inline() const noexcept
+        { return begin_ == inline_begin(); }
+
+        static constexpr size_type inline_capacity() noexcept
+        { return N; }
+
+        void reserve(size_type n);
+        void shrink_to_fit();
+
+        // Access element operations
+        reference operator[](size_type n)
+        {
+            TINYSTL_DEBUG(n < size());
+            return *(begin_ + n);
+        }
+
+        const_reference operator[](size_type n) const
+        {
+            TINYSTL_DEBUG(n < size());
+            return *(begin_ + n);
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin_;
+        }
+
+        const_reference front() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin_;
+        }
+
+        reference back()
+        {
+            TINYSTL_DEBUG(!empty());
+            return *(end_ - 1);
+        }
+
+        const_reference back() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return *(end_ - 1);
+        }
+
+        pointer data() noexcept
+        { return begin_; }
+
+        const_pointer data() const noexcept
+        { return begin_; }
+
+        // Modify container-----------------------------------------------------------------
+        // assign
+        void assign(size_type n, const value_type& value)
+        { fill_assign(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        {
+            TINYSTL_DEBUG(!(last < first));
+            copy_assign(first, last, iterator_category(first));
+        }
+
+        void assign(std::initializer_list<value_type> il)
+        { copy_assign(il.begin(), il.end(), tinystl::forward_iterator_tag{}); }
+
+        // emplace / emplace_back
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&& ...args);
+
+        template <class... Args>
+        void emplace_back(Args&& ...args);
+
+        // push_back / pop_back
+        void push_back(const value_type& value);
+
+        void push_back(value_type&& value)
+        { emplace_back(tinystl::move(value)); }
+
+        void pop_back();
+
+        // insert
+        iterator insert(const_iterator pos, const value_type& value);
+
+        iterator insert(const_iterator pos, value_type&& value)
+        { return emplace(pos, tinystl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const value_type& value)
+        {
+            TINYSTL_DEBUG(pos >= begin() && pos <= end());
+            return fill_insert(const_cast<iterator>(pos), n, value);
+        }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void insert(const_iterator pos, Iter first, Iter last)
+        {
+            TINYSTL_DEBUG(pos >= begin() && pos <= end() && !(last < first));
+            copy_insert(const_cast<iterator>(pos), first, last);
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() { erase(begin(), end()); }
+
+        // resize / reverse
+        void resize(size_type new_size)
+        { return resize(new_size, value_type()); }
+
+        void resize(size_type new_size, const value_type& value);
+
+        void reverse()
+        { tinystl::reverse(begin(), end()); }
+
+        // swap
+        void swap(small_vector& rhs)
+            noexcept(std::is_nothrow_move_constructible<value_type>::value);
+
+    private:
+        // helper functions
+        // inline buffer ---------------------------------------------------------------------
+        pointer inline_begin() noexcept
+        { return reinterpret_cast<pointer>(&buf_); }
+
+        const_pointer inline_begin() const noexcept
+        { return reinterpret_cast<const_pointer>(&buf_); }
+
+        void inline_init() noexcept;
+
+        // give the heap buffer back, nothing to do for the inline buffer
+        void release_storage() noexcept;
+
+        // take over [new_begin, new_end) with capacity new_cap, release the old storage
+        void replace_storage(iterator new_begin, iterator new_end, size_type new_cap) noexcept;
+
+        void move_from(small_vector& rhs);
+
+        // tinystl::uninitialized_copy / uninitialized_fill_n stop at a throwing constructor
+        // and return the partial end, these destroy what they built and rethrow instead
+        template <class Iter>
+        static iterator uninit_copy(Iter first, Iter last, iterator result);
+
+        static iterator uninit_fill_n(iterator result, size_type n, const value_type& value);
+
+        // construct / copy / move / deconstruct / ----------------------------------------
+        void init_space(size_type size, size_type cap);
+
+        void fill_init(size_type n, const value_type& value);
+
+        template <class Iter>
+        void range_init(Iter first, Iter last);
+
+        void destroy_and_recover(iterator first, iterator last, size_type n);
+
+        // helper functions Modify container------------------------------------------------
+        // calculate the growth size
+        size_type get_new_cap(size_type add_size);
+
+        // assign
+        void fill_assign(size_type n, const value_type& value);
+
+        template <class IIter>
+        void copy_assign(IIter first, IIter last, input_iterator_tag);
+
+        template <class FIter>
+        void copy_assign(FIter first, FIter last, forward_iterator_tag);
+
+        // reallocate
+        template <class... Args>
+        void reallocate_emplace(iterator pos, Args&& ...args);
+
+        void reallocate_insert(iterator pos, const value_type& value);
+
+        // insert
+        iterator fill_insert(iterator pos, size_type n, const value_type& value);
+
+        template <class IIter>
+        void copy_insert(iterator pos, IIter first, IIter last);
+
+        // shrink_to_fit
+        void reinsert(size_type size);
+    };
+
+    //==================implement=========================================================//
+
+    // inline buffer -------------------------------------------------------------------------
+    template <class T, size_t N>
+    void small_vector<T, N>::inline_init() noexcept
+    {
+        begin_ = inline_begin();
+        end_   = begin_;
+        cap_   = begin_ + N;
+    }
+
+    template <class T, size_t N>
+    void small_vector<T, N>::release_storage() noexcept
+    {
+        if (!is_inline())
+            data_allocator::deallocate(begin_, cap_ - begin_);
+    }
+
+    // the old elements must have been moved out or destroyed
+    template <class T, size_t N>
+    void small_vector<T, N>::replace_storage(iterator new_begin, iterator new_end,
+                                             size_type new_cap) noexcept
+    {
+        release_storage();
+        begin_ = new_begin;
+        end_   = new_end;
+        cap_   = new_begin + new_cap;
+    }
+
+    // *this is empty; leave rhs empty and inline
+    template <class T, size_t N>
+    void small_vector<T, N>::move_from(small_vector& rhs)
+    {
+        if (rhs.is_inline())
+        {
+            // rhs.size() <= N <= capacity(), no reallocation
+            end_ = tinystl::uninitialized_move_n(rhs.begin_, rhs.size(), begin_);
+            rhs.clear();
+        }
+        else
+        {
+            release_storage();
+            begin_ = rhs.begin_;
+            end_   = rhs.end_;
+            cap_   = rhs.cap_;
+            rhs.inline_init();
+        }
+    }
+
+    template <class T, size_t N>
+    template <class Iter>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::uninit_copy(Iter first, Iter last, iterator result)
+    {
+        auto cur = result;
+        try
+        {
+            for (; first != last; ++first, ++cur)
+                data_allocator::construct(tinystl::address_of(*cur), *first);
+        }
+        catch (...)
+        {
+            data_allocator::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template <class T, size_t N>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::uninit_fill_n(iterator result, size_type n, const value_type& value)
+    {
+        auto cur = result;
+        try
+        {
+            for (; n > 0; --n, ++cur)
+                data_allocator::construct(tinystl::address_of(*cur), value);
+        }
+        catch (...)
+        {
+            data_allocator::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    // construct / copy / move / deconstruct / ---------------------------------------------
+    // init_space
+    template <class T, size_t N>
+    void small_vector<T, N>::init_space(size_type size, size_type cap)
+    {
+        if (cap <= N)
+        {
+            inline_init();
+            end_ = begin_ + size;
+            return;
+        }
+        try
+        {
+            begin_ = data_allocator::allocate(cap);
+            end_   = begin_ + size;
+            cap_   = begin_ + cap;
+        }
+        catch (...)
+        {
+            inline_init();
+            throw;
+        }
+    }
+
+    // fill_init
+    template <class T, size_t N>
+    void small_vector<T, N>::fill_init(size_type n, const value_type& value)
+    {
+        init_space(n, tinystl::max(static_cast<size_type>(N), n));
+        try
+        {
+            uninit_fill_n(begin_, n, value);
+        }
+        catch (...)
+        {
+            release_storage();
+            throw;
+        }
+    }
+
+    // range_init
+    template <class T, size_t N>
+    template <class Iter>
+    void small_vector<T, N>::range_init(Iter first, Iter last)
+    {
+        const size_type n = tinystl::distance(first, last);
+        init_space(n, tinystl::max(static_cast<size_type>(N), n));
+        try
+        {
+            uninit_copy(first, last, begin_);
+        }
+        catch (...)
+        {
+            release_storage();
+            throw;
+        }
+    }
+
+    // destroy_and_recover, only used for the new heap buffer of a reallocation
+    template <class T, size_t N>
+    void small_vector<T, N>::destroy_and_recover(iterator first, iterator last, size_type n)
+    {
+        data_allocator::destroy(first, last);
+        data_allocator::deallocate(first, n);
+    }
+
+    // exchange with another small_vector
+    // if both are on the heap, only the pointers are swapped
+    template <class T, size_t N>
+    void small_vector<T, N>::swap(small_vector& rhs)
+        noexcept(std::is_nothrow_move_constructible<value_type>::value)
+    {
+        if (this == &rhs)
+            return;
+        if (!is_inline() && !rhs.is_inline())
+        {
+            tinystl::swap(begin_, rhs.begin_);
+            tinystl::swap(end_, rhs.end_);
+            tinystl::swap(cap_, rhs.cap_);
+            return;
+        }
+        small_vector tmp(tinystl::move(rhs));
+        rhs = tinystl::move(*this);
+        *this = tinystl::move(tmp);
+    }
+
+    // when the original capacity is less than the required size, it will be reallocated
+    template <class T, size_t N>
+    void small_vector<T, N>::reserve(size_type n)
+    {
+        if (capacity() < n)
+        {
+            THROW_LENGTH_ERROR_IF(n > max_size(),
+                "n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+
+            const auto old_size = size();
+            auto tmp = data_allocator::allocate(n);
+            try
+            {
+                tinystl::uninitialized_move_n(begin_, old_size, tmp);
+            }
+            catch (...)
+            {
+                data_allocator::deallocate(tmp, n);
+                throw;
+            }
+            data_allocator::destroy(begin_, end_);
+            replace_storage(tmp, tmp + old_size, n);
+        }
+    }
+
+    // give up excess capacity, go back to the inline buffer if the elements fit in
+    template <class T, size_t N>
+    void small_vector<T, N>::shrink_to_fit()
+    {
+        if (is_inline())
+            return;
+        if (size() <= N)
+        {
+            auto new_end = tinystl::uninitialized_move_n(begin_, size(), inline_begin());
+            data_allocator::destroy(begin_, end_);
+            replace_storage(inline_begin(), new_end, N);
+        }
+        else if (end_ < cap_)
+        {
+            reinsert(size());
+        }
+    }
+
+    // modify container---------------------------------------------------------------------
+    // fill_assign
+    template <class T, size_t N>
+    void small_vector<T, N>::fill_assign(size_type n, const value_type& value)
+    {
+        if (n > capacity())
+        {
+            small_vector tmp(n, value);
+            swap(tmp);
+        }
+        else if (n > size())
+        {
+            tinystl::fill(begin(), end(), value);
+            end_ = uninit_fill_n(end_, n - size(), value);
+        }
+        else
+            erase(tinystl::fill_n(begin_, n, value), end_);
+    }
+
+    // copy_assign
+    template <class T, size_t N>
+    template <class IIter>
+    void small_vector<T, N>::copy_assign(IIter first, IIter last, input_iterator_tag)
+    {
+        auto cur = begin_;
+        for (; first != last && cur != end_; ++first, ++cur)
+        {
+            *cur = *first;
+        }
+
+        if (first == last)
+            erase(cur, end_);
+        else
+            insert(end_, first, last);
+    }
+
+    // assigenment by [first, last)
+    template <class T, size_t N>
+    template <class FIter>
+    void small_vector<T, N>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+    {
+        const size_type len = tinystl::distance(first, last);
+        if (len > capacity())
+        {
+            small_vector tmp(first, last);
+            swap(tmp);
+        }
+        else if (size() >= len)
+        {
+            auto new_end = tinystl::copy(first, last, begin_);
+            data_allocator::destroy(new_end, end_);
+            end_ = new_end;
+        }
+        else
+        {
+            auto mid = first;
+            tinystl::advance(mid, size());
+            tinystl::copy(first, mid, begin_);
+            end_ = uninit_copy(mid, last, end_);
+        }
+    }
+
+    // get_new_cap, the same growth rule as vector
+    template <class T, size_t N>
+    typename small_vector<T, N>::size_type
+    small_vector<T, N>::get_new_cap(size_type add_size)
+    {
+        return tinystl::vector_next_cap(capacity(), add_size, max_size());
+    }
+
+    // Reallocates space and constructs element in-place at pos
+    template <class T, size_t N>
+    template <class ...Args>
+    void small_vector<T, N>::reallocate_emplace(iterator pos, Args&& ...args)
+    {
+        const auto new_size = get_new_cap(1);
+        auto new_begin = data_allocator::allocate(new_size);
+        auto new_end = new_begin;
+        try
+        {
+            new_end = tinystl::uninitialized_move_n(begin_, pos - begin_, new_begin);
+            data_allocator::construct(tinystl::address_of(*new_end), tinystl::forward<Args>(args)...);
+            ++new_end;
+            new_end = tinystl::uninitialized_move_n(pos, end_ - pos, new_end);
+        }
+        catch (...)
+        {
+            destroy_and_recover(new_begin, new_end, new_size);
+            throw;
+        }
+        data_allocator::destroy(begin_, end_);
+        replace_storage(new_begin, new_end, new_size);
+    }
+
+    // Constructs the element in-place at position pos
+    template <class T, size_t N>
+    template <class ...Args>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+    {
+        TINYSTL_DEBUG(pos >= begin() && pos <= end());
+        iterator xpos = const_cast<iterator>(pos);
+        const size_type n = xpos - begin_;
+        if (end_ != cap_ && xpos == end_)
+        {
+            data_allocator::construct(tinystl::address_of(*end_), tinystl::forward<Args>(args)...);
+            ++end_;
+        }
+        else if (end_ != cap_)
+        {
+            // build the value before the new last slot, a throw must not leave it constructed
+            value_type tmp(tinystl::forward<Args>(args)...);
+            auto new_end = end_;
+            data_allocator::construct(tinystl::address_of(*end_), *(end_ - 1));
+            ++new_end;
+            tinystl::copy_backward(xpos, end_ - 1, end_);
+            *xpos = tinystl::move(tmp);
+            end_ = new_end;
+        }
+        else
+            reallocate_emplace(xpos, tinystl::forward<Args>(args)...);
+
+        return begin() + n;
+    }
+
+    // Constructs elements in-place at the end
+    template <class T, size_t N>
+    template <class ...Args>
+    void small_vector<T, N>::emplace_back(Args&& ...args)
+    {
+        if (end_ < cap_)
+        {
+            data_allocator::construct(tinystl::address_of(*end_), tinystl::forward<Args>(args)...);
+            ++end_;
+        }
+        else
+            reallocate_emplace(end_, tinystl::forward<Args>(args)...);
+    }
+
+    // insert element at the end
+    template <class T, size_t N>
+    void small_vector<T, N>::push_back(const value_type& value)
+    {
+        if (end_ != cap_)
+        {
+            data_allocator::construct(tinystl::address_of(*end_), value);
+            ++end_;
+        }
+        else
+            reallocate_insert(end_, value);
+    }
+
+    // pop end element
+    template <class T, size_t N>
+    void small_vector<T, N>::pop_back()
+    {
+        TINYSTL_DEBUG(!empty());
+        data_allocator::destroy(end_ - 1);
+        --end_;
+    }
+
+    // delete element at pos
+    template <class T, size_t N>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::erase(const_iterator pos)
+    {
+        TINYSTL_DEBUG(pos >= begin() && pos < end());
+        iterator xpos = begin_ + (pos - begin());
+        tinystl::move(xpos + 1, end_, xpos);
+        data_allocator::destroy(end_ - 1);
+        --end_;
+        return xpos;
+    }
+
+    // delete elements in [first, last)
+    template <class T, size_t N>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::erase(const_iterator first, const_iterator last)
+    {
+        TINYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        const auto n = first - begin();
+        iterator r = begin_ + (first - begin());
+        data_allocator::destroy(tinystl::move(r + (last - first), end_, r), end_);
+        end_ = end_ - (last - first);
+        return begin_ + n;
+    }
+
+    // resize
+    template <class T, size_t N>
+    void small_vector<T, N>::resize(size_type new_size, const value_type& value)
+    {
+        if (new_size < size())
+            erase(begin() + new_size, end());
+        else
+            insert(end(), new_size - size(), value);
+    }
+
+    // insert element at pos
+    template <class T, size_t N>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::insert(const_iterator pos, const value_type& value)
+    {
+        TINYSTL_DEBUG(pos >= begin() && pos <= end());
+        iterator xpos = const_cast<iterator>(pos);
+        const size_type n = pos - begin_;
+        if (end_ != cap_ && xpos == end_)
+        {
+            data_allocator::construct(tinystl::address_of(*end_), value);
+            ++end_;
+        }
+        else if (end_ != cap_)
+        {
+            // Prevent elements from being changed by the following copy operations,
+            // copy it before the new last slot is constructed
+            auto value_copy = value;
+            auto new_end = end_;
+            data_allocator::construct(tinystl::address_of(*end_), *(end_ - 1));
+            ++new_end;
+            tinystl::copy_backward(xpos, end_ - 1, end_);
+            *xpos = tinystl::move(value_copy);
+            end_ = new_end;
+        }
+        else
+            reallocate_insert(xpos, value);
+        return begin_ + n;
+    }
+
+    // reallocate space and insert element at pos
+    template <class T, size_t N>
+    void small_vector<T, N>::reallocate_insert(iterator pos, const value_type& value)
+    {
+        const auto new_size = get_new_cap(1);
+        auto new_begin = data_allocator::allocate(new_size);
+        auto new_end = new_begin;
+        const value_type& value_copy = value;
+        try
+        {
+            new_end = tinystl::uninitialized_move_n(begin_, pos - begin_, new_begin);
+            data_allocator::construct(tinystl::address_of(*new_end), value_copy);
+            ++new_end;
+            new_end = tinystl::uninitialized_move_n(pos, end_ - pos, new_end);
+        }
+        catch (...)
+        {
+            destroy_and_recover(new_begin, new_end, new_size);
+            throw;
+        }
+        data_allocator::destroy(begin_, end_);
+        replace_storage(new_begin, new_end, new_size);
+    }
+
+    // fill_insert
+    template <class T, size_t N>
+    typename small_vector<T, N>::iterator
+    small_vector<T, N>::fill_insert(iterator pos, size_type n, const value_type& value)
+    {
+        if (n == 0)
+            return pos;
+
+        const size_type xpos = pos - begin_;
+        const value_type value_copy = value;  // avoid being covered
+        if (static_cast<size_type>(cap_ - end_) >= n)
+        {
+            // If the spare space is greater than or equal to the added space
+            const size_type after_elems = end_ - pos;
+            auto old_end = end_;
+            if (after_elems > n)
+            {
+                end_ = tinystl::uninitialized_move_n(end_ - n, n, end_);
+                tinystl::move_backward(pos, old_end - n, old_end);
+                // [pos, pos + n) still holds moved-from elements, assign instead of construct
+                tinystl::fill_n(pos, n, value_copy);
+            }
+            else
+            {
+                end_ = uninit_fill_n(end_, n - after_elems, value_copy);
+                end_ = tinystl::uninitialized_move_n(pos, after_elems, end_);
+                tinystl::fill_n(pos, after_elems, value_copy);
+            }
+        }
+        else
+        {
+            // Insufficient spare space, spill to the heap
+            const auto new_size = get_new_cap(n);
+            auto new_begin = data_allocator::allocate(new_size);
+            auto new_end = new_begin;
+            try
+            {
+                new_end = tinystl::uninitialized_move_n(begin_, pos - begin_, new_begin);
+                new_end = uninit_fill_n(new_end, n, value_copy);
+                new_end = tinystl::uninitialized_move_n(pos, end_ - pos, new_end);
+            }
+            catch (...)
+            {
+                destroy_and_recover(new_begin, new_end, new_size);
+                throw;
+            }
+            data_allocator::destroy(begin_, end_);
+            replace_storage(new_begin, new_end, new_size);
+        }
+        return begin_ + xpos;
+    }
+
+    // copy_insert
+    template <class T, size_t N>
+    template <class IIter>
+    void small_vector<T, N>::copy_insert(iterator pos, IIter first, IIter last)
+    {
+        if (first == last)
+            return;
+        const auto n = tinystl::distance(first, last);
+        if ((cap_ - end_) >= n)
+        {
+            // If the spare space size is sufficient
+            const auto after_elems = end_ - pos;
+            auto old_end = end_;
+            if (after_elems > n)
+            {
+                end_ = tinystl::uninitialized_move_n(end_ - n, n, end_);
+                tinystl::move_backward(pos, old_end - n, old_end);
+                // [pos, pos + n) still holds moved-from elements, assign instead of construct
+                tinystl::copy(first, last, pos);
+            }
+            else
+            {
+                auto mid = first;
+                tinystl::advance(mid, after_elems);
+                end_ = uninit_copy(mid, last, end_);
+                end_ = tinystl::uninitialized_move_n(pos, after_elems, end_);
+                tinystl::copy(first, mid, pos);
+            }
+        }
+        else
+        {
+            // Insufficient spare space, spill to the heap
+            const auto new_size = get_new_cap(n);
+            auto new_begin = data_allocator::allocate(new_size);
+            auto new_end = new_begin;
+            try
+            {
+                new_end = tinystl::uninitialized_move_n(begin_, pos - begin_, new_begin);
+                new_end = uninit_copy(first, last, new_end);
+                new_end = tinystl::uninitialized_move_n(pos, end_ - pos, new_end);
+            }
+            catch (...)
+            {
+                destroy_and_recover(new_begin, new_end, new_size);
+                throw;
+            }
+            data_allocator::destroy(begin_, end_);
+            replace_storage(new_begin, new_end, new_size);
+        }
+    }
+
+    // reinsert, move the heap elements into a heap buffer of exactly size elements
+    template <class T, size_t N>
+    void small_vector<T, N>::reinsert(size_type size)
+    {
+        auto new_begin = data_allocator::allocate(size);
+        try
+        {
+            tinystl::uninitialized_move_n(begin_, size, new_begin);
+        }
+        catch (...)
+        {
+            data_allocator::deallocate(new_begin, size);
+            throw;
+        }
+        data_allocator::destroy(begin_, end_);
+        replace_storage(new_begin, new_begin + size, size);
+    }
+
+    // overload swap
+    template <class T, size_t N>
+    void swap(small_vector<T, N>& lhs, small_vector<T, N>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    // overload comparison operator
+    template <class T, size_t N>
+    bool operator==(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N>
+    bool operator<(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+    {
+        return tinystl::lexicographical_compare(lhs.begin(), lhs.end(),
+            rhs.begin(), rhs.end());
+    }
+
+    template <class T, size_t N>
+    bool operator!=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, size_t N>
+    bool operator<=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+} // namespace tinystl
+#endif
@@ -6,6 +6,7 @@
 // and modify the container's representation by changing the interface.
 
 // Both list and deque can be used as the underlying services of these two
+// (circular_buffer can be used too, it reuses one array instead of allocating blocks)
 // And neither of these provide iterators, so they cannot be traversed
 
 // The stack does not implement any functions by itself, 
@@ -0,0 +1,618 @@
+#ifndef _STATIC_VECTOR_H_
+#define _STATIC_VECTOR_H_
+
+// static_vector
+// A vector with a fixed capacity N, the elements live inside the object,
+// it never allocates memory. Growing beyond N throws std::length_error.
+
+// notes:
+// Exception guarantees:
+// tinystl::static_vector<T, N> Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace_back
+//   * push_back
+// An overflow is always detected before any element is touched.
+
+// When T is a trivial type, the elements are kept in a plain array T[N]
+// and static_vector is trivially destructible, then (since C++14) it can be built
+// inside a constexpr function with push_back / emplace_back / operator[] / size ...,
+// and (since C++17) returned from it:  constexpr auto table = make_table();
+// The array is value-initialized when the static_vector is constructed.
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+
+// constexpr member functions can modify the object only since C++14
+#if __cplusplus >= 201402L
+#define STATIC_VECTOR_CONSTEXPR constexpr
+#else
+#define STATIC_VECTOR_CONSTEXPR
+#endif
+
+namespace tinystl
+{
+
+    // static_vector_storage
+    // trivial T: a plain array, an element is "constructed" by assignment,
+    //            no placement new and no destructor call, so everything can be constexpr
+    template <class T, size_t N, bool = std::is_trivial<T>::value>
+    struct static_vector_storage
+    {
+        T      data_[N];
+        size_t size_;
+
+        constexpr static_vector_storage() noexcept :data_(), size_(0)
+        {}
+
+        STATIC_VECTOR_CONSTEXPR T* ptr() noexcept
+        { return data_; }
+
+        constexpr const T* ptr() const noexcept
+        { return data_; }
+
+        template <class... Args>
+        STATIC_VECTOR_CONSTEXPR void construct_at(T* p, Args&&... args)
+        { *p = T(tinystl::forward<Args>(args)...); }
+
+        STATIC_VECTOR_CONSTEXPR void destroy_range(T*, T*) noexcept
+        {}
+    };
+
+    // non trivial T: raw memory, construct by construct() and destroy by destroy()
+    template <class T, size_t N>
+    struct static_vector_storage<T, N, false>
+    {
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+        size_t size_;
+
+        static_vector_storage() noexcept :size_(0)
+        {}
+
+        // copy / move the elements one by one, the implicit ones would copy the raw bytes
+        static_vector_storage(const static_vector_storage& rhs) :size_(0)
+        {
+            try
+            {
+                copy_from(rhs);
+            }
+            catch (...)
+            {
+                destroy_range(ptr(), ptr() + size_);
+                throw;
+            }
+        }
+
+        // uninitialized_move_n destroys what it built and rethrows, size_ stays 0
+        static_vector_storage(static_vector_storage&& rhs)
+            noexcept(std::is_nothrow_move_constructible<T>::value) :size_(0)
+        {
+            tinystl::uninitialized_move_n(rhs.ptr(), rhs.size_, ptr());
+            size_ = rhs.size_;
+        }
+
+        static_vector_storage& operator=(const static_vector_storage& rhs)
+        {
+            if (this != &rhs)
+            {
+                destroy_range(ptr(), ptr() + size_);
+                size_ = 0;
+                copy_from(rhs);
+            }
+            return *this;
+        }
+
+        static_vector_storage& operator=(static_vector_storage&& rhs)
+            noexcept(std::is_nothrow_move_constructible<T>::value)
+        {
+            if (this != &rhs)
+            {
+                destroy_range(ptr(), ptr() + size_);
+                size_ = 0;
+                tinystl::uninitialized_move_n(rhs.ptr(), rhs.size_, ptr());
+                size_ = rhs.size_;
+            }
+            return *this;
+        }
+
+        ~static_vector_storage()
+        { destroy_range(ptr(), ptr() + size_); }
+
+        T* ptr() noexcept
+        { return reinterpret_cast<T*>(&buf_); }
+
+        const T* ptr() const noexcept
+        { return reinterpret_cast<const T*>(&buf_); }
+
+        template <class... Args>
+        void construct_at(T* p, Args&&... args)
+        { tinystl::construct(p, tinystl::forward<Args>(args)...); }
+
+        void destroy_range(T* first, T* last) noexcept
+        { tinystl::destroy(first, last); }
+
+        // *this is empty, size_ counts each copy once it is built
+        void copy_from(const static_vector_storage& rhs)
+        {
+            for (; size_ < rhs.size_; ++size_)
+                construct_at(ptr() + size_, rhs.ptr()[size_]);
+        }
+    };
+
+    // static_vector template
+    template <class T, size_t N>
+    class static_vector
+    {
+        static_assert(N > 0, "static_vector<T, 0> can hold nothing");
+    public:
+        // static_vector's nested type definitions
+        typedef T                                           value_type;
+        typedef T*                                          pointer;
+        typedef const T*                                    const_pointer;
+        typedef T&                                          reference;
+        typedef const T&                                    const_reference;
+        typedef size_t                                      size_type;
+        typedef ptrdiff_t                                   difference_type;
+
+        typedef value_type*                                 iterator;
+        typedef const value_type*                           const_iterator;
+        typedef tinystl::reverse_iterator<iterator>         reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+    private:
+        static_vector_storage<T, N> st_;
+
+    public:
+        // constructor----------------------------------------------------------------------
+        STATIC_VECTOR_CONSTEXPR static_vector() noexcept :st_()
+        {}
+
+        explicit static_vector(size_type n) :st_()
+        { fill_init(n, value_type()); }
+
+        static_vector(size_type n, const value_type& value) :st_()
+        { fill_init(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        static_vector(Iter first, Iter last) :st_()
+        {
+            range_init(first, last);
+        }
+
+        static_vector(std::initializer_list<value_type> ilist) :st_()
+        {
+            range_init(ilist.begin(), ilist.end());
+        }
+
+        // copy / move / deconstruct are done by static_vector_storage:
+        // trivial for trivial T (so they are constexpr),
+        // element by element otherwise. The elements can not be stolen,
+        // a moved-from static_vector keeps its size and holds moved-from elements
+        static_vector(const static_vector& rhs) = default;
+        static_vector(static_vector&& rhs) = default;
+
+        static_vector& operator=(const static_vector& rhs) = default;
+        static_vector& operator=(static_vector&& rhs) = default;
+
+        static_vector& operator=(std::initializer_list<value_type> ilist)
+        {
+            assign(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+    public:
+        // operation on iterator------------------------------------------------------------
+        STATIC_VECTOR_CONSTEXPR iterator begin() noexcept
+        { return st_.ptr(); }
+
+        constexpr const_iterator begin() const noexcept
+        { return st_.ptr(); }
+
+        STATIC_VECTOR_CONSTEXPR iterator end() noexcept
+        { return st_.ptr() + st_.size_; }
+
+        constexpr const_iterator end() const noexcept
+        { return st_.ptr() + st_.size_; }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin()  const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        constexpr const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        constexpr const_iterator cend() const noexcept
+        { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept
+        { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept
+        { return rend(); }
+
+        // parameters-----------------------------------------------------------------------
+        constexpr bool empty() const noexcept
+        { return st_.size_ == 0; }
+
+        constexpr bool full() const noexcept
+        { return st_.size_ == N; }
+
+        constexpr size_type size() const noexcept
+        { return st_.size_; }
+
+        static constexpr size_type max_size() noexcept
+        { return N; }
+
+        static constexpr size_type capacity() noexcept
+        { return N; }
+
+        // nothing to allocate, only check the request
+        void reserve(size_type n)
+        {
+            THROW_LENGTH_ERROR_IF(n > N,
+                "n can not larger than capacity() in static_vector<T, N>::reserve(n)");
+        }
+
+        // Access element operations
+        STATIC_VECTOR_CONSTEXPR reference operator[](size_type n)
+        {
+            TINYSTL_DEBUG(n < size());
+            return *(begin() + n);
+        }
+
+        constexpr const_reference operator[](size_type n) const
+        {
+            return *(begin() + n);
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        STATIC_VECTOR_CONSTEXPR reference front()
+        {
+            TINYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        constexpr const_reference front() const
+        {
+            return *begin();
+        }
+
+        STATIC_VECTOR_CONSTEXPR reference back()
+        {
+            TINYSTL_DEBUG(!empty());
+            return *(end() - 1);
+        }
+
+        constexpr const_reference back() const
+        {
+            return *(end() - 1);
+        }
+
+        STATIC_VECTOR_CONSTEXPR pointer data() noexcept
+        { return st_.ptr(); }
+
+        constexpr const_pointer data() const noexcept
+        { return st_.ptr(); }
+
+        // Modify container-----------------------------------------------------------------
+        // assign
+        void assign(size_type n, const value_type& value);
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last)
+        {
+            clear();
+            range_init(first, last);
+        }
+
+        void assign(std::initializer_list<value_type> il)
+        { assign(il.begin(), il.end()); }
+
+        // emplace / emplace_back
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&& ...args);
+
+        template <class... Args>
+        STATIC_VECTOR_CONSTEXPR void emplace_back(Args&& ...args)
+        {
+            THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N>'s size too big");
+            unchecked_emplace_back(tinystl::forward<Args>(args)...);
+        }
+
+        // push_back / pop_back
+        STATIC_VECTOR_CONSTEXPR void push_back(const value_type& value)
+        { emplace_back(value); }
+
+        STATIC_VECTOR_CONSTEXPR void push_back(value_type&& value)
+        { emplace_back(tinystl::move(value)); }
+
+        STATIC_VECTOR_CONSTEXPR void pop_back()
+        {
+            TINYSTL_DEBUG(!empty());
+            --st_.size_;
+            st_.destroy_range(end(), end() + 1);
+        }
+
+        // insert
+        iterator insert(const_iterator pos, const value_type& value)
+        { return emplace(pos, value); }
+
+        iterator insert(const_iterator pos, value_type&& value)
+        { return emplace(pos, tinystl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last);
+
+        // erase / clear
+        iterator erase(const_iterator pos)
+        { return erase(pos, pos + 1); }
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        STATIC_VECTOR_CONSTEXPR void clear() noexcept
+        {
+            st_.destroy_range(begin(), end());
+            st_.size_ = 0;
+        }
+
+        // resize / reverse
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+
+        void resize(size_type new_size, const value_type& value);
+
+        void reverse()
+        { tinystl::reverse(begin(), end()); }
+
+        // swap, O(N): the elements are exchanged one by one
+        void swap(static_vector& rhs);
+
+    private:
+        // helper functions
+        // construct an element after the last one, size() counts it only once it is built,
+        // so a throwing constructor leaves every element it counts alive and st_ destroys them
+        template <class... Args>
+        STATIC_VECTOR_CONSTEXPR void unchecked_emplace_back(Args&& ...args)
+        {
+            st_.construct_at(end(), tinystl::forward<Args>(args)...);
+            ++st_.size_;
+        }
+
+        void fill_init(size_type n, const value_type& value)
+        {
+            THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N>'s size too big");
+            for (; n > 0; --n)
+                unchecked_emplace_back(value);
+        }
+
+        template <class Iter>
+        void range_init(Iter first, Iter last)
+        {
+            const size_type n = tinystl::distance(first, last);
+            THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N>'s size too big");
+            for (; first != last; ++first)
+                unchecked_emplace_back(*first);
+        }
+    };
+
+    //==================implement=========================================================//
+
+    // assign n values
+    template <class T, size_t N>
+    void static_vector<T, N>::assign(size_type n, const value_type& value)
+    {
+        THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N>'s size too big");
+        const value_type value_copy = value;  // value may be an element of *this
+        clear();
+        fill_init(n, value_copy);
+    }
+
+    // Constructs the element in-place at position pos
+    template <class T, size_t N>
+    template <class ...Args>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+    {
+        TINYSTL_DEBUG(pos >= begin() && pos <= end());
+        THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N>'s size too big");
+        iterator xpos = begin() + (pos - begin());
+        if (xpos == end())
+        {
+            st_.construct_at(end(), tinystl::forward<Args>(args)...);
+        }
+        else
+        {
+            value_type value_copy(tinystl::forward<Args>(args)...);
+            st_.construct_at(end(), tinystl::move(*(end() - 1)));
+            tinystl::move_backward(xpos, end() - 1, end());
+            *xpos = tinystl::move(value_copy);
+        }
+        ++st_.size_;
+        return xpos;
+    }
+
+    // insert n values at pos
+    template <class T, size_t N>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        TINYSTL_DEBUG(pos >= begin() && pos <= end());
+        THROW_LENGTH_ERROR_IF(n > N - size(), "static_vector<T, N>'s size too big");
+        iterator xpos = begin() + (pos - begin());
+        if (n == 0)
+            return xpos;
+
+        const value_type value_copy = value;  // avoid being covered
+        const size_type after_elems = end() - xpos;
+        auto old_end = end();
+        // the new slots after old_end are built by unchecked_emplace_back one by one
+        if (after_elems > n)
+        {
+            for (auto p = old_end - n; p != old_end; ++p)
+                unchecked_emplace_back(tinystl::move(*p));
+            tinystl::move_backward(xpos, old_end - n, old_end);
+            tinystl::fill_n(xpos, n, value_copy);
+        }
+        else
+        {
+            for (auto i = after_elems; i < n; ++i)
+                unchecked_emplace_back(value_copy);
+            for (auto p = xpos; p != old_end; ++p)
+                unchecked_emplace_back(tinystl::move(*p));
+            tinystl::fill_n(xpos, after_elems, value_copy);
+        }
+        return xpos;
+    }
+
+    // insert [first, last) at pos
+    template <class T, size_t N>
+    template <class Iter, typename std::enable_if<
+        tinystl::is_input_iterator<Iter>::value, int>::type>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::insert(const_iterator pos, Iter first, Iter last)
+    {
+        TINYSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type n = tinystl::distance(first, last);
+        THROW_LENGTH_ERROR_IF(n > N - size(), "static_vector<T, N>'s size too big");
+        iterator xpos = begin() + (pos - begin());
+        if (n == 0)
+            return xpos;
+
+        const size_type after_elems = end() - xpos;
+        auto old_end = end();
+        // the new slots after old_end are built by unchecked_emplace_back one by one
+        if (after_elems > n)
+        {
+            for (auto p = old_end - n; p != old_end; ++p)
+                unchecked_emplace_back(tinystl::move(*p));
+            tinystl::move_backward(xpos, old_end - n, old_end);
+            tinystl::copy(first, last, xpos);
+        }
+        else
+        {
+            auto mid = first;
+            tinystl::advance(mid, after_elems);
+            for (auto it = mid; it != last; ++it)
+                unchecked_emplace_back(*it);
+            for (auto p = xpos; p != old_end; ++p)
+                unchecked_emplace_back(tinystl::move(*p));
+            tinystl::copy(first, mid, xpos);
+        }
+        return xpos;
+    }
+
+    // delete elements in [first, last)
+    template <class T, size_t N>
+    typename static_vector<T, N>::iterator
+    static_vector<T, N>::erase(const_iterator first, const_iterator last)
+    {
+        TINYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        iterator xfirst = begin() + (first - begin());
+        iterator xlast = begin() + (last - begin());
+        auto new_end = tinystl::move(xlast, end(), xfirst);
+        st_.destroy_range(new_end, end());
+        st_.size_ -= (last - first);
+        return xfirst;
+    }
+
+    // resize
+    template <class T, size_t N>
+    void static_vector<T, N>::resize(size_type new_size, const value_type& value)
+    {
+        if (new_size < size())
+            erase(begin() + new_size, end());
+        else
+            insert(end(), new_size - size(), value);
+    }
+
+    // exchange the elements with another static_vector
+    template <class T, size_t N>
+    void static_vector<T, N>::swap(static_vector& rhs)
+    {
+        if (this == &rhs)
+            return;
+        static_vector& longer  = size() < rhs.size() ? rhs : *this;
+        static_vector& shorter = size() < rhs.size() ? *this : rhs;
+        const size_type common = shorter.size();
+        tinystl::swap_range(shorter.begin(), shorter.end(), longer.begin());
+        for (auto p = longer.begin() + common; p != longer.end(); ++p)
+            shorter.unchecked_emplace_back(tinystl::move(*p));
+        longer.erase(longer.begin() + common, longer.end());
+    }
+
+    // overload swap
+    template <class T, size_t N>
+    void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    // overload comparison operator
+    template <class T, size_t N>
+    bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N>
+    bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return tinystl::lexicographical_compare(lhs.begin(), lhs.end(),
+            rhs.begin(), rhs.end());
+    }
+
+    template <class T, size_t N>
+    bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, size_t N>
+    bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+} // namespace tinystl
+#endif
@@ -229,6 +229,19 @@ namespace tinystl
         pair<const_iterator, const_iterator> equal_range(const key_type& key) const
         { return ht_.equal_range_unique(key); }
 
+        // *result++ = find(key) / count(key) for every key in [first, last), see hashtable
+        template <class ForwardIter, class OutputIter>
+        OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result)
+        { return ht_.find_batch(first, last, result); }
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return ht_.find_batch(first, last, result); }
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return ht_.count_batch(first, last, result); }
+
         // bucket interface
         local_iterator begin(size_type n) noexcept
         { return ht_.begin(n); }
@@ -270,12 +283,31 @@ namespace tinystl
         void  max_load_factor(float ml) 
         { ht_.max_load_factor(ml); }
 
+        float min_load_factor() const noexcept
+        { return ht_.min_load_factor(); }
+
+        void min_load_factor(float ml)
+        { ht_.min_load_factor(ml); }
+
         void rehash(size_type count) 
         { ht_.rehash(count); }
 
         void reserve(size_type count)                
         { ht_.reserve(count); }
 
+        void shrink_to_fit()
+        { ht_.shrink_to_fit(); }
+
+        // statistics, see hashtable::stats / sample_lookups
+        ht_stats stats() const noexcept
+        { return ht_.stats(); }
+
+        void sample_lookups(size_type period) noexcept
+        { ht_.sample_lookups(period); }
+
+        void reset_stats() noexcept
+        { ht_.reset_stats(); }
+
         hasher hash_fcn() const          
         { return ht_.hash_fcn(); }
 
@@ -499,6 +531,19 @@ namespace tinystl
         pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
         { return ht_.equal_range_multi(key); }
 
+        // *result++ = find(key) / count(key) for every key in [first, last), see hashtable
+        template <class ForwardIter, class OutputIter>
+        OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result)
+        { return ht_.find_batch(first, last, result); }
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return ht_.find_batch(first, last, result); }
+
+        template <class ForwardIter, class OutputIter>
+        OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+        { return ht_.count_batch(first, last, result); }
+
         // bucket interface
 
         local_iterator begin(size_type n) noexcept
@@ -541,12 +586,31 @@ namespace tinystl
         void max_load_factor(float ml)               
         { ht_.max_load_factor(ml); }
 
+        float min_load_factor() const noexcept
+        { return ht_.min_load_factor(); }
+
+        void min_load_factor(float ml)
+        { ht_.min_load_factor(ml); }
+
         void rehash(size_type count)                 
         { ht_.rehash(count); }
 
         void reserve(size_type count)                
         { ht_.reserve(count); }
 
+        void shrink_to_fit()
+        { ht_.shrink_to_fit(); }
+
+        // statistics, see hashtable::stats / sample_lookups
+        ht_stats stats() const noexcept
+        { return ht_.stats(); }
+
+        void sample_lookups(size_type period) noexcept
+        { ht_.sample_lookups(period); }
+
+        void reset_stats() noexcept
+        { ht_.reset_stats(); }
+
         hasher hash_fcn() const          
         { return ht_.hash_fcn(); }
 
@@ -0,0 +1,811 @@
+#ifndef _UNROLLED_LIST_H_
+#define _UNROLLED_LIST_H_
+
+// unrolled_list : doubly linked list of small arrays
+
+// notes:
+// Every node holds up to N elements side by side, so a scan touches one cache line
+// (or two) for N elements instead of one per element as in list,
+// and an insert or erase only shifts the elements of one node instead of half a vector.
+//
+// N is unrolled_list_node_size<T>::value by default: as many elements as fit in
+// UNROLLED_LIST_NODE_BYTES (128) bytes, but at least 8.
+//
+// A full node is split in two halves when an element is inserted into it,
+// a node that falls under N / 4 elements after an erase is merged with its next node
+// when they fit in one node, so the nodes stay at least about a quarter full.
+//
+// Iterator invalidation:
+//   * insert / emplace invalidate the iterators into the node the element goes into
+//     (and into its new neighbour if the node is split), and end()
+//   * erase invalidates the iterators into the node of the erased element
+//     (and into its next node if the two are merged), and end()
+//   * the iterators into all the other nodes stay valid
+//
+// tinystl::unrolled_list<T, N> Satisfy the basic exception guarantee,
+// and strengthen the exception safety guarantee for the following functions:
+//   * emplace_front
+//   * emplace_back
+//   * push_front
+//   * push_back
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+#include "allocator.h"
+
+namespace tinystl
+{
+
+    // the payload size of a node in bytes
+    #ifndef UNROLLED_LIST_NODE_BYTES
+    #define UNROLLED_LIST_NODE_BYTES 128
+    #endif
+
+    template <class T>
+    struct unrolled_list_node_size
+    {
+        static constexpr size_t value = UNROLLED_LIST_NODE_BYTES / sizeof(T) < 8
+            ? 8 : UNROLLED_LIST_NODE_BYTES / sizeof(T);
+    };
+
+    // unrolled_list's node
+    template <class T, size_t N>
+    struct unrolled_list_node
+    {
+        unrolled_list_node* prev;
+        unrolled_list_node* next;
+        size_t              count;  // number of elements in the node
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf;
+
+        T* data() noexcept
+        { return reinterpret_cast<T*>(&buf); }
+
+        const T* data() const noexcept
+        { return reinterpret_cast<const T*>(&buf); }
+    };
+
+    // unrolled_list's iterator
+    // The position is the node and the index in it, end() is (tail, tail->count)
+    template <class T, size_t N, class Ref, class Ptr>
+    struct unrolled_list_iterator : public tinystl::iterator<tinystl::bidirectional_iterator_tag, T>
+    {
+        typedef unrolled_list_iterator<T, N, T&, T*>             iterator;
+        typedef unrolled_list_iterator<T, N, const T&, const T*> const_iterator;
+        typedef unrolled_list_iterator                           self;
+
+        typedef T                           value_type;
+        typedef Ptr                         pointer;
+        typedef Ref                         reference;
+        typedef size_t                      size_type;
+        typedef ptrdiff_t                   difference_type;
+        typedef unrolled_list_node<T, N>*   node_ptr;
+
+        node_ptr  node;
+        size_type index;
+
+        unrolled_list_iterator() noexcept :node(nullptr), index(0)
+        {}
+
+        unrolled_list_iterator(node_ptr n, size_type i) noexcept :node(n), index(i)
+        {}
+
+        unrolled_list_iterator(const iterator& rhs) noexcept :node(rhs.node), index(rhs.index)
+        {}
+
+        self& operator=(const iterator& rhs) noexcept
+        {
+            node = rhs.node;
+            index = rhs.index;
+            return *this;
+        }
+
+        reference operator*() const
+        { return node->data()[index]; }
+
+        pointer operator->() const
+        { return &(operator*()); }
+
+        self& operator++()
+        {
+            TINYSTL_DEBUG(node != nullptr && index < node->count);
+            if (++index == node->count && node->next != nullptr)
+            {
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--()
+        {
+            TINYSTL_DEBUG(node != nullptr);
+            if (index == 0)
+            {
+                node = node->prev;
+                TINYSTL_DEBUG(node != nullptr);
+                index = node->count;
+            }
+            --index;
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return node == rhs.node && index == rhs.index; }
+
+        bool operator!=(const self& rhs) const
+        { return !(*this == rhs); }
+    };
+
+    //=================== unrolled_list template =============================================
+    template <class T, size_t N = unrolled_list_node_size<T>::value>
+    class unrolled_list
+    {
+        static_assert(N >= 2, "unrolled_list needs at least 2 elements per node");
+
+    public:
+        typedef tinystl::allocator<T>                           allocator_type;
+        typedef tinystl::allocator<T>                           data_allocator;
+        typedef tinystl::allocator<unrolled_list_node<T, N>>    node_allocator;
+
+        typedef typename allocator_type::value_type         value_type;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+        typedef unrolled_list_iterator<T, N, T&, T*>                iterator;
+        typedef unrolled_list_iterator<T, N, const T&, const T*>    const_iterator;
+        typedef tinystl::reverse_iterator<iterator>                 reverse_iterator;
+        typedef tinystl::reverse_iterator<const_iterator>           const_reverse_iterator;
+
+        typedef unrolled_list_node<T, N>*   node_ptr;
+
+        static constexpr size_type node_capacity = N;
+
+        allocator_type get_allocator()
+        { return allocator_type(); }
+
+    private:
+        node_ptr  head_;  // first node, nullptr when empty
+        node_ptr  tail_;  // last node
+        size_type size_;  // number of elements
+
+    public:
+        //---------------------------------------------------------------------------------
+        // constructor
+        unrolled_list() noexcept
+            :head_(nullptr), tail_(nullptr), size_(0)
+        {}
+
+        explicit unrolled_list(size_type n)
+            :head_(nullptr), tail_(nullptr), size_(0)
+        { fill_init(n, value_type()); }
+
+        unrolled_list(size_type n, const value_type& value)
+            :head_(nullptr), tail_(nullptr), size_(0)
+        { fill_init(n, value); }
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        unrolled_list(Iter first, Iter last)
+            :head_(nullptr), tail_(nullptr), size_(0)
+        { copy_init(first, last); }
+
+        unrolled_list(std::initializer_list<value_type> ilist)
+            :head_(nullptr), tail_(nullptr), size_(0)
+        { copy_init(ilist.begin(), ilist.end()); }
+
+        unrolled_list(const unrolled_list& rhs)
+            :head_(nullptr), tail_(nullptr), size_(0)
+        { copy_init(rhs.begin(), rhs.end()); }
+
+        unrolled_list(unrolled_list&& rhs) noexcept
+            :head_(rhs.head_), tail_(rhs.tail_), size_(rhs.size_)
+        {
+            rhs.head_ = nullptr;
+            rhs.tail_ = nullptr;
+            rhs.size_ = 0;
+        }
+
+        unrolled_list& operator=(const unrolled_list& rhs)
+        {
+            if (this != &rhs)
+            {
+                unrolled_list tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        unrolled_list& operator=(unrolled_list&& rhs) noexcept
+        {
+            unrolled_list tmp(tinystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        unrolled_list& operator=(std::initializer_list<value_type> ilist)
+        {
+            unrolled_list tmp(ilist);
+            swap(tmp);
+            return *this;
+        }
+
+        ~unrolled_list()
+        { clear(); }
+
+    public:
+        // iterator operation----------------------------------------------------------------
+        iterator begin() noexcept
+        { return iterator(head_, 0); }
+
+        const_iterator begin() const noexcept
+        { return const_iterator(head_, 0); }
+
+        iterator end() noexcept
+        { return iterator(tail_, tail_ ? tail_->count : 0); }
+
+        const_iterator end() const noexcept
+        { return const_iterator(tail_, tail_ ? tail_->count : 0); }
+
+        reverse_iterator rbegin() noexcept
+        { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept
+        { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept
+        { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept
+        { return begin(); }
+
+        const_iterator cend() const noexcept
+        { return end(); }
+
+        // container operation---------------------------------------------------------------
+        bool empty() const noexcept
+        { return size_ == 0; }
+
+        size_type size() const noexcept
+        { return size_; }
+
+        size_type max_size() const noexcept
+        { return static_cast<size_type>(-1) / sizeof(T); }
+
+        // visit element---------------------------------------------------------------------
+        reference front()
+        {
+            TINYSTL_DEBUG(!empty());
+            return head_->data()[0];
+        }
+
+        const_reference front() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return head_->data()[0];
+        }
+
+        reference back()
+        {
+            TINYSTL_DEBUG(!empty());
+            return tail_->data()[tail_->count - 1];
+        }
+
+        const_reference back() const
+        {
+            TINYSTL_DEBUG(!empty());
+            return tail_->data()[tail_->count - 1];
+        }
+
+        // adjust container operation--------------------------------------------------------
+        // emplace_front / emplace_back / emplace
+        template <class ...Args>
+        void emplace_front(Args&& ...args);
+
+        template <class ...Args>
+        void emplace_back(Args&& ...args);
+
+        template <class ...Args>
+        iterator emplace(const_iterator pos, Args&& ...args);
+
+        // insert
+        iterator insert(const_iterator pos, const value_type& value)
+        { return emplace(pos, value); }
+
+        iterator insert(const_iterator pos, value_type&& value)
+        { return emplace(pos, tinystl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+        template <class Iter, typename std::enable_if<
+            tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last);
+
+        // push_front / push_back
+        void push_front(const value_type& value)
+        { emplace_front(value); }
+
+        void push_front(value_type&& value)
+        { emplace_front(tinystl::move(value)); }
+
+        void push_back(const value_type& value)
+        { emplace_back(value); }
+
+        void push_back(value_type&& value)
+        { emplace_back(tinystl::move(value)); }
+
+        // pop_front / pop_back
+        void pop_front()
+        {
+            TINYSTL_DEBUG(!empty());
+            erase(begin());
+        }
+
+        void pop_back()
+        {
+            TINYSTL_DEBUG(!empty());
+            erase(--end());
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() noexcept;
+
+        // resize
+        void resize(size_type new_size)
+        { resize(new_size, value_type()); }
+
+        void resize(size_type new_size, const value_type& value);
+
+        void swap(unrolled_list& rhs) noexcept
+        {
+            tinystl::swap(head_, rhs.head_);
+            tinystl::swap(tail_, rhs.tail_);
+            tinystl::swap(size_, rhs.size_);
+        }
+
+    private:
+        // helper functions----------------------------------------------------------------
+        // node
+        node_ptr create_node();
+        void destroy_node(node_ptr p) noexcept;
+        node_ptr link_new_node_after(node_ptr p);
+        void unlink_node(node_ptr p) noexcept;
+
+        // initialize
+        void fill_init(size_type n, const value_type& value);
+
+        template <class Iter>
+        void copy_init(Iter first, Iter last);
+
+        // split / merge
+        void split_node(node_ptr p);
+        void merge_next_if_sparse(node_ptr p);
+
+        // make room at (p, i) and return the position the new element goes to
+        iterator make_room(node_ptr p, size_type i);
+    };
+
+    //============= implement ===============================================================
+    // node------------------------------------------------------------------------------------
+    template <class T, size_t N>
+    typename unrolled_list<T, N>::node_ptr
+    unrolled_list<T, N>::create_node()
+    {
+        node_ptr p = node_allocator::allocate(1);
+        p->prev = nullptr;
+        p->next = nullptr;
+        p->count = 0;
+        return p;
+    }
+
+    template <class T, size_t N>
+    void unrolled_list<T, N>::destroy_node(node_ptr p) noexcept
+    {
+        tinystl::destroy(p->data(), p->data() + p->count);
+        node_allocator::deallocate(p);
+    }
+
+    // allocate an empty node and link it after p (at the front if p is nullptr)
+    template <class T, size_t N>
+    typename unrolled_list<T, N>::node_ptr
+    unrolled_list<T, N>::link_new_node_after(node_ptr p)
+    {
+        node_ptr n = create_node();
+        n->prev = p;
+        n->next = p ? p->next : head_;
+        if (n->next)
+            n->next->prev = n;
+        else
+            tail_ = n;
+        if (p)
+            p->next = n;
+        else
+            head_ = n;
+        return n;
+    }
+
+    template <class T, size_t N>
+    void unrolled_list<T, N>::unlink_node(node_ptr p) noexcept
+    {
+        if (p->prev)
+            p->prev->next = p->next;
+        else
+            head_ = p->next;
+        if (p->next)
+            p->next->prev = p->prev;
+        else
+            tail_ = p->prev;
+    }
+
+    // initialize-----------------------------------------------------------------------------
+    template <class T, size_t N>
+    void unrolled_list<T, N>::fill_init(size_type n, const value_type& value)
+    {
+        try
+        {
+            for (; n > 0; --n)
+                emplace_back(value);
+        }
+        catch (...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template <class T, size_t N>
+    template <class Iter>
+    void unrolled_list<T, N>::copy_init(Iter first, Iter last)
+    {
+        try
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+        catch (...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    // emplace--------------------------------------------------------------------------------
+    // Construct at the front, a full head gets a new node before it
+    template <class T, size_t N>
+    template <class ...Args>
+    void unrolled_list<T, N>::emplace_front(Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+        if (head_ != nullptr && head_->count < N)
+        {
+            // construct a temporary first, the shift below must not fail half way
+            value_type tmp(tinystl::forward<Args>(args)...);
+            auto d = head_->data();
+            if (head_->count != 0)
+            {
+                data_allocator::construct(d + head_->count, tinystl::move(d[head_->count - 1]));
+                ++head_->count;
+                tinystl::move_backward(d, d + head_->count - 2, d + head_->count - 1);
+                d[0] = tinystl::move(tmp);
+            }
+            else
+            {
+                data_allocator::construct(d, tinystl::move(tmp));
+                ++head_->count;
+            }
+        }
+        else
+        {
+            auto n = link_new_node_after(nullptr);
+            try
+            {
+                data_allocator::construct(n->data(), tinystl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                unlink_node(n);
+                destroy_node(n);
+                throw;
+            }
+            n->count = 1;
+        }
+        ++size_;
+    }
+
+    // Construct at the back, a full tail gets a new node after it
+    template <class T, size_t N>
+    template <class ...Args>
+    void unrolled_list<T, N>::emplace_back(Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+        if (tail_ != nullptr && tail_->count < N)
+        {
+            data_allocator::construct(tail_->data() + tail_->count, tinystl::forward<Args>(args)...);
+            ++tail_->count;
+        }
+        else
+        {
+            auto n = link_new_node_after(tail_);
+            try
+            {
+                data_allocator::construct(n->data(), tinystl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                unlink_node(n);
+                destroy_node(n);
+                throw;
+            }
+            n->count = 1;
+        }
+        ++size_;
+    }
+
+    // Construct an element before pos
+    template <class T, size_t N>
+    template <class ...Args>
+    typename unrolled_list<T, N>::iterator
+    unrolled_list<T, N>::emplace(const_iterator pos, Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+        if (pos.node == tail_ && pos.index == (tail_ ? tail_->count : 0))
+        {
+            emplace_back(tinystl::forward<Args>(args)...);
+            return iterator(tail_, tail_->count - 1);
+        }
+        // args may refer to an element of this list, build the value before moving anything
+        value_type tmp(tinystl::forward<Args>(args)...);
+        auto it = make_room(pos.node, pos.index);
+        auto d = it.node->data();
+        if (it.index == it.node->count)
+        {
+            data_allocator::construct(d + it.index, tinystl::move(tmp));
+        }
+        else
+        {
+            const auto c = it.node->count;
+            data_allocator::construct(d + c, tinystl::move(d[c - 1]));
+            tinystl::move_backward(d + it.index, d + c - 1, d + c);
+            d[it.index] = tinystl::move(tmp);
+        }
+        ++it.node->count;
+        ++size_;
+        return it;
+    }
+
+    // make_room
+    // Make sure the node of the position (p, i) has a free slot, splitting it if it is full,
+    // and return where the element at (p, i) is now
+    template <class T, size_t N>
+    typename unrolled_list<T, N>::iterator
+    unrolled_list<T, N>::make_room(node_ptr p, size_type i)
+    {
+        TINYSTL_DEBUG(p != nullptr);
+        if (p->count < N)
+            return iterator(p, i);
+        // inserting after the last element of a full node: use the front of the next node
+        if (i == p->count && p->next != nullptr && p->next->count < N)
+            return iterator(p->next, 0);
+        split_node(p);
+        if (i > p->count)
+            return iterator(p->next, i - p->count);
+        return iterator(p, i);
+    }
+
+    // split_node
+    // Move the upper half of p into a new node after it
+    template <class T, size_t N>
+    void unrolled_list<T, N>::split_node(node_ptr p)
+    {
+        auto n = link_new_node_after(p);
+        const size_type keep = p->count / 2;
+        auto d = p->data();
+        try
+        {
+            tinystl::uninitialized_move_n(d + keep, p->count - keep, n->data());
+        }
+        catch (...)
+        {
+            unlink_node(n);
+            node_allocator::deallocate(n);
+            throw;
+        }
+        n->count = p->count - keep;
+        tinystl::destroy(d + keep, d + p->count);
+        p->count = keep;
+    }
+
+    // merge_next_if_sparse
+    // A node under N / 4 elements takes in its next node if both fit in one node
+    template <class T, size_t N>
+    void unrolled_list<T, N>::merge_next_if_sparse(node_ptr p)
+    {
+        auto n = p->next;
+        if (p->count >= N / 4 || n == nullptr || p->count + n->count > N)
+            return;
+        // if a move throws the counts are not touched yet, both nodes stay as they were
+        tinystl::uninitialized_move_n(n->data(), n->count, p->data() + p->count);
+        p->count += n->count;
+        unlink_node(n);
+        destroy_node(n);  // destroys the moved-from elements
+    }
+
+    // insert---------------------------------------------------------------------------------
+    template <class T, size_t N>
+    typename unrolled_list<T, N>::iterator
+    unrolled_list<T, N>::insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - n, "unrolled_list<T>'s size too big");
+        if (n == 0)
+            return iterator(pos.node, pos.index);
+        // insert one by one from the back, each insert returns the position of the next one
+        value_type tmp(value);
+        auto it = emplace(pos, tmp);
+        for (--n; n > 0; --n)
+            it = emplace(it, tmp);
+        return it;
+    }
+
+    template <class T, size_t N>
+    template <class Iter, typename std::enable_if<
+        tinystl::is_input_iterator<Iter>::value, int>::type>
+    typename unrolled_list<T, N>::iterator
+    unrolled_list<T, N>::insert(const_iterator pos, Iter first, Iter last)
+    {
+        if (first == last)
+            return iterator(pos.node, pos.index);
+        // keep the position of the first inserted element by its distance from begin()
+        size_type offset = 0;
+        for (auto it = cbegin(); it != pos; ++it)
+            ++offset;
+        iterator cur(pos.node, pos.index);
+        for (; first != last; ++first)
+        {
+            cur = emplace(cur, *first);
+            ++cur;
+        }
+        auto result = begin();
+        for (; offset > 0; --offset)
+            ++result;
+        return result;
+    }
+
+    // erase----------------------------------------------------------------------------------
+    // Erase the element at pos, the elements after it in its node move one slot down
+    template <class T, size_t N>
+    typename unrolled_list<T, N>::iterator
+    unrolled_list<T, N>::erase(const_iterator pos)
+    {
+        TINYSTL_DEBUG(pos != cend());
+        auto p = pos.node;
+        auto i = pos.index;
+        auto d = p->data();
+        tinystl::move(d + i + 1, d + p->count, d + i);
+        data_allocator::destroy(d + p->count - 1);
+        --p->count;
+        --size_;
+        if (p->count == 0)
+        {
+            auto next = p->next;
+            unlink_node(p);
+            node_allocator::deallocate(p);
+            return next ? iterator(next, 0) : end();
+        }
+        merge_next_if_sparse(p);
+        if (i == p->count && p->next != nullptr)
+            return iterator(p->next, 0);
+        return iterator(p, i);
+    }
+
+    // Erase [first, last)
+    template <class T, size_t N>
+    typename unrolled_list<T, N>::iterator
+    unrolled_list<T, N>::erase(const_iterator first, const_iterator last)
+    {
+        if (first == last)
+            return iterator(last.node, last.index);
+        size_type n = 0;
+        for (auto it = first; it != last; ++it)
+            ++n;
+        iterator cur(first.node, first.index);
+        for (; n > 0; --n)
+            cur = erase(cur);
+        return cur;
+    }
+
+    // Destroy every element and node
+    template <class T, size_t N>
+    void unrolled_list<T, N>::clear() noexcept
+    {
+        auto p = head_;
+        while (p != nullptr)
+        {
+            auto next = p->next;
+            destroy_node(p);
+            p = next;
+        }
+        head_ = tail_ = nullptr;
+        size_ = 0;
+    }
+
+    // resize
+    template <class T, size_t N>
+    void unrolled_list<T, N>::resize(size_type new_size, const value_type& value)
+    {
+        while (size_ > new_size)
+            pop_back();
+        while (size_ < new_size)
+            emplace_back(value);
+    }
+
+    // overloaded comparison operator
+    template <class T, size_t N>
+    bool operator==(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs)
+    {
+        return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N>
+    bool operator<(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs)
+    {
+        return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, size_t N>
+    bool operator!=(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, size_t N>
+    bool operator<=(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, size_t N>
+    bool operator>=(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    // overload tinystl's swap
+    template <class T, size_t N>
+    void swap(unrolled_list<T, N>& lhs, unrolled_list<T, N>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+}
+#endif
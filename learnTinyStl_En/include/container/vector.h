@@ -40,6 +40,27 @@ namespace tinystl
     #undef min
     #endif // min
 
+    // vector_next_cap
+    // The growth rule of vector (also used by small_vector):
+    // grow by half of the old capacity, and at least by add_size
+    template <class SizeType>
+    SizeType vector_next_cap(SizeType old_size, SizeType add_size, SizeType max_size)
+    {
+        THROW_LENGTH_ERROR_IF(old_size > max_size - add_size,
+                                "vector<T>'s size too big");
+        if (old_size > max_size - old_size / 2)
+        {
+            return old_size + add_size > max_size - 16
+            ? old_size + add_size 
+            : old_size + add_size + 16;
+        }
+
+        const SizeType new_size = old_size == 0
+            ? tinystl::max(add_size, static_cast<SizeType>(16))
+            : tinystl::max(old_size + old_size / 2, old_size + add_size);
+        return new_size;
+    }
+
     // vector template
     template <class T>
     class vector
@@ -86,6 +107,10 @@ namespace tinystl
         vector(size_type n, const value_type& value)
         { fill_init(n, value); }
 
+        // n default-initialized elements, trivial elements are left uninitialized
+        vector(size_type n, for_overwrite_t)
+        { default_init(n); }
+
         template <class Iter, typename std::enable_if<
             tinystl::is_input_iterator<Iter>::value, int>::type = 0>
         vector(Iter first, Iter last)
@@ -305,6 +330,18 @@ namespace tinystl
 
         void resize(size_type new_size, const value_type& value);
 
+        // resize_default_init
+        // Same as resize(new_size), but the new elements are default-initialized,
+        // so growing a vector<uint8_t> before reading into it does not memset the buffer
+        void resize_default_init(size_type new_size);
+
+        // resize_and_overwrite
+        // Make the size n (new elements default-initialized), then let op write the elements:
+        //   size_type op(pointer buf, size_type n)
+        // op returns the number of elements it kept, r <= n, the size becomes r
+        template <class Operation>
+        void resize_and_overwrite(size_type n, Operation op);
+
         void reverse() 
         { tinystl::reverse(begin(), end()); }
 
@@ -320,6 +357,8 @@ namespace tinystl
 
         void fill_init(size_type n, const value_type& value);
 
+        void default_init(size_type n);
+
         template <class Iter>
         void range_init(Iter first, Iter last);
 
@@ -406,6 +445,15 @@ namespace tinystl
         tinystl::uninitialized_fill_n(begin_, n, value);
     }
 
+    // default_init
+    template <class T>
+    void vector<T>::default_init(size_type n)
+    {
+        const size_type init_size = tinystl::max(static_cast<size_type>(16), n);
+        init_space(n, init_size);
+        tinystl::uninitialized_default_construct_n(begin_, n);
+    }
+
     // range_init
     template <class T>
     template <class Iter>
@@ -575,20 +623,7 @@ namespace tinystl
     typename vector<T>::size_type 
     vector<T>::get_new_cap(size_type add_size)
     {
-        const auto old_size = capacity();
-        THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
-                                "vector<T>'s size too big");
-        if (old_size > max_size() - old_size / 2)
-        {
-            return old_size + add_size > max_size() - 16
-            ? old_size + add_size 
-            : old_size + add_size + 16;
-        }
-
-        const size_type new_size = old_size == 0
-            ? tinystl::max(add_size, static_cast<size_type>(16))
-            : tinystl::max(old_size + old_size / 2, old_size + add_size);
-        return new_size;
+        return tinystl::vector_next_cap(capacity(), add_size, max_size());
     }
 
     // Reallocates space and constructs element in-place at pos
@@ -720,6 +755,53 @@ namespace tinystl
             insert(end(), new_size - size(), value);
     }
 
+    // resize_default_init
+    template <class T>
+    void vector<T>::resize_default_init(size_type new_size)
+    {
+        if (new_size < size())
+        {
+            erase(begin() + new_size, end());
+        }
+        else if (new_size > capacity())
+        {
+            // Insufficient spare space
+            const auto new_cap = get_new_cap(new_size - size());
+            auto new_begin = data_allocator::allocate(new_cap);
+            auto new_end = new_begin;
+            try
+            {
+                new_end = tinystl::uninitialized_move(begin_, end_, new_begin);
+                new_end = tinystl::uninitialized_default_construct_n(new_end, new_size - size());
+            }
+            catch (...)
+            {
+                destroy_and_recover(new_begin, new_end, new_cap);
+                throw;
+            }
+            destroy_and_recover(begin_, end_, cap_ - begin_);
+            begin_ = new_begin;
+            end_ = new_end;
+            cap_ = new_begin + new_cap;
+        }
+        else
+        {
+            end_ = tinystl::uninitialized_default_construct_n(end_, new_size - size());
+        }
+    }
+
+    // resize_and_overwrite
+    template <class T>
+    template <class Operation>
+    void vector<T>::resize_and_overwrite(size_type n, Operation op)
+    {
+        if (n > size())
+            resize_default_init(n);
+        const size_type r = static_cast<size_type>(op(begin_, n));
+        TINYSTL_DEBUG(r <= n);
+        erase(begin_ + r, end_);
+    }
+
 
     // insert element at pos
     template <class T>